@@ -0,0 +1,148 @@
+// Measures the wall-clock time per call that critter adds to each of a set of MPI routines, within a single process: each process of the
+//   thread-based MPI stand-in in test/mock is a thread, so calls cost only critter's own work (interception, propagation of path data,
+//   and its merge via update_critical_path, complete_timers, and the symbol exchange) along with that of the stand-in itself.
+//   Runs each routine with each process count under each configuration of critter below, including CRITTER_MODE=0 as a baseline.
+//
+//   usage: bench_mock [output.csv] [max_np] [iterations]
+//
+//   Each row of <output.csv> (appended to, with a header if empty) holds the same columns as those of bench/routines.cxx: the configuration
+//   label, the routine, the number of processes, the message size in bytes, the number of timed calls, and the max and mean wall-clock
+//   time per call over the processes, in microseconds. Point-to-point routines are timed between pairs of neighboring ranks.
+
+#include "../include/critter.h"
+#include "../test/mock/mock.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const int warmup_iterations = 5;
+
+/* \brief environment of a configuration of critter */
+struct config{
+  char const* name;
+  std::vector<std::pair<char const*,char const*>> variables;
+};
+
+struct bench_state{
+  std::string config;
+  std::ofstream* output;
+  int rank;
+  int size;
+  int partner;
+  int count;
+  int iterations;
+  bool nonblocking_collectives;
+  std::vector<double> send_buffer;
+  std::vector<double> recv_buffer;
+};
+
+static void record(bench_state& s, char const* routine, double elapsed){
+  double per_call = 1.e6*elapsed/s.iterations;
+  double max_time,sum_time;
+  PMPI_Reduce(&per_call,&max_time,1,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
+  PMPI_Reduce(&per_call,&sum_time,1,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
+  if (s.rank == 0){
+    *s.output << s.config << "," << routine << "," << s.size << "," << s.count*sizeof(double) << "," << s.iterations
+              << "," << max_time << "," << sum_time/s.size << "\n";
+  }
+}
+
+// Times 'iterations' calls of the statements that follow the routine name in wall-clock time (MPI_Wtime is the virtual clock of the
+//   stand-in), after as many untimed calls as 'warmup_iterations'. Each routine is timed within a user-defined kernel of its own name.
+#define BENCH(ROUTINE, ...)\
+  do {\
+    for (int it=0; it<warmup_iterations; it++){ __VA_ARGS__; }\
+    PMPI_Barrier(MPI_COMM_WORLD);\
+    auto start_time = std::chrono::steady_clock::now();\
+    CRITTER_START(ROUTINE);\
+    for (int it=0; it<s.iterations; it++){ __VA_ARGS__; }\
+    CRITTER_STOP(ROUTINE);\
+    record(s,#ROUTINE,std::chrono::duration<double>(std::chrono::steady_clock::now()-start_time).count());\
+  } while (0)
+
+static void bench_routines(bench_state& s){
+  double* sbuf = &s.send_buffer[0];
+  double* rbuf = &s.recv_buffer[0];
+  int n = s.count;
+  int p = s.partner;
+  bool even = (s.rank%2 == 0);
+  MPI_Request reqs[2];
+  BENCH(MPI_Send,
+    if (even) { MPI_Send(sbuf,n,MPI_DOUBLE,p,0,MPI_COMM_WORLD); }
+    else      { MPI_Recv(rbuf,n,MPI_DOUBLE,p,0,MPI_COMM_WORLD,MPI_STATUS_IGNORE); });
+  BENCH(MPI_Isend,
+    MPI_Irecv(rbuf,n,MPI_DOUBLE,p,0,MPI_COMM_WORLD,&reqs[0]);
+    MPI_Isend(sbuf,n,MPI_DOUBLE,p,0,MPI_COMM_WORLD,&reqs[1]);
+    MPI_Waitall(2,reqs,MPI_STATUSES_IGNORE));
+  BENCH(MPI_Bcast, MPI_Bcast(sbuf,n,MPI_DOUBLE,0,MPI_COMM_WORLD));
+  BENCH(MPI_Allreduce, MPI_Allreduce(sbuf,rbuf,n,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD));
+  if (s.nonblocking_collectives){
+    BENCH(MPI_Iallreduce,
+      MPI_Iallreduce(sbuf,rbuf,n,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD,&reqs[0]);
+      MPI_Wait(&reqs[0],MPI_STATUS_IGNORE));
+  }
+}
+
+int main(int argc, char** argv){
+  char const* output_name = (argc > 1) ? argv[1] : "bench_mock.csv";
+  int max_np = (argc > 2) ? atoi(argv[2]) : 8;
+  int iterations = (argc > 3) ? atoi(argv[3]) : 100;
+  std::vector<config> configs = {
+    {"off",{{"CRITTER_MODE","0"}}},
+    {"default",{}},
+    {"comm_all",{{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    {"encoded",{{"CRITTER_COMM_PATH_SELECT","11111111"},{"CRITTER_PATH_ENCODING","1"}}},
+    {"piggyback",{{"CRITTER_PIGGYBACK_P2P","1"},{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    {"causal",{{"CRITTER_CAUSAL_P2P","1"}}},
+    {"deferred",{{"CRITTER_MECHANISM","1"},{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    // User-defined kernels are not tracked through nonblocking collectives (see README), so MPI_Iallreduce is not timed
+    {"symbol",{{"CRITTER_SYMBOL_PATH_SELECT","11111111"}}}
+  };
+  std::vector<int> counts = {1,1024};
+
+  std::ifstream existing(output_name);
+  bool write_header = !existing.good() || (existing.peek() == std::ifstream::traits_type::eof());
+  existing.close();
+  std::ofstream output(output_name,std::ios::app);
+  if (write_header){ output << "config,routine,comm_size,bytes,iterations,max_us,mean_us\n"; }
+
+  // critter's reports are discarded
+  std::ostringstream reports;
+  std::streambuf* saved = std::cout.rdbuf(reports.rdbuf());
+  for (auto& c : configs){
+    for (auto& v : c.variables){ setenv(v.first,v.second,1); }
+    for (int np=2; np<=max_np; np*=2){
+      for (auto count : counts){
+        critter::mock::run(np,[&]{
+          MPI_Init(nullptr,nullptr);
+          bench_state s;
+          s.config = c.name;
+          s.output = &output;
+          MPI_Comm_rank(MPI_COMM_WORLD,&s.rank);
+          MPI_Comm_size(MPI_COMM_WORLD,&s.size);
+          s.partner = s.rank^1;
+          s.count = count;
+          s.iterations = iterations;
+          s.nonblocking_collectives = (std::string(c.name) != "symbol");
+          s.send_buffer.assign(count,1.);
+          s.recv_buffer.assign(count,0.);
+          critter::start();
+          bench_routines(s);
+          critter::stop();
+          MPI_Finalize();
+        });
+        reports.str("");
+      }
+    }
+    for (auto& v : c.variables){ unsetenv(v.first); }
+    fprintf(stderr,"bench_mock: %s done\n",c.name);
+  }
+  std::cout.rdbuf(saved);
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Pipelined conjugate gradient: each iteration starts a single MPI_Iallreduce of its two inner products, and overlaps it with the
+//   operator application (along with 'work' seconds of computation, rank 0 for 'imbalance' times as long) before an MPI_Wait.
+//   Each process solves its own n-by-n 1D Laplacian (shifted to bound its condition number), so only the inner products communicate.
+//   A final MPI_Allreduce computes the norm of the residual.
+//
+//   usage: mpirun -np p proxy_cg [iterations] [n] [work] [imbalance]
+//
+// Each MPI_Wait and the final MPI_Allreduce merge the paths of all processes, so each adds its cost to the longest path once.
+
+#include "proxy.h"
+
+static void apply(std::vector<double> const& v, std::vector<double>& out){
+  size_t n = v.size();
+  for (size_t i=0; i<n; i++){
+    out[i] = 2.5*v[i] - (i > 0 ? v[i-1] : 0.) - (i < n-1 ? v[i+1] : 0.);
+  }
+}
+
+int main(int argc, char** argv){
+  MPI_Init(&argc,&argv);
+  int rank,size;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&size);
+  int iterations = (argc > 1) ? atoi(argv[1]) : 16;
+  int n = (argc > 2) ? atoi(argv[2]) : 1024;
+  double work = (argc > 3) ? atof(argv[3]) : 1.e-3;
+  double imbalance = (argc > 4) ? atof(argv[4]) : 2.;
+
+  // x=0, so that r=b
+  std::vector<double> x(n,0.), r(n,1.), w(n), q(n), z(n,0.), s(n,0.), p(n,0.);
+  apply(r,w);
+  double gamma_old = 0, alpha_old = 0, initial_norm = n*size, final_norm;
+
+  proxy::segments seg;
+  double start_time = proxy::begin();
+  seg.resume();
+  for (int it=0; it<iterations; it++){
+    double local[2] = {0,0}, global[2];
+    for (int i=0; i<n; i++){ local[0] += r[i]*r[i]; local[1] += w[i]*r[i]; }
+    seg.pause();
+    MPI_Request request;
+    MPI_Iallreduce(local,global,2,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD,&request);
+    seg.resume();
+    apply(w,q);
+    proxy::work(rank == 0 ? imbalance*work : work);
+    seg.pause();
+    seg.close();
+    MPI_Wait(&request,MPI_STATUS_IGNORE);
+    seg.resume();
+    double gamma = global[0], delta = global[1];
+    double beta = (it > 0) ? gamma/gamma_old : 0.;
+    double alpha = (it > 0) ? gamma/(delta - beta*gamma/alpha_old) : gamma/delta;
+    for (int i=0; i<n; i++){
+      z[i] = q[i] + beta*z[i];
+      s[i] = w[i] + beta*s[i];
+      p[i] = r[i] + beta*p[i];
+      x[i] += alpha*p[i];
+      r[i] -= alpha*s[i];
+      w[i] -= alpha*z[i];
+    }
+    gamma_old = gamma;
+    alpha_old = alpha;
+  }
+  double local_norm = 0;
+  for (int i=0; i<n; i++){ local_norm += r[i]*r[i]; }
+  seg.pause();
+  seg.close();
+  MPI_Allreduce(&local_norm,&final_norm,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  seg.resume();
+  seg.pause();
+  seg.close();
+  double elapsed = proxy::end(start_time);
+  proxy::check((iterations == 0) || (final_norm < initial_norm),"the residual did not decrease");
+
+  std::vector<double> all = seg.gather(iterations+2);
+  proxy::expected e;
+  int64_t bytes = 2*sizeof(double);
+  e.bsp_synch_cost = iterations+1;
+  e.bsp_comm_cost = iterations*bytes + sizeof(double);
+  e.ab_synch_cost = 2.*log2((double)size)*(iterations+1);
+  e.ab_comm_cost = 2.*e.bsp_comm_cost;
+  e.comp_time = (rank == 0) ? proxy::merged_path_time(all,iterations+2) : 0;
+  proxy::report("cg",elapsed,e);
+  MPI_Finalize();
+  return 0;
+}
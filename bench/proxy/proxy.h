@@ -0,0 +1,133 @@
+#ifndef CRITTER__BENCH__PROXY__PROXY_H_
+#define CRITTER__BENCH__PROXY__PROXY_H_
+
+// Shared utilities of the proxy applications, each of which runs a fixed communication pattern with a critical path known in closed form.
+//   Built against critter (bin/proxy_<name>), each proxy prints critter's report followed by a line holding the values that its
+//   'Critical path' row should report, for bench/proxy/run.sh to compare. Built with -DCRITTER_BENCH_PMPI (bin/proxy_<name>_pmpi),
+//   the same pattern runs uninstrumented, and only the elapsed time is printed.
+//
+// The cost measures (BSPCommCost, BSPSynchCost, ABCommCost, ABSynchCost) along each critical path follow from the communication pattern alone.
+//   The computation time along the computation-time critical path follows from the same pattern, evaluated on the time each process
+//   spends between its communication routines (as measured by the proxy itself), and the execution-time critical path spans the elapsed time.
+
+#ifdef CRITTER_BENCH_PMPI
+#include "mpi.h"
+#define CRITTER_START(ARG)
+#define CRITTER_STOP(ARG)
+#else
+#include "../../include/critter.h"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+
+namespace proxy{
+
+/* \brief values that the 'Critical path' row of critter's report should hold */
+struct expected{
+  double bsp_comm_cost;
+  double bsp_synch_cost;
+  double ab_comm_cost;
+  double ab_synch_cost;
+  double comp_time;
+};
+
+/* \brief accumulates the time a process spends between its communication routines, one segment at a time */
+class segments{
+  public:
+    /** \brief start timing within the current segment, directly after a communication routine */
+    void resume(){ this->mark = MPI_Wtime(); }
+    /** \brief stop timing, directly before a communication routine */
+    void pause(){ this->current += MPI_Wtime() - this->mark; }
+    /** \brief close the current segment, at a communication routine that merges paths */
+    void close(){ this->times.push_back(this->current); this->current = 0; }
+    /** \brief gather the segments of all processes onto rank 0 of MPI_COMM_WORLD, each in 'max_count' slots (unused slots hold zero) */
+    std::vector<double> gather(size_t max_count){
+      int rank; MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+      int size; MPI_Comm_size(MPI_COMM_WORLD,&size);
+      this->times.resize(max_count,0.);
+      std::vector<double> all(rank == 0 ? max_count*size : 0);
+      PMPI_Gather(&this->times[0],max_count,MPI_DOUBLE,all.data(),max_count,MPI_DOUBLE,0,MPI_COMM_WORLD);
+      return all;
+    }
+
+    std::vector<double> times;
+  private:
+    double mark = 0;
+    double current = 0;
+};
+
+/** \brief spend 'seconds' in a stand-in for local computation */
+inline void work(double seconds){
+  usleep((useconds_t)(seconds*1.e6));
+}
+
+/** \brief start the window of tracked execution; returns its start time */
+inline double begin(){
+#ifndef CRITTER_BENCH_PMPI
+  critter::start();
+#else
+  PMPI_Barrier(MPI_COMM_WORLD);
+#endif
+  return MPI_Wtime();
+}
+
+/** \brief close the window of tracked execution started at 'start_time'; returns its elapsed time, maximized over all processes */
+inline double end(double start_time){
+  double elapsed = MPI_Wtime() - start_time;
+#ifndef CRITTER_BENCH_PMPI
+  critter::stop();
+#endif
+  double max_elapsed;
+  PMPI_Allreduce(&elapsed,&max_elapsed,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+  return max_elapsed;
+}
+
+/** \brief print the line that bench/proxy/run.sh compares against critter's report (rank 0 only) */
+inline void report(char const* name, double elapsed, expected const& e){
+  int rank; MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  int size; MPI_Comm_size(MPI_COMM_WORLD,&size);
+  if (rank != 0) return;
+  printf("proxy: %s np=%d Elapsed=%.9g",name,size,elapsed);
+#ifndef CRITTER_BENCH_PMPI
+  printf(" BSPCommCost=%.9g BSPSynchCost=%.9g ABCommCost=%.9g ABSynchCost=%.9g CompTime=%.9g RunTime=%.9g",
+         e.bsp_comm_cost,e.bsp_synch_cost,e.ab_comm_cost,e.ab_synch_cost,e.comp_time,elapsed);
+#endif
+  printf("\n");
+  fflush(stdout);
+}
+
+/** \brief computation time along a path through 'segment_count' segments, each closed by a routine that merges the paths of all processes */
+inline double merged_path_time(std::vector<double> const& all, size_t segment_count){
+  size_t size = all.size()/segment_count;
+  double path = 0;
+  for (size_t t=0; t<segment_count; t++){
+    double max_time = 0;
+    for (size_t r=0; r<size; r++){ max_time = std::max(max_time,all[r*segment_count+t]); }
+    path += max_time;
+  }
+  return path;
+}
+
+/** \brief whether path data propagates along p2p communication only from sender to receiver, as of the initiation of the send
+ *         (CRITTER_EAGER_P2P=1 or CRITTER_PIGGYBACK_P2P=1) */
+inline bool sender_only_p2p(){
+  char const* eager = std::getenv("CRITTER_EAGER_P2P");
+  char const* piggyback = std::getenv("CRITTER_PIGGYBACK_P2P");
+  return ((eager != NULL) && (atoi(eager) == 1)) || ((piggyback != NULL) && (atoi(piggyback) == 1));
+}
+
+/** \brief fail with 'message' if 'condition' does not hold, on any process */
+inline void check(bool condition, char const* message){
+  if (!condition){
+    fprintf(stderr,"proxy: %s\n",message);
+    MPI_Abort(MPI_COMM_WORLD,1);
+  }
+}
+
+}
+
+#endif /*CRITTER__BENCH__PROXY__PROXY_H_*/
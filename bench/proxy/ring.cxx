@@ -0,0 +1,80 @@
+// Pipelined ring: rank 0 injects 'messages' messages that each pass through ranks 1,...,p-1 via MPI_Send/MPI_Recv,
+//   with each process computing for 'work' seconds before it forwards each message.
+//
+//   usage: mpirun -np p proxy_ring [messages] [doubles per message] [work]
+//
+// Let message k pass from rank e to rank e+1 at event (e,k). Sender and receiver merge paths at each event, so a path through
+//   the events can step from (e,k) to (e+1,k), or to (e-1,k+1), as rank e forwards message k+1 only after forwarding message k.
+//   Each step increases e+2k by one, so the longest path through the events counts p-2+2(messages-1)+1 of them, for p>2.
+//   With p=2, each event follows the last, so the longest path counts 'messages' of them.
+// If path data propagates only from sender to receiver, as of the initiation of the send, each of ranks 1,...,p-2 adds its own receive and
+//   send of each message to the longest path, which thus counts 2*messages of them for p>2.
+
+#include "proxy.h"
+
+int main(int argc, char** argv){
+  MPI_Init(&argc,&argv);
+  int rank,size;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&size);
+  proxy::check(size > 1,"the ring requires at least 2 processes");
+  int messages = (argc > 1) ? atoi(argv[1]) : 16;
+  int count = (argc > 2) ? atoi(argv[2]) : 1024;
+  double work = (argc > 3) ? atof(argv[3]) : 1.e-3;
+
+  std::vector<double> message(count,0.);
+  proxy::segments seg;
+  double start_time = proxy::begin();
+  seg.resume();
+  for (int k=0; k<messages; k++){
+    if (rank > 0){
+      seg.pause();
+      seg.close();
+      MPI_Recv(&message[0],count,MPI_DOUBLE,rank-1,k,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+      seg.resume();
+    }
+    proxy::work(work);
+    for (auto& it : message){ it += 1.; }
+    if (rank < size-1){
+      seg.pause();
+      seg.close();
+      MPI_Send(&message[0],count,MPI_DOUBLE,rank+1,k,MPI_COMM_WORLD);
+      seg.resume();
+    }
+  }
+  seg.pause();
+  seg.close();
+  double elapsed = proxy::end(start_time);
+  if (rank == size-1){ proxy::check(message[0] == size+messages-1,"the last process received corrupted messages"); }
+
+  // Every process but the first and last closes a segment at each of its 2*messages events, and one at the end
+  std::vector<double> all = seg.gather(2*messages+1);
+  proxy::expected e;
+  int64_t bytes = count*sizeof(double);
+  bool sender_only = proxy::sender_only_p2p();
+  double events = (size == 2) ? messages : (sender_only ? 2*messages : size+2*messages-3);
+  e.bsp_synch_cost = events;
+  e.bsp_comm_cost = events*bytes;
+  e.ab_synch_cost = events;
+  e.ab_comm_cost = events*bytes;
+  e.comp_time = 0;
+  if (rank == 0){
+    // Replay the events in order: each process adds the segment that precedes the event, and the two paths merge (or the receiver's
+    //   path takes the sender's)
+    size_t slots = 2*messages+1;
+    std::vector<double> path(size,0.);
+    std::vector<size_t> next(size,0);
+    for (int k=0; k<messages; k++){
+      for (int r=0; r<size-1; r++){
+        path[r] += all[r*slots+next[r]++];
+        path[r+1] += all[(r+1)*slots+next[r+1]++];
+        path[r+1] = std::max(path[r],path[r+1]);
+        if (!sender_only) path[r] = path[r+1];
+      }
+    }
+    for (int r=0; r<size; r++){ e.comp_time = std::max(e.comp_time,path[r]+all[r*slots+next[r]]); }
+  }
+  proxy::report("ring",elapsed,e);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,98 @@
+// 2D stencil: each process owns an n-by-n tile of a (non-periodic) px-by-py process grid, and at each iteration computes for 'work' seconds
+//   (rank 0 for 'imbalance' times as long) before it exchanges a halo of n doubles with each neighbor via MPI_Isend/MPI_Irecv and MPI_Waitall.
+//
+//   usage: mpirun -np p proxy_stencil [iterations] [n] [work] [imbalance]
+//
+// Each request of a Waitall adds its cost to the path of its process, and then sends the path to its partner, which merges it only at
+//   the end of its own Waitall. A process with the most neighbors thus adds 2*(its neighbors) messages per iteration to the longest path,
+//   and no path can add more.
+
+#include "proxy.h"
+
+int main(int argc, char** argv){
+  MPI_Init(&argc,&argv);
+  int rank,size;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&size);
+  int iterations = (argc > 1) ? atoi(argv[1]) : 16;
+  int n = (argc > 2) ? atoi(argv[2]) : 256;
+  double work = (argc > 3) ? atof(argv[3]) : 1.e-3;
+  double imbalance = (argc > 4) ? atof(argv[4]) : 2.;
+
+  int dims[2] = {0,0};
+  MPI_Dims_create(size,2,dims);
+  int x = rank % dims[0];
+  int y = rank / dims[0];
+  // Neighbors in order: -x, +x, -y, +y (or -1 at the boundary of the grid)
+  int neighbors[4] = {x > 0 ? rank-1 : -1,
+                      x < dims[0]-1 ? rank+1 : -1,
+                      y > 0 ? rank-dims[0] : -1,
+                      y < dims[1]-1 ? rank+dims[0] : -1};
+  std::vector<double> tile((n+2)*(n+2),(double)rank);
+  std::vector<double> send_halo(4*n), recv_halo(4*n);
+
+  proxy::segments seg;
+  double start_time = proxy::begin();
+  seg.resume();
+  for (int it=0; it<iterations; it++){
+    proxy::work(rank == 0 ? imbalance*work : work);
+    for (int i=0; i<n; i++){
+      send_halo[i]     = tile[(i+1)*(n+2)+1];
+      send_halo[n+i]   = tile[(i+1)*(n+2)+n];
+      send_halo[2*n+i] = tile[1*(n+2)+i+1];
+      send_halo[3*n+i] = tile[n*(n+2)+i+1];
+    }
+    seg.pause();
+    seg.close();
+    MPI_Request requests[8]; int request_count=0;
+    for (int d=0; d<4; d++){
+      if (neighbors[d] == -1) continue;
+      // Direction d receives the message its neighbor sends in the opposite direction (d^1)
+      MPI_Irecv(&recv_halo[d*n],n,MPI_DOUBLE,neighbors[d],d^1,MPI_COMM_WORLD,&requests[request_count++]);
+    }
+    for (int d=0; d<4; d++){
+      if (neighbors[d] == -1) continue;
+      MPI_Isend(&send_halo[d*n],n,MPI_DOUBLE,neighbors[d],d,MPI_COMM_WORLD,&requests[request_count++]);
+    }
+    MPI_Waitall(request_count,requests,MPI_STATUSES_IGNORE);
+    seg.resume();
+    for (int d=0; d<4; d++){
+      if (neighbors[d] == -1) continue;
+      proxy::check(recv_halo[d*n] == neighbors[d],"a halo holds data from the wrong process");
+    }
+  }
+  seg.pause();
+  seg.close();
+  double elapsed = proxy::end(start_time);
+
+  std::vector<double> all = seg.gather(iterations+1);
+  proxy::expected e;
+  int64_t bytes = n*sizeof(double);
+  double max_neighbors = std::min(dims[0]-1,2) + std::min(dims[1]-1,2);
+  e.bsp_synch_cost = iterations*2*max_neighbors;
+  e.bsp_comm_cost = e.bsp_synch_cost*bytes;
+  e.ab_synch_cost = e.bsp_synch_cost;
+  e.ab_comm_cost = e.bsp_comm_cost;
+  e.comp_time = 0;
+  if (rank == 0){
+    // Each iteration merges the path of each process with those of its neighbors
+    size_t slots = iterations+1;
+    std::vector<double> path(size,0.), next_path(size);
+    for (int it=0; it<iterations; it++){
+      for (int r=0; r<size; r++){ path[r] += all[r*slots+it]; }
+      for (int r=0; r<size; r++){
+        int rx = r % dims[0], ry = r / dims[0];
+        next_path[r] = path[r];
+        if (rx > 0)         next_path[r] = std::max(next_path[r],path[r-1]);
+        if (rx < dims[0]-1) next_path[r] = std::max(next_path[r],path[r+1]);
+        if (ry > 0)         next_path[r] = std::max(next_path[r],path[r-dims[0]]);
+        if (ry < dims[1]-1) next_path[r] = std::max(next_path[r],path[r+dims[0]]);
+      }
+      path.swap(next_path);
+    }
+    for (int r=0; r<size; r++){ e.comp_time = std::max(e.comp_time,path[r]+all[r*slots+iterations]); }
+  }
+  proxy::report("stencil",elapsed,e);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,77 @@
+// SUMMA: C = A*B over a pr-by-pc process grid, with an n-by-n block of C on each process. At each of 'panels' steps (rounded up to a multiple
+//   of lcm(pr,pc)), the owner of the next n-by-b panel of A broadcasts it along its row communicator, the owner of the next b-by-n panel of B
+//   broadcasts it along its column communicator, and each process accumulates their product (and computes for 'work' seconds, rank 0 for
+//   'imbalance' times as long).
+//
+//   usage: mpirun -np p proxy_summa [panels] [n] [b] [work] [imbalance]
+//
+// The row broadcast merges the paths of each row, and the column broadcast then merges those of all processes, so each step adds one
+//   broadcast over pc processes and one over pr processes to the longest path.
+
+#include "proxy.h"
+
+int main(int argc, char** argv){
+  MPI_Init(&argc,&argv);
+  int rank,size;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&size);
+  int panels = (argc > 1) ? atoi(argv[1]) : 16;
+  int n = (argc > 2) ? atoi(argv[2]) : 32;
+  int b = (argc > 3) ? atoi(argv[3]) : 8;
+  double work = (argc > 4) ? atof(argv[4]) : 1.e-3;
+  double imbalance = (argc > 5) ? atof(argv[5]) : 2.;
+
+  int dims[2] = {0,0};
+  MPI_Dims_create(size,2,dims);
+  int pr = dims[0], pc = dims[1];
+  int row = rank / pc, col = rank % pc;
+  int steps = pr*pc;
+  for (int g=std::min(pr,pc); g>0; g--){
+    if ((pr%g == 0) && (pc%g == 0)){ steps /= g; break; }
+  }
+  steps *= (panels+steps-1)/steps;
+  MPI_Comm row_comm,col_comm;
+  PMPI_Comm_split(MPI_COMM_WORLD,row,col,&row_comm);
+  PMPI_Comm_split(MPI_COMM_WORLD,col,row,&col_comm);
+
+  // Panel k of A is owned by column k%pc of each row, and panel k of B by row k%pr of each column
+  std::vector<double> a_panel(n*b), b_panel(b*n), c(n*n,0.);
+  std::vector<double> a_owned(n*b,1.), b_owned(b*n,1.);
+
+  proxy::segments seg;
+  double start_time = proxy::begin();
+  seg.resume();
+  for (int k=0; k<steps; k++){
+    seg.pause();
+    if (col == k%pc) a_panel = a_owned;
+    MPI_Bcast(&a_panel[0],n*b,MPI_DOUBLE,k%pc,row_comm);
+    if (row == k%pr) b_panel = b_owned;
+    MPI_Bcast(&b_panel[0],b*n,MPI_DOUBLE,k%pr,col_comm);
+    seg.close();
+    seg.resume();
+    for (int i=0; i<n; i++){
+      for (int l=0; l<b; l++){
+        for (int j=0; j<n; j++){ c[i*n+j] += a_panel[i*b+l]*b_panel[l*n+j]; }
+      }
+    }
+    proxy::work(rank == 0 ? imbalance*work : work);
+  }
+  seg.pause();
+  seg.close();
+  double elapsed = proxy::end(start_time);
+  proxy::check(c[0] == steps*b && c[n*n-1] == steps*b,"the product is incorrect");
+  MPI_Comm_free(&row_comm);
+  MPI_Comm_free(&col_comm);
+
+  std::vector<double> all = seg.gather(steps+1);
+  proxy::expected e;
+  int64_t bytes = n*b*sizeof(double);
+  e.bsp_synch_cost = 2*steps;
+  e.bsp_comm_cost = 2*steps*bytes;
+  e.ab_synch_cost = steps*(2.*log2((double)pc) + 2.*log2((double)pr));
+  e.ab_comm_cost = 2*steps*2*bytes;
+  e.comp_time = (rank == 0) ? proxy::merged_path_time(all,steps+1) : 0;
+  proxy::report("summa",elapsed,e);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,215 @@
+// Measures the per-call latency of each MPI routine that critter intercepts, over a sweep of message sizes and communicator sizes.
+//   Built against critter (bin/bench_routines), the configuration is selected by the environment variables of critter as usual.
+//   Built with -DCRITTER_BENCH_PMPI (bin/bench_routines_pmpi), the same calls go directly to the MPI library.
+//
+//   usage: mpirun -np N bench_routines <config> <output.csv> [max_bytes] [iterations]
+//
+//   Each row of <output.csv> (appended to, with a header if empty) holds the configuration label, the routine, the communicator size,
+//   the message size in bytes (per process, or per destination for personalized collectives), the number of timed calls,
+//   and the max and mean time per call over the processes of the communicator, in microseconds.
+//   Point-to-point routines are timed between pairs of neighboring ranks: Send, Ssend, and Bsend against Recv, Recv against Send,
+//   and Isend and Irecv against each other. Nonblocking routines are timed along with the MPI_Wait that completes them.
+
+#ifdef CRITTER_BENCH_PMPI
+#include "mpi.h"
+#define CRITTER_START(ARG)
+#define CRITTER_STOP(ARG)
+#else
+#include "../include/critter.h"
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const int warmup_iterations = 5;
+
+struct bench_state{
+  std::string config;
+  std::ofstream* output;
+  MPI_Comm comm;
+  int rank;
+  int size;
+  int partner;
+  int count;
+  int iterations;
+  std::vector<double> send_buffer;
+  std::vector<double> recv_buffer;
+  std::vector<int> counts;
+  std::vector<int> displs;
+};
+
+static void record(bench_state& s, char const* routine, double elapsed){
+  double per_call = 1.e6*elapsed/s.iterations;
+  double max_time,sum_time;
+  PMPI_Reduce(&per_call,&max_time,1,MPI_DOUBLE,MPI_MAX,0,s.comm);
+  PMPI_Reduce(&per_call,&sum_time,1,MPI_DOUBLE,MPI_SUM,0,s.comm);
+  if (s.output != nullptr){
+    *s.output << s.config << "," << routine << "," << s.size << "," << s.count*sizeof(double) << "," << s.iterations
+              << "," << max_time << "," << sum_time/s.size << "\n";
+  }
+}
+
+// Times 'iterations' calls of the statements that follow the routine name, after as many untimed calls as 'warmup_iterations'.
+//   Each routine is timed within a user-defined kernel of its own name, for the configurations that decompose paths by kernel.
+#define BENCH(ROUTINE, ...)\
+  do {\
+    for (int it=0; it<warmup_iterations; it++){ __VA_ARGS__; }\
+    PMPI_Barrier(s.comm);\
+    double start_time = MPI_Wtime();\
+    CRITTER_START(ROUTINE);\
+    for (int it=0; it<s.iterations; it++){ __VA_ARGS__; }\
+    CRITTER_STOP(ROUTINE);\
+    record(s,#ROUTINE,MPI_Wtime()-start_time);\
+  } while (0)
+
+static void bench_p2p(bench_state& s, bool use_bsend){
+  double* sbuf = &s.send_buffer[0];
+  double* rbuf = &s.recv_buffer[0];
+  int n = s.count;
+  int p = s.partner;
+  bool even = (s.rank%2 == 0);
+  MPI_Request req;
+  BENCH(MPI_Send,
+    if (even) { MPI_Send(sbuf,n,MPI_DOUBLE,p,0,s.comm); }
+    else      { MPI_Recv(rbuf,n,MPI_DOUBLE,p,0,s.comm,MPI_STATUS_IGNORE); });
+  BENCH(MPI_Ssend,
+    if (even) { MPI_Ssend(sbuf,n,MPI_DOUBLE,p,0,s.comm); }
+    else      { MPI_Recv(rbuf,n,MPI_DOUBLE,p,0,s.comm,MPI_STATUS_IGNORE); });
+  if (use_bsend){
+    BENCH(MPI_Bsend,
+      if (even) { MPI_Bsend(sbuf,n,MPI_DOUBLE,p,0,s.comm); }
+      else      { MPI_Recv(rbuf,n,MPI_DOUBLE,p,0,s.comm,MPI_STATUS_IGNORE); });
+  }
+  BENCH(MPI_Recv,
+    if (even) { MPI_Recv(rbuf,n,MPI_DOUBLE,p,0,s.comm,MPI_STATUS_IGNORE); }
+    else      { MPI_Send(sbuf,n,MPI_DOUBLE,p,0,s.comm); });
+  BENCH(MPI_Sendrecv,
+    MPI_Sendrecv(sbuf,n,MPI_DOUBLE,p,0,rbuf,n,MPI_DOUBLE,p,0,s.comm,MPI_STATUS_IGNORE));
+  BENCH(MPI_Sendrecv_replace,
+    MPI_Sendrecv_replace(rbuf,n,MPI_DOUBLE,p,0,p,0,s.comm,MPI_STATUS_IGNORE));
+  BENCH(MPI_Isend,
+    if (even) { MPI_Isend(sbuf,n,MPI_DOUBLE,p,0,s.comm,&req); }
+    else      { MPI_Irecv(rbuf,n,MPI_DOUBLE,p,0,s.comm,&req); }
+    MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Irecv,
+    if (even) { MPI_Irecv(rbuf,n,MPI_DOUBLE,p,0,s.comm,&req); }
+    else      { MPI_Isend(sbuf,n,MPI_DOUBLE,p,0,s.comm,&req); }
+    MPI_Wait(&req,MPI_STATUS_IGNORE));
+}
+
+static void bench_collectives(bench_state& s, bool use_nonblocking){
+  double* sbuf = &s.send_buffer[0];
+  double* rbuf = &s.recv_buffer[0];
+  int n = s.count;
+  int const* counts = &s.counts[0];
+  int const* displs = &s.displs[0];
+  MPI_Request req;
+  BENCH(MPI_Barrier, MPI_Barrier(s.comm));
+  BENCH(MPI_Bcast, MPI_Bcast(sbuf,n,MPI_DOUBLE,0,s.comm));
+  BENCH(MPI_Reduce, MPI_Reduce(sbuf,rbuf,n,MPI_DOUBLE,MPI_SUM,0,s.comm));
+  BENCH(MPI_Allreduce, MPI_Allreduce(sbuf,rbuf,n,MPI_DOUBLE,MPI_SUM,s.comm));
+  BENCH(MPI_Gather, MPI_Gather(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,0,s.comm));
+  BENCH(MPI_Allgather, MPI_Allgather(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,s.comm));
+  BENCH(MPI_Scatter, MPI_Scatter(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,0,s.comm));
+  BENCH(MPI_Reduce_scatter, MPI_Reduce_scatter(sbuf,rbuf,counts,MPI_DOUBLE,MPI_SUM,s.comm));
+  BENCH(MPI_Alltoall, MPI_Alltoall(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,s.comm));
+  BENCH(MPI_Gatherv, MPI_Gatherv(sbuf,n,MPI_DOUBLE,rbuf,counts,displs,MPI_DOUBLE,0,s.comm));
+  BENCH(MPI_Allgatherv, MPI_Allgatherv(sbuf,n,MPI_DOUBLE,rbuf,counts,displs,MPI_DOUBLE,s.comm));
+  BENCH(MPI_Scatterv, MPI_Scatterv(sbuf,counts,displs,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,0,s.comm));
+  BENCH(MPI_Alltoallv, MPI_Alltoallv(sbuf,counts,displs,MPI_DOUBLE,rbuf,counts,displs,MPI_DOUBLE,s.comm));
+  if (!use_nonblocking) return;
+  BENCH(MPI_Ibcast, MPI_Ibcast(sbuf,n,MPI_DOUBLE,0,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Iallreduce, MPI_Iallreduce(sbuf,rbuf,n,MPI_DOUBLE,MPI_SUM,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Ireduce, MPI_Ireduce(sbuf,rbuf,n,MPI_DOUBLE,MPI_SUM,0,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Igather, MPI_Igather(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,0,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Igatherv, MPI_Igatherv(sbuf,n,MPI_DOUBLE,rbuf,counts,displs,MPI_DOUBLE,0,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Iallgather, MPI_Iallgather(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Iallgatherv, MPI_Iallgatherv(sbuf,n,MPI_DOUBLE,rbuf,counts,displs,MPI_DOUBLE,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Iscatter, MPI_Iscatter(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,0,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Iscatterv, MPI_Iscatterv(sbuf,counts,displs,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,0,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Ireduce_scatter, MPI_Ireduce_scatter(sbuf,rbuf,counts,MPI_DOUBLE,MPI_SUM,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Ialltoall, MPI_Ialltoall(sbuf,n,MPI_DOUBLE,rbuf,n,MPI_DOUBLE,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+  BENCH(MPI_Ialltoallv, MPI_Ialltoallv(sbuf,counts,displs,MPI_DOUBLE,rbuf,counts,displs,MPI_DOUBLE,s.comm,&req); MPI_Wait(&req,MPI_STATUS_IGNORE));
+}
+
+int main(int argc, char** argv){
+  MPI_Init(&argc,&argv);
+  int world_rank,world_size;
+  MPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&world_size);
+  if ((argc < 3) || (world_size < 2)){
+    if (world_rank == 0) printf("usage: mpirun -np N %s <config> <output.csv> [max_bytes] [iterations], with N >= 2\n",argv[0]);
+    MPI_Finalize();
+    return 1;
+  }
+  size_t max_bytes = (argc > 3) ? atol(argv[3]) : 65536;
+  int iterations = (argc > 4) ? atoi(argv[4]) : 100;
+
+  bench_state s;
+  s.config = argv[1];
+  s.iterations = iterations;
+  s.output = nullptr;
+  std::ofstream output;
+  if (world_rank == 0){
+    bool is_new = !std::ifstream(argv[2]).good();
+    output.open(argv[2],std::ios::app);
+    if (is_new) output << "config,routine,comm_size,bytes,iterations,max_us,avg_us\n";
+  }
+  // A buffer attached for internal communication (CRITTER_EAGER_P2P=1) leaves none for MPI_Bsend
+  bool use_bsend = (std::getenv("CRITTER_EAGER_P2P") == NULL) || (atoi(std::getenv("CRITTER_EAGER_P2P")) == 0);
+  // User-defined kernels are not tracked through nonblocking collectives (see README)
+  char const* symbol_select = std::getenv("CRITTER_SYMBOL_PATH_SELECT");
+  bool use_nonblocking = (symbol_select == NULL) || (std::strchr(symbol_select,'1') == NULL);
+  std::vector<char> bsend_buffer;
+  if (use_bsend){
+    bsend_buffer.resize((iterations+warmup_iterations)*(max_bytes+MPI_BSEND_OVERHEAD));
+    MPI_Buffer_attach(&bsend_buffer[0],bsend_buffer.size());
+  }
+
+  // Communicators of each even size up to the number of processes (doubling, along with the largest) are formed from consecutive ranks
+  std::vector<int> comm_sizes;
+  for (int c=2; c<=world_size; c*=2){ comm_sizes.push_back(c); }
+  if ((world_size%2 == 0) && (comm_sizes.back() != world_size)){ comm_sizes.push_back(world_size); }
+
+#ifndef CRITTER_BENCH_PMPI
+  critter::start();
+#endif
+  for (auto comm_size : comm_sizes){
+    int color = (world_rank/comm_size < world_size/comm_size) ? world_rank/comm_size : MPI_UNDEFINED;
+    MPI_Comm comm;
+    PMPI_Comm_split(MPI_COMM_WORLD,color,world_rank,&comm);
+    if (comm != MPI_COMM_NULL){
+      s.comm = comm;
+      MPI_Comm_rank(comm,&s.rank);
+      MPI_Comm_size(comm,&s.size);
+      s.partner = s.rank^1;
+      // Only the first communicator of each size reports
+      s.output = (world_rank == 0) ? &output : nullptr;
+      for (size_t bytes=sizeof(double); bytes<=max_bytes; bytes*=8){
+        s.count = bytes/sizeof(double);
+        s.send_buffer.assign(s.count*s.size,1.);
+        s.recv_buffer.assign(s.count*s.size,0.);
+        s.counts.assign(s.size,s.count);
+        s.displs.resize(s.size);
+        for (int i=0; i<s.size; i++){ s.displs[i] = i*s.count; }
+        bench_p2p(s,use_bsend);
+        bench_collectives(s,use_nonblocking);
+      }
+      MPI_Comm_free(&comm);
+    }
+    PMPI_Barrier(MPI_COMM_WORLD);
+  }
+#ifndef CRITTER_BENCH_PMPI
+  critter::stop();
+#endif
+
+  if (use_bsend){
+    void* buffer; int buffer_size;
+    MPI_Buffer_detach(&buffer,&buffer_size);
+  }
+  MPI_Finalize();
+  return 0;
+}
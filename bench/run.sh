@@ -0,0 +1,37 @@
+#!/bin/bash
+# Runs the per-call microbenchmarks (bin/bench_routines, see bench/routines.cxx) under each configuration below,
+#   appending all results to a single CSV file; critter's own reports are written alongside it, to <output>.log.
+#
+#   usage: bench/run.sh [np] [output.csv] [max_bytes] [iterations]
+#   MPIRUN (default mpirun) and MPIRUN_FLAGS are used to launch each run.
+
+NP=${1:-4}
+OUTPUT=${2:-bench_routines.csv}
+MAX_BYTES=${3:-65536}
+ITERATIONS=${4:-100}
+MPIRUN=${MPIRUN:-mpirun}
+BIN=$(cd "$(dirname "$0")/.." && pwd)/bin
+LOG=${OUTPUT}.log
+
+if [ ! -x ${BIN}/bench_routines ] || [ ! -x ${BIN}/bench_routines_pmpi ]; then
+  echo "bench/run.sh: build the benchmarks first, with 'make bench'"
+  exit 1
+fi
+: > ${LOG}
+
+# run <config label> <environment assignments...>
+run(){
+  local config=$1; shift
+  echo "${config}"
+  echo "==== ${config}" >> ${LOG}
+  env "$@" ${MPIRUN} ${MPIRUN_FLAGS} -np ${NP} ${BIN}/bench_routines ${config} ${OUTPUT} ${MAX_BYTES} ${ITERATIONS} >> ${LOG} || exit 1
+}
+
+echo "pmpi"
+${MPIRUN} ${MPIRUN_FLAGS} -np ${NP} ${BIN}/bench_routines_pmpi pmpi ${OUTPUT} ${MAX_BYTES} ${ITERATIONS} || exit 1
+run mode0          CRITTER_MODE=0
+run mode1          CRITTER_MODE=1
+run comm_exec      CRITTER_MODE=1 CRITTER_COMM_PATH_SELECT=00000001
+run comm_all       CRITTER_MODE=1 CRITTER_COMM_PATH_SELECT=11111111
+run symbol_exec    CRITTER_MODE=1 CRITTER_SYMBOL_PATH_SELECT=00000001
+run symbol_comm    CRITTER_MODE=1 CRITTER_SYMBOL_PATH_SELECT=00000001 CRITTER_COMM_PATH_SELECT=00000001
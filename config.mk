@@ -2,3 +2,5 @@ CXX      = mpicxx
 INCLUDES = -I$(HOME)/critter/include
 CXXFLAGS = -g -O2 -std=c++0x -fPIC
 LDFLAGS  = 
+# compiles critter against the thread-based MPI stand-in in test/mock, for 'make test' and bin/bench_mock
+MOCK_CXX = g++
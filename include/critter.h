@@ -215,32 +215,38 @@
 
 #define CRITTER_START(ARG)\
   do {\
-    critter::internal::symbol_start(#ARG);\
+    static CRITTER_RANK_LOCAL const int critter_symbol_id = critter::internal::symbol_id(#ARG);\
+    critter::internal::symbol_start(critter_symbol_id);\
     } while (0);
 
 #define CRITTER_STOP(ARG)\
   do {\
-    critter::internal::symbol_stop(#ARG);\
+    static CRITTER_RANK_LOCAL const int critter_symbol_id = critter::internal::symbol_id(#ARG);\
+    critter::internal::symbol_stop(critter_symbol_id);\
   } while (0);
 
 #define TAU_START(ARG)\
   do {\
-    critter::internal::symbol_start(#ARG);\
+    static CRITTER_RANK_LOCAL const int critter_symbol_id = critter::internal::symbol_id(#ARG);\
+    critter::internal::symbol_start(critter_symbol_id);\
     } while (0);
 
 #define TAU_STOP(ARG)\
   do {\
-    critter::internal::symbol_stop(#ARG);\
+    static CRITTER_RANK_LOCAL const int critter_symbol_id = critter::internal::symbol_id(#ARG);\
+    critter::internal::symbol_stop(critter_symbol_id);\
   } while (0);
 
 #define TAU_FSTART(ARG)\
   do {\
-    critter::internal::symbol_start(#ARG);\
+    static CRITTER_RANK_LOCAL const int critter_symbol_id = critter::internal::symbol_id(#ARG);\
+    critter::internal::symbol_start(critter_symbol_id);\
     } while (0);
 
 #define TAU_FSTOP(ARG)\
   do {\
-    critter::internal::symbol_stop(#ARG);\
+    static CRITTER_RANK_LOCAL const int critter_symbol_id = critter::internal::symbol_id(#ARG);\
+    critter::internal::symbol_stop(critter_symbol_id);\
   } while (0);
 
 #endif /*CRITTER_H_*/
@@ -4,207 +4,206 @@ namespace critter{
 namespace internal{
 namespace decomposition{
 
-std::map<MPI_Request,nonblocking*> internal_comm_track;
-blocking _MPI_Barrier("MPI_Barrier",0, 
+CRITTER_RANK_LOCAL blocking _MPI_Barrier("MPI_Barrier",0, 
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,0.);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),0.);}
                         );
-blocking _MPI_Bcast("MPI_Bcast",1,
+CRITTER_RANK_LOCAL blocking _MPI_Bcast("MPI_Bcast",1,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(2.*log2((double)p),2.*n);}
                       );
-blocking _MPI_Reduce("MPI_Reduce",2, 
+CRITTER_RANK_LOCAL blocking _MPI_Reduce("MPI_Reduce",2, 
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(2.*log2((double)p),2.*n);}
                        );
-blocking _MPI_Allreduce("MPI_Allreduce",3,
+CRITTER_RANK_LOCAL blocking _MPI_Allreduce("MPI_Allreduce",3,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}, 
                           [](int64_t n, int p){
                             return std::pair<double,double>(2.*log2((double)p),2.*n);}
                           );
-blocking _MPI_Gather("MPI_Gather",4,
+CRITTER_RANK_LOCAL blocking _MPI_Gather("MPI_Gather",4,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                        );
-blocking _MPI_Allgather("MPI_Allgather",5,
+CRITTER_RANK_LOCAL blocking _MPI_Allgather("MPI_Allgather",5,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                           );
-blocking _MPI_Scatter("MPI_Scatter",6,
+CRITTER_RANK_LOCAL blocking _MPI_Scatter("MPI_Scatter",6,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                         );
-blocking _MPI_Reduce_scatter("MPI_Reduce_scatter",7,
+CRITTER_RANK_LOCAL blocking _MPI_Reduce_scatter("MPI_Reduce_scatter",7,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                                );
-blocking _MPI_Alltoall("MPI_Alltoall",8,
+CRITTER_RANK_LOCAL blocking _MPI_Alltoall("MPI_Alltoall",8,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),log2((double)p)*n);}
                          );
-blocking _MPI_Gatherv("MPI_Gatherv",9,
+CRITTER_RANK_LOCAL blocking _MPI_Gatherv("MPI_Gatherv",9,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                         );
-blocking _MPI_Allgatherv("MPI_Allgatherv",10,
+CRITTER_RANK_LOCAL blocking _MPI_Allgatherv("MPI_Allgatherv",10,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                            );
-blocking _MPI_Scatterv("MPI_Scatterv",11,
+CRITTER_RANK_LOCAL blocking _MPI_Scatterv("MPI_Scatterv",11,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                          );
-blocking _MPI_Alltoallv("MPI_Alltoallv",12,
+CRITTER_RANK_LOCAL blocking _MPI_Alltoallv("MPI_Alltoallv",12,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                            return std::pair<double,double>(log2((double)p),log2((double)p)*n);}
                           );
-blocking _MPI_Sendrecv("MPI_Sendrecv",13,
+CRITTER_RANK_LOCAL blocking _MPI_Sendrecv("MPI_Sendrecv",13,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                       );
-blocking _MPI_Sendrecv_replace("MPI_Sendrecv_replace",14,
+CRITTER_RANK_LOCAL blocking _MPI_Sendrecv_replace("MPI_Sendrecv_replace",14,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                               );
-blocking _MPI_Ssend("MPI_Ssend",15,
+CRITTER_RANK_LOCAL blocking _MPI_Ssend("MPI_Ssend",15,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                       );
-blocking _MPI_Send("MPI_Send",16,
+CRITTER_RANK_LOCAL blocking _MPI_Send("MPI_Send",16,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                   );
-blocking _MPI_Recv("MPI_Recv",17,
+CRITTER_RANK_LOCAL blocking _MPI_Recv("MPI_Recv",17,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                   );
-nonblocking _MPI_Isend("MPI_Isend",18,
+CRITTER_RANK_LOCAL nonblocking _MPI_Isend("MPI_Isend",18,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                       );
-nonblocking _MPI_Irecv("MPI_Irecv",19,
+CRITTER_RANK_LOCAL nonblocking _MPI_Irecv("MPI_Irecv",19,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                       );
-nonblocking _MPI_Ibcast("MPI_Ibcast",20,
+CRITTER_RANK_LOCAL nonblocking _MPI_Ibcast("MPI_Ibcast",20,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(2.*log2((double)p),2.*n);}
                        );
-nonblocking _MPI_Iallreduce("MPI_Iallreduce",21,
+CRITTER_RANK_LOCAL nonblocking _MPI_Iallreduce("MPI_Iallreduce",21,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(2.*log2((double)p),2.*n);}
                            );
-nonblocking _MPI_Ireduce("MPI_Ireduce",22,
+CRITTER_RANK_LOCAL nonblocking _MPI_Ireduce("MPI_Ireduce",22,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(2.*log2((double)p),2.*n);}
                         );
-nonblocking _MPI_Igather("MPI_Igather",23,
+CRITTER_RANK_LOCAL nonblocking _MPI_Igather("MPI_Igather",23,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                         );
-nonblocking _MPI_Igatherv("MPI_Igatherv",24,
+CRITTER_RANK_LOCAL nonblocking _MPI_Igatherv("MPI_Igatherv",24,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                          );
-nonblocking _MPI_Iallgather("MPI_Iallgather",25,
+CRITTER_RANK_LOCAL nonblocking _MPI_Iallgather("MPI_Iallgather",25,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                            );
-nonblocking _MPI_Iallgatherv("MPI_Iallgatherv",26,
+CRITTER_RANK_LOCAL nonblocking _MPI_Iallgatherv("MPI_Iallgatherv",26,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                             );
-nonblocking _MPI_Iscatter("MPI_Iscatter",27,
+CRITTER_RANK_LOCAL nonblocking _MPI_Iscatter("MPI_Iscatter",27,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                          );
-nonblocking _MPI_Iscatterv("MPI_Iscatterv",28,
+CRITTER_RANK_LOCAL nonblocking _MPI_Iscatterv("MPI_Iscatterv",28,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                           );
-nonblocking _MPI_Ireduce_scatter("MPI_Ireduce_scatter",29,
+CRITTER_RANK_LOCAL nonblocking _MPI_Ireduce_scatter("MPI_Ireduce_scatter",29,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),n);}
                                 );
-nonblocking _MPI_Ialltoall("MPI_Ialltoall",30,
+CRITTER_RANK_LOCAL nonblocking _MPI_Ialltoall("MPI_Ialltoall",30,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),log2((double)p)*n);}
                           );
-nonblocking _MPI_Ialltoallv("MPI_Ialltoallv",31,
+CRITTER_RANK_LOCAL nonblocking _MPI_Ialltoallv("MPI_Ialltoallv",31,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(log2((double)p),log2((double)p)*n);}
                            );
-blocking _MPI_Bsend("MPI_Bsend",32,
+CRITTER_RANK_LOCAL blocking _MPI_Bsend("MPI_Bsend",32,
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);},
                           [](int64_t n, int p){
                             return std::pair<double,double>(1.,n);}
                       );
 
-comm_tracker* list[list_size] = {
+CRITTER_RANK_LOCAL comm_tracker* list[list_size] = {
         &_MPI_Barrier,
         &_MPI_Bcast,
         &_MPI_Reduce,
@@ -218,9 +217,9 @@ comm_tracker* list[list_size] = {
         &_MPI_Allgatherv,
         &_MPI_Scatterv,
         &_MPI_Alltoallv,
-        &_MPI_Ssend,
         &_MPI_Sendrecv,
         &_MPI_Sendrecv_replace,
+        &_MPI_Ssend,
         &_MPI_Send,
         &_MPI_Recv,
         &_MPI_Isend,
@@ -245,6 +244,7 @@ void comm_tracker::init(){
   this->comp_time   = 0.;
   this->partner1    = -1;
   this->partner2    = -1;
+  this->root        = -1;
 }
 
 void comm_tracker::set_cost_pointers(){
@@ -254,11 +254,11 @@ void comm_tracker::set_cost_pointers(){
   this->my_comm_time             = &volume_costs[volume_costs_idx+2*cost_model_size];
   this->my_synch_time            = &volume_costs[volume_costs_idx+2*cost_model_size+1];
   if (comm_path_select_size>0){
-    size_t critical_path_costs_idx   = num_critical_path_measures+this->tag*comm_path_select_size*num_tracker_critical_path_measures;
-    this->critical_path_wrd_count    = cost_model_size>0 ? &critical_path_costs[critical_path_costs_idx] : &scratch_pad;
-    this->critical_path_msg_count    = cost_model_size>0 ? &critical_path_costs[critical_path_costs_idx+cost_model_size*comm_path_select_size] : &scratch_pad;
-    this->critical_path_comm_time    = &critical_path_costs[critical_path_costs_idx+2*comm_path_select_size*cost_model_size];
-    this->critical_path_synch_time   = &critical_path_costs[critical_path_costs_idx+2*comm_path_select_size*cost_model_size+comm_path_select_size];
+    size_t critical_path_costs_idx   = this->tag*comm_path_select_size*num_tracker_critical_path_measures;
+    this->critical_path_wrd_count    = cost_model_size>0 ? &critical_path_breakdown[critical_path_costs_idx] : &scratch_pad;
+    this->critical_path_msg_count    = cost_model_size>0 ? &critical_path_breakdown[critical_path_costs_idx+cost_model_size*comm_path_select_size] : &scratch_pad;
+    this->critical_path_comm_time    = &critical_path_breakdown[critical_path_costs_idx+2*comm_path_select_size*cost_model_size];
+    this->critical_path_synch_time   = &critical_path_breakdown[critical_path_costs_idx+2*comm_path_select_size*cost_model_size+comm_path_select_size];
   } else{
     this->critical_path_wrd_count    = &scratch_pad;
     this->critical_path_msg_count    = &scratch_pad;
@@ -48,6 +48,8 @@ class comm_tracker{
     int partner1;
     /* \brief partner with which start() was last called */
     int partner2;
+    /* \brief root with which start() was last called (-1 unless a rooted collective) */
+    int root;
     /* \brief nbytes with which start() was last called */
     int64_t nbytes;
     /* \brief process count with which start() was last called */
@@ -106,7 +108,7 @@ public:
     nonblocking(nonblocking const& t);
 };
 
-extern blocking
+extern CRITTER_RANK_LOCAL blocking
          _MPI_Send,
          _MPI_Ssend,
          _MPI_Bsend,
@@ -126,7 +128,7 @@ extern blocking
          _MPI_Allgatherv,
          _MPI_Scatterv,
          _MPI_Alltoallv;
-extern nonblocking
+extern CRITTER_RANK_LOCAL nonblocking
          _MPI_Isend,
          _MPI_Irecv,
          _MPI_Ibcast,
@@ -142,8 +144,7 @@ extern nonblocking
          _MPI_Ialltoall,
          _MPI_Ialltoallv;
 constexpr auto list_size=33;
-extern comm_tracker* list[list_size];
-extern std::map<MPI_Request,nonblocking*> internal_comm_track;
+extern CRITTER_RANK_LOCAL comm_tracker* list[list_size];
 
 }
 }
@@ -0,0 +1,57 @@
+#include "envelope_pool.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+CRITTER_RANK_LOCAL envelope_pool internal_envelope_pool;
+
+envelope_pool::envelope_pool(){
+  this->slab_size = 0;
+  this->slab_idx = 0;
+  this->offset = 0;
+  this->in_use = 0;
+  this->high_water = 0;
+  this->max_high_water[0] = 0;
+  this->max_high_water[1] = 0;
+}
+
+void envelope_pool::init(size_t slab_size){
+  this->slabs.clear();
+  this->slab_size = slab_size;
+  this->slab_idx = 0;
+  this->offset = 0;
+  this->in_use = 0;
+  this->high_water = 0;
+}
+
+void* envelope_pool::allocate_bytes(size_t nbytes){
+  // Every envelope is aligned as strictly as malloc would align it. Slab storage comes from operator new, so slab starts are aligned already.
+  constexpr size_t alignment = alignof(std::max_align_t);
+  nbytes = std::max(nbytes,(size_t)1);
+  nbytes = (nbytes + alignment - 1) & ~(alignment - 1);
+  while ((this->slab_idx < this->slabs.size()) && (this->offset + nbytes > this->slabs[this->slab_idx].size())){
+    this->slab_idx++;
+    this->offset = 0;
+  }
+  if (this->slab_idx == this->slabs.size()){
+    // Oversized requests get a slab of their own size, which is then reused as any other slab
+    this->slabs.push_back(std::vector<char>(std::max(this->slab_size,nbytes)));
+    this->offset = 0;
+  }
+  void* envelope = &this->slabs[this->slab_idx][this->offset];
+  this->offset += nbytes;
+  this->in_use += nbytes;
+  this->high_water = std::max(this->high_water,this->in_use);
+  return envelope;
+}
+
+void envelope_pool::recycle(){
+  this->slab_idx = 0;
+  this->offset = 0;
+  this->in_use = 0;
+}
+
+}
+}
+}
@@ -0,0 +1,45 @@
+#ifndef CRITTER__DECOMPOSITION__CONTAINER__ENVELOPE_POOL_H_
+#define CRITTER__DECOMPOSITION__CONTAINER__ENVELOPE_POOL_H_
+
+#include "../../util/util.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+/* \brief bump allocator for the envelopes posted by nonblocking path propagation; slabs are recycled once all outstanding propagation has completed */
+class envelope_pool{
+  public:
+    envelope_pool();
+    /** \brief release all slabs and set the size of each subsequently created slab */
+    void init(size_t slab_size);
+    /** \brief storage for 'count' objects of type T, valid until the next call to recycle() */
+    template<typename T>
+    T* allocate(size_t count){ return (T*)this->allocate_bytes(count*sizeof(T)); }
+    /** \brief rewind all slabs; invalidates every envelope handed out since the last call */
+    void recycle();
+    /** \brief largest number of bytes handed out between two calls to recycle() */
+    size_t high_water_bytes() const { return this->high_water; }
+    /** \brief number of slabs allocated */
+    size_t slab_count() const { return this->slabs.size(); }
+    /* \brief max over processes of (high_water_bytes(), slab_count()), set by volumetric::collect() */
+    uint64_t max_high_water[2];
+
+  private:
+    void* allocate_bytes(size_t nbytes);
+
+    std::vector<std::vector<char>> slabs;
+    size_t slab_size;
+    size_t slab_idx;
+    size_t offset;
+    size_t in_use;
+    size_t high_water;
+};
+
+extern CRITTER_RANK_LOCAL envelope_pool internal_envelope_pool;
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__CONTAINER__ENVELOPE_POOL_H_*/
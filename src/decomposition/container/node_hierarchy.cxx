@@ -0,0 +1,95 @@
+#include "node_hierarchy.h"
+#include "overhead_counter.h"
+#include "../../util/metadata.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+CRITTER_RANK_LOCAL node_hierarchy internal_node_hierarchy;
+
+node_hierarchy::node_hierarchy(){
+  this->active = false;
+  this->max_bytes = 0;
+  this->node_rank = 0;
+  this->node_size = 1;
+  this->node_comm = MPI_COMM_NULL;
+  this->leader_comm = MPI_COMM_NULL;
+  this->window = MPI_WIN_NULL;
+}
+
+void node_hierarchy::init(size_t max_bytes){
+  assert(!this->active);
+  if (node_aware == 0) return;
+  // Segments are aligned as strictly as malloc would align them, as they hold the payload of any datatype
+  constexpr size_t alignment = alignof(std::max_align_t);
+  this->max_bytes = (std::max(max_bytes,(size_t)1) + alignment - 1) & ~(alignment - 1);
+  int world_rank; MPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
+  PMPI_Comm_split_type(MPI_COMM_WORLD,MPI_COMM_TYPE_SHARED,world_rank,MPI_INFO_NULL,&this->node_comm);
+  MPI_Comm_rank(this->node_comm,&this->node_rank);
+  MPI_Comm_size(this->node_comm,&this->node_size);
+  PMPI_Comm_split(MPI_COMM_WORLD,(this->node_rank == 0) ? 0 : MPI_UNDEFINED,world_rank,&this->leader_comm);
+  // Without any node holding more than one process, the leaders are all processes and the hierarchy would only add synchronization
+  int max_node_size = this->node_size;
+  PMPI_Allreduce(MPI_IN_PLACE,&max_node_size,1,MPI_INT,MPI_MAX,MPI_COMM_WORLD);
+  if (max_node_size == 1){
+    PMPI_Comm_free(&this->node_comm);
+    PMPI_Comm_free(&this->leader_comm);
+    return;
+  }
+  char* base;
+  MPI_Win_allocate_shared((this->node_rank == 0 ? 2 : 1)*this->max_bytes,1,MPI_INFO_NULL,this->node_comm,&base,&this->window);
+  this->segments.resize(this->node_size);
+  for (int i=0; i<this->node_size; i++){
+    MPI_Aint segment_size; int disp_unit;
+    MPI_Win_shared_query(this->window,i,&segment_size,&disp_unit,&this->segments[i]);
+  }
+  // The window stays in a passive-target epoch for its lifetime; accesses are ordered by MPI_Win_sync and barriers over 'node_comm'
+  MPI_Win_lock_all(MPI_MODE_NOCHECK,this->window);
+  this->active = true;
+}
+
+void node_hierarchy::free(){
+  if (!this->active) return;
+  MPI_Win_unlock_all(this->window);
+  MPI_Win_free(&this->window);
+  PMPI_Comm_free(&this->node_comm);
+  if (this->leader_comm != MPI_COMM_NULL){ PMPI_Comm_free(&this->leader_comm); }
+  this->segments.clear();
+  this->active = false;
+}
+
+bool node_hierarchy::applies(MPI_Comm comm, size_t nbytes) const{
+  // Below the threshold, the barriers over each node cost more than the messages they save
+  return this->active && (nbytes >= node_aware_min_bytes) && (nbytes <= this->max_bytes) && get_comm_metadata(comm).spans_world;
+}
+
+void node_hierarchy::allreduce(void* buf, int count, MPI_Datatype t, MPI_Op op, MPI_Comm comm){
+  MPI_Aint lb,extent;
+  MPI_Type_get_extent(t,&lb,&extent);
+  size_t nbytes = count*extent;
+  internal_overhead_counter.message(nbytes);
+  if (!this->applies(comm,nbytes)){
+    PMPI_Allreduce(MPI_IN_PLACE,buf,count,t,op,comm);
+    return;
+  }
+  std::memcpy(this->segments[this->node_rank],buf,nbytes);
+  MPI_Win_sync(this->window);
+  PMPI_Barrier(this->node_comm);
+  MPI_Win_sync(this->window);
+  // The leader writes the reduced payload past its own contribution, so the contributions of the next reduction can be written while others still read it
+  char* result = this->segments[0]+this->max_bytes;
+  if (this->node_rank == 0){
+    std::memcpy(result,this->segments[this->node_size-1],nbytes);
+    for (int i=this->node_size-2; i>=0; i--){ PMPI_Reduce_local(this->segments[i],result,count,t,op); }
+    PMPI_Allreduce(MPI_IN_PLACE,result,count,t,op,this->leader_comm);
+  }
+  MPI_Win_sync(this->window);
+  PMPI_Barrier(this->node_comm);
+  MPI_Win_sync(this->window);
+  std::memcpy(buf,result,nbytes);
+}
+
+}
+}
+}
@@ -0,0 +1,43 @@
+#ifndef CRITTER__DECOMPOSITION__CONTAINER__NODE_HIERARCHY_H_
+#define CRITTER__DECOMPOSITION__CONTAINER__NODE_HIERARCHY_H_
+
+#include "../../util/util.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+/* \brief node-local and node-leader communicators of MPI_COMM_WORLD, with a shared-memory window through which the processes of each node combine
+          their contributions to a reduction before only the node leaders communicate over the network */
+class node_hierarchy{
+  public:
+    node_hierarchy();
+    /** \brief split MPI_COMM_WORLD into nodes and allocate a window holding payloads of up to 'max_bytes' per process; collective over MPI_COMM_WORLD */
+    void init(size_t max_bytes);
+    /** \brief release the window and communicators created by init(); collective over MPI_COMM_WORLD */
+    void free();
+    /** \brief true if a reduction of 'nbytes' over 'comm' is performed through the node hierarchy, which requires at least CRITTER_NODE_AWARE_MIN_BYTES;
+     *         the same on all processes of 'comm' */
+    bool applies(MPI_Comm comm, size_t nbytes) const;
+    /** \brief equivalent to PMPI_Allreduce with MPI_IN_PLACE; 'op' is applied in the same order on all processes, so it need not be commutative */
+    void allreduce(void* buf, int count, MPI_Datatype t, MPI_Op op, MPI_Comm comm);
+
+  private:
+    bool active;
+    size_t max_bytes;
+    int node_rank;
+    int node_size;
+    MPI_Comm node_comm;
+    MPI_Comm leader_comm;
+    MPI_Win window;
+    // Segment of each process on the node, followed in the leader's segment by the reduced payload
+    std::vector<char*> segments;
+};
+
+extern CRITTER_RANK_LOCAL node_hierarchy internal_node_hierarchy;
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__CONTAINER__NODE_HIERARCHY_H_*/
@@ -0,0 +1,156 @@
+#include "overhead_counter.h"
+#include "comm_tracker.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+CRITTER_RANK_LOCAL overhead_counter internal_overhead_counter;
+
+overhead_counter::overhead_counter(){
+  this->reset();
+}
+
+void overhead_counter::enter(int phase, int routine){
+  double now = MPI_Wtime();
+  assert(this->depth < 8);
+  if (this->depth > 0){ this->phase_time[this->phase_stack[this->depth-1]] += now - this->mark; }
+  else{
+    this->routine = routine;
+    this->entry_time = now;
+    this->entry_discount = 0;
+  }
+  this->phase_stack[this->depth++] = phase;
+  this->mark = now;
+}
+
+void overhead_counter::exit(){
+  double now = MPI_Wtime();
+  assert(this->depth > 0);
+  this->phase_time[this->phase_stack[--this->depth]] += now - this->mark;
+  this->mark = now;
+  if ((this->depth == 0) && (this->routine >= 0)){ this->routine_time[this->routine] += now - this->entry_time - this->entry_discount; }
+}
+
+void overhead_counter::discount(double seconds){
+  assert(this->depth > 0);
+  this->phase_time[this->phase_stack[this->depth-1]] -= seconds;
+  this->entry_discount += seconds;
+}
+
+void overhead_counter::message(size_t nbytes){
+  if (this->depth == 0) return;
+  this->phase_messages[this->phase_stack[this->depth-1]]++;
+  this->phase_bytes[this->phase_stack[this->depth-1]] += nbytes;
+  if (this->routine >= 0){
+    this->routine_messages[this->routine]++;
+    this->routine_bytes[this->routine] += nbytes;
+  }
+}
+
+double overhead_counter::total_time() const{
+  double total = 0;
+  for (int i=0; i<num_overhead_phases; i++){
+    if (i != overhead_collect) total += this->phase_time[i];
+  }
+  return total;
+}
+
+void overhead_counter::reset(){
+  this->depth = 0;
+  this->routine = -1;
+  this->mark = 0;
+  this->entry_time = 0;
+  this->entry_discount = 0;
+  this->correction = 0;
+  for (int i=0; i<num_overhead_phases; i++){
+    this->phase_time[i] = 0;
+    this->phase_messages[i] = 0;
+    this->phase_bytes[i] = 0;
+  }
+  for (int i=0; i<num_overhead_routines; i++){
+    this->routine_time[i] = 0;
+    this->routine_messages[i] = 0;
+    this->routine_bytes[i] = 0;
+  }
+}
+
+void overhead_counter::collect(MPI_Comm comm){
+  if (self_overhead == 0) return;
+  int rank,size;
+  MPI_Comm_rank(comm,&rank);
+  MPI_Comm_size(comm,&size);
+  // The times are reduced with MPI_MAX, and then summed along with all other counts and the total time of each process
+  size_t time_count = num_overhead_phases+num_overhead_routines;
+  size_t sum_count = time_count+2*num_overhead_phases+2*num_overhead_routines+1;
+  std::vector<double> local(sum_count), max_times(rank == 0 ? time_count : 0), sums(rank == 0 ? sum_count : 0);
+  std::memcpy(&local[0],this->phase_time,num_overhead_phases*sizeof(double));
+  std::memcpy(&local[num_overhead_phases],this->routine_time,num_overhead_routines*sizeof(double));
+  double* counts = &local[time_count];
+  std::memcpy(counts,this->phase_messages,num_overhead_phases*sizeof(double));
+  std::memcpy(counts+num_overhead_phases,this->phase_bytes,num_overhead_phases*sizeof(double));
+  std::memcpy(counts+2*num_overhead_phases,this->routine_messages,num_overhead_routines*sizeof(double));
+  std::memcpy(counts+2*num_overhead_phases+num_overhead_routines,this->routine_bytes,num_overhead_routines*sizeof(double));
+  local[sum_count-1] = this->total_time();
+  PMPI_Reduce(&local[0],max_times.data(),time_count,MPI_DOUBLE,MPI_MAX,0,comm);
+  PMPI_Reduce(&local[0],sums.data(),sum_count,MPI_DOUBLE,MPI_SUM,0,comm);
+  if (rank != 0) return;
+
+  for (auto& it : sums){ it /= size; }
+  double const* mean_counts = &sums[time_count];
+  this->phase_counts.resize(4*num_overhead_phases);
+  for (int i=0; i<num_overhead_phases; i++){
+    this->phase_counts[4*i]   = max_times[i];
+    this->phase_counts[4*i+1] = sums[i];
+    this->phase_counts[4*i+2] = mean_counts[i];
+    this->phase_counts[4*i+3] = mean_counts[num_overhead_phases+i];
+  }
+  this->routine_counts.resize(4*num_overhead_routines);
+  for (int i=0; i<num_overhead_routines; i++){
+    this->routine_counts[4*i]   = max_times[num_overhead_phases+i];
+    this->routine_counts[4*i+1] = sums[num_overhead_phases+i];
+    this->routine_counts[4*i+2] = mean_counts[2*num_overhead_phases+i];
+    this->routine_counts[4*i+3] = mean_counts[2*num_overhead_phases+num_overhead_routines+i];
+  }
+  if (self_overhead < 2) return;
+  // Time spent within critter is excluded from each process's own measures, but it delays the processes that communicate with it,
+  //   and so appears in their idle and communication time, and in the communication time along the critical path. The mean time
+  //   a process spends within critter estimates how much of it any one process (or path) absorbs, and is subtracted from each.
+  this->correction = sums[sum_count-1];
+  double removed = std::min(this->correction,critical_path_costs[num_critical_path_measures-4]);
+  critical_path_costs[num_critical_path_measures-4] -= removed;
+  critical_path_costs[num_critical_path_measures-1] -= removed;
+  this->subtract(&max_per_process_costs[0],num_per_process_measures,this->correction);
+  this->subtract(&volume_costs[0],num_volume_measures,this->correction);
+  // The decomposition of each path by routine, and of the corresponding per-process measures, absorbs the same overhead
+  size_t block_size = num_tracker_per_process_measures*list_size+2;
+  for (size_t i=0; i<comm_path_select_size; i++){
+    this->subtract_decomposition(&critical_path_breakdown[critical_path_breakdown_size-2*comm_path_select_size+i],
+                                 &critical_path_breakdown[2*comm_path_select_size*cost_model_size+i],comm_path_select_size*num_tracker_critical_path_measures,this->correction);
+    double* block = &max_per_process_costs[num_per_process_measures+i*block_size];
+    this->subtract_decomposition(&block[block_size-1],&block[num_tracker_per_process_measures-2],num_tracker_per_process_measures,this->correction);
+  }
+}
+
+void overhead_counter::subtract(double* measures, size_t measure_count, double overhead){
+  double removed_idle = std::min(overhead,measures[measure_count-5]);
+  double removed_comm = std::min(overhead-removed_idle,measures[measure_count-4]);
+  measures[measure_count-5] -= removed_idle;
+  measures[measure_count-4] -= removed_comm;
+  measures[measure_count-1] -= removed_idle+removed_comm;
+}
+
+void overhead_counter::subtract_decomposition(double* idle_time, double* comm_times, size_t stride, double overhead){
+  // As in subtract, idle time absorbs the overhead first; the rest is taken from the communication time of each routine (each 'stride' apart) in proportion to it
+  double removed_idle = std::min(overhead,*idle_time);
+  *idle_time -= removed_idle;
+  double comm_time = 0;
+  for (int i=0; i<list_size; i++){ comm_time += comm_times[i*stride]; }
+  if (comm_time <= 0) return;
+  double kept = 1. - std::min(overhead-removed_idle,comm_time)/comm_time;
+  for (int i=0; i<list_size; i++){ comm_times[i*stride] *= kept; }
+}
+
+}
+}
+}
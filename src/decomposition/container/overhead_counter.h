@@ -0,0 +1,81 @@
+#ifndef CRITTER__DECOMPOSITION__CONTAINER__OVERHEAD_COUNTER_H_
+#define CRITTER__DECOMPOSITION__CONTAINER__OVERHEAD_COUNTER_H_
+
+#include "../../util/util.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+/* \brief phases of the work critter does on its own behalf, each timed exclusive of the phases nested within it */
+enum overhead_phase{
+  overhead_initiate=0,
+  overhead_complete,
+  overhead_propagate,
+  overhead_propagate_symbols,
+  overhead_path_update,
+  overhead_collect,
+  num_overhead_phases
+};
+
+/* \brief routines beyond those in 'list' whose interception does work on critter's behalf, indexed after the tags of 'list' */
+enum overhead_routine{
+  overhead_wait=33,
+  overhead_waitany,
+  overhead_waitsome,
+  overhead_waitall,
+  num_overhead_routines
+};
+
+/* \brief counts the time, messages and bytes critter spends on its own behalf, by phase and by intercepted routine */
+class overhead_counter{
+  public:
+    overhead_counter();
+    /** \brief start timing 'phase', pausing the phase it is nested within; 'routine' (a tag, or an overhead_routine) is charged if no phase is underway */
+    void enter(int phase, int routine=-1);
+    /** \brief stop timing the innermost phase and resume the one it is nested within */
+    void exit();
+    /** \brief exclude 'seconds' spent within the innermost phase that belong to the application (e.g. idle time spent within a barrier) */
+    void discount(double seconds);
+    /** \brief count an internal message of 'nbytes' sent within the innermost phase */
+    void message(size_t nbytes);
+    /** \brief seconds spent within all phases since the last reset, other than collect */
+    double total_time() const;
+    /** \brief drop all counts */
+    void reset();
+    /** \brief reduce the max and the sum of each count onto rank 0 of 'comm' and, with CRITTER_SELF_OVERHEAD=2, subtract
+               the estimated overhead from the reported measures; collective over 'comm', which must span all processes */
+    void collect(MPI_Comm comm);
+
+    /* \brief per phase: max time, mean time, mean messages, mean bytes (valid on rank 0 after collect()) */
+    std::vector<double> phase_counts;
+    /* \brief per routine: max time, mean time, mean messages, mean bytes (valid on rank 0 after collect()) */
+    std::vector<double> routine_counts;
+    /* \brief time subtracted from the reported measures of each process (valid on rank 0 after collect()) */
+    double correction;
+
+  private:
+    void subtract(double* measures, size_t measure_count, double overhead);
+    void subtract_decomposition(double* idle_time, double* comm_times, size_t stride, double overhead);
+
+    int depth;
+    int routine;
+    int phase_stack[8];
+    double mark;
+    double entry_time;
+    double entry_discount;
+    double phase_time[num_overhead_phases];
+    double phase_messages[num_overhead_phases];
+    double phase_bytes[num_overhead_phases];
+    double routine_time[num_overhead_routines];
+    double routine_messages[num_overhead_routines];
+    double routine_bytes[num_overhead_routines];
+};
+
+extern CRITTER_RANK_LOCAL overhead_counter internal_overhead_counter;
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__CONTAINER__OVERHEAD_COUNTER_H_*/
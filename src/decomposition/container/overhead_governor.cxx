@@ -0,0 +1,88 @@
+#include "overhead_governor.h"
+#include "overhead_counter.h"
+#include "../../util/metadata.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+// Number of blocking collectives over all processes between two evaluations of the overhead
+static const size_t governor_interval = 32;
+// Sample rate (CRITTER_SAMPLE_RATE) imposed by the last degradation step
+static const size_t governor_sample_rate = 16;
+
+CRITTER_RANK_LOCAL overhead_governor internal_overhead_governor;
+
+overhead_governor::overhead_governor(){
+  this->level = 0;
+  this->due_count = 0;
+  this->start_time = 0;
+  this->window_start = 0;
+  this->window_overhead = 0;
+  this->saved_track_p2p_idle = 1;
+  this->saved_sample_rate = 1;
+}
+
+void overhead_governor::init(){
+  this->saved_track_p2p_idle = track_p2p_idle;
+  this->saved_sample_rate = sample_rate;
+}
+
+void overhead_governor::reset(){
+  track_p2p_idle = this->saved_track_p2p_idle;
+  sample_rate = this->saved_sample_rate;
+  this->level = 0;
+  this->due_count = 0;
+  this->start_time = MPI_Wtime();
+  this->window_start = this->start_time;
+  this->window_overhead = 0;
+  this->decisions.clear();
+}
+
+bool overhead_governor::is_due(MPI_Comm comm){
+  if ((max_overhead == 0) || (this->level == 3) || !get_comm_metadata(comm).spans_world) return false;
+  return (++this->due_count % governor_interval) == 0;
+}
+
+void overhead_governor::update(MPI_Comm comm, bool quiescent){
+  double now = MPI_Wtime();
+  double overhead = internal_overhead_counter.total_time();
+  double window[2] = {(overhead-this->window_overhead)/std::max(now-this->window_start,1.e-9), quiescent ? 0. : 1.};
+  PMPI_Allreduce(MPI_IN_PLACE,window,2,MPI_DOUBLE,MPI_MAX,comm);
+  internal_overhead_counter.message(2*sizeof(double));
+  // A window that exceeds the budget while some process is not quiescent is extended until all are
+  if ((window[0] > max_overhead) && (window[1] > 0)) return;
+  this->window_start = now;
+  this->window_overhead = overhead;
+  if (window[0] <= max_overhead) return;
+  // Steps that would change nothing (e.g. dropping symbol propagation when no paths are decomposed by symbol) are skipped
+  while ((this->level < 3) && !this->apply(this->level+1)) { this->level++; }
+  if (this->level < 3){
+    this->level++;
+    this->decisions.push_back(overhead_decision{this->level,window[0],now-this->start_time});
+  }
+}
+
+bool overhead_governor::apply(int level){
+  switch (level){
+    case 1:
+      return symbol_path_select_size>0;
+    case 2:
+      if (track_p2p_idle == 0) return false;
+      track_p2p_idle = 0;
+      return true;
+    case 3:
+      if (sample_rate >= governor_sample_rate) return false;
+      sample_rate = governor_sample_rate;
+      return true;
+  }
+  return false;
+}
+
+bool overhead_governor::drops_symbols() const{
+  return this->level >= 1;
+}
+
+}
+}
+}
@@ -0,0 +1,58 @@
+#ifndef CRITTER__DECOMPOSITION__CONTAINER__OVERHEAD_GOVERNOR_H_
+#define CRITTER__DECOMPOSITION__CONTAINER__OVERHEAD_GOVERNOR_H_
+
+#include "../../util/util.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+/* \brief a step taken by the overhead governor, recorded for the report */
+struct overhead_decision{
+  /* \brief degradation level after the step: 1 drops symbol propagation, 2 drops p2p idle tracking, 3 samples collectives */
+  int level;
+  /* \brief largest fraction of time any process spent within critter over the window that triggered the step */
+  double overhead;
+  /* \brief time since critter::start() at which the step was taken */
+  double time;
+};
+
+/* \brief compares the time spent within critter (as counted by 'internal_overhead_counter') to the application time, and degrades what critter propagates whenever
+          the fraction over a window of collectives exceeds CRITTER_MAX_OVERHEAD */
+class overhead_governor{
+  public:
+    overhead_governor();
+    /** \brief save the settings that a degradation overrides; called once the environment has been read */
+    void init();
+    /** \brief restore the saved settings and start a new measurement window */
+    void reset();
+    /** \brief count a blocking collective over 'comm' and return true if the governor should evaluate the overhead at it; the same on all processes */
+    bool is_due(MPI_Comm comm);
+    /** \brief agree on the overhead of the last window and degrade if it exceeds the budget; 'quiescent' is false if this process holds path data or
+               requests in flight, in which case no process degrades until the next window; collective over 'comm', which must span all processes */
+    void update(MPI_Comm comm, bool quiescent);
+    /** \brief true if symbol data is no longer propagated */
+    bool drops_symbols() const;
+
+    /* \brief steps taken since the last reset */
+    std::vector<overhead_decision> decisions;
+
+  private:
+    bool apply(int level);
+
+    int level;
+    size_t due_count;
+    double start_time;
+    double window_start;
+    double window_overhead;
+    size_t saved_track_p2p_idle;
+    size_t saved_sample_rate;
+};
+
+extern CRITTER_RANK_LOCAL overhead_governor internal_overhead_governor;
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__CONTAINER__OVERHEAD_GOVERNOR_H_*/
@@ -0,0 +1,68 @@
+#include "path_sampler.h"
+#include "../../util/metadata.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+CRITTER_RANK_LOCAL path_sampler internal_path_sampler;
+
+path_sampler::path_sampler(){
+  this->sampled_count = 0;
+  this->skipped_count = 0;
+}
+
+bool path_sampler::select(MPI_Comm comm){
+  if (sample_rate == 1) return true;
+  // The first collective over each communicator is always sampled, so that skipped collectives are preceded by at least one observation
+  bool is_sampled = (get_comm_metadata(comm).collective_count++ % sample_rate) == 0;
+  if (!is_sampled) this->skipped_count++;
+  return is_sampled;
+}
+
+void path_sampler::start(double const* path_data){
+  if (sample_rate == 1) return;
+  this->local_measures.assign(path_data,path_data+num_critical_path_measures);
+}
+
+void path_sampler::stop(double const* path_data){
+  if (sample_rate == 1) return;
+  this->growth_sum.resize(num_critical_path_measures,0.);
+  this->growth_square_sum.resize(num_critical_path_measures,0.);
+  for (size_t i=0; i<num_critical_path_measures; i++){
+    double growth = path_data[i] - this->local_measures[i];
+    this->growth_sum[i] += growth;
+    this->growth_square_sum[i] += growth*growth;
+  }
+  this->sampled_count++;
+}
+
+void path_sampler::reset(){
+  this->sampled_count = 0;
+  this->skipped_count = 0;
+  this->growth_sum.clear();
+  this->growth_square_sum.clear();
+}
+
+void path_sampler::collect(MPI_Comm comm){
+  if (sample_rate == 1) return;
+  // Each skipped propagation is assumed to grow a measure by an amount drawn from the same distribution as the growth observed in sampled propagations.
+  //   As the latter also merges the growth accumulated since the previous sample, the bound is conservative. The bound combines the variance of the
+  //   skipped growth with the standard error of its estimated mean, and the largest bound of any process is reported.
+  std::vector<double> local_bound(num_critical_path_measures,0.);
+  double k = this->sampled_count;
+  double n = this->skipped_count;
+  if (k > 0){
+    for (size_t i=0; i<num_critical_path_measures; i++){
+      double mean = this->growth_sum[i]/k;
+      double variance = (k > 1) ? std::max(0.,(this->growth_square_sum[i]-k*mean*mean)/(k-1)) : 0.;
+      local_bound[i] = n*mean + 1.96*std::sqrt(n*variance + n*n*variance/k);
+    }
+  }
+  this->bound.resize(num_critical_path_measures);
+  PMPI_Reduce(&local_bound[0],&this->bound[0],num_critical_path_measures,MPI_DOUBLE,MPI_MAX,0,comm);
+}
+
+}
+}
+}
@@ -0,0 +1,43 @@
+#ifndef CRITTER__DECOMPOSITION__CONTAINER__PATH_SAMPLER_H_
+#define CRITTER__DECOMPOSITION__CONTAINER__PATH_SAMPLER_H_
+
+#include "../../util/util.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+/* \brief selects the collectives that propagate path data when only one in every 'sample_rate' collectives over a communicator does (CRITTER_SAMPLE_RATE),
+          and bounds the growth of the critical path measures that the skipped collectives would have contributed */
+class path_sampler{
+  public:
+    path_sampler();
+    /** \brief count a collective over 'comm' and return true if it propagates path data; the same on all processes of 'comm' */
+    bool select(MPI_Comm comm);
+    /** \brief save the critical path measures of 'path_data' before a sampled propagation */
+    void start(double const* path_data);
+    /** \brief record the growth of the critical path measures of 'path_data' by the sampled propagation that followed start() */
+    void stop(double const* path_data);
+    /** \brief drop all counts and recorded growth */
+    void reset();
+    /** \brief reduce the upper confidence bound of each critical path measure onto rank 0 of 'comm'; collective over 'comm' */
+    void collect(MPI_Comm comm);
+
+    /* \brief amount by which each critical path measure may fall short, at 95% confidence, due to skipped propagations (valid on rank 0 after collect()) */
+    std::vector<double> bound;
+
+  private:
+    size_t sampled_count;
+    size_t skipped_count;
+    std::vector<double> local_measures;
+    std::vector<double> growth_sum;
+    std::vector<double> growth_square_sum;
+};
+
+extern CRITTER_RANK_LOCAL path_sampler internal_path_sampler;
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__CONTAINER__PATH_SAMPLER_H_*/
@@ -0,0 +1,90 @@
+#include "request_table.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+CRITTER_RANK_LOCAL request_table internal_comm_table;
+
+request_table::request_table(){
+  this->mask = 0;
+  this->count = 0;
+}
+
+void request_table::init(size_t capacity){
+  // Keep the load factor at or below 1/2 so that probe sequences stay short
+  size_t table_size = 16;
+  while (table_size < 2*capacity) table_size *= 2;
+  this->slots.assign(table_size,request_slot());
+  for (auto& slot : this->slots) slot.is_occupied = false;
+  this->mask = table_size-1;
+  this->count = 0;
+}
+
+size_t request_table::home(MPI_Request request) const{
+  // MPI_Request is an int in some implementations and a pointer in others
+  uint64_t key = 0;
+  std::memcpy(&key,&request,std::min(sizeof(key),sizeof(request)));
+  key *= 0x9E3779B97F4A7C15ULL;
+  return (size_t)(key >> 32) & this->mask;
+}
+
+void request_table::grow(){
+  std::vector<request_slot> old_slots;
+  old_slots.swap(this->slots);
+  this->init(old_slots.size());
+  for (auto& old_slot : old_slots){
+    if (!old_slot.is_occupied) continue;
+    *this->insert(old_slot.request) = old_slot;
+  }
+}
+
+request_slot* request_table::insert(MPI_Request request){
+  if (this->slots.size() == 0) this->init(512);
+  else if (2*(this->count+1) > this->slots.size()) this->grow();
+  size_t idx = this->home(request);
+  while (this->slots[idx].is_occupied){ idx = (idx+1) & this->mask; }
+  this->slots[idx].request = request;
+  this->slots[idx].is_occupied = true;
+  this->count++;
+  return &this->slots[idx];
+}
+
+request_slot* request_table::find(MPI_Request request){
+  if (this->count == 0) return nullptr;
+  request_slot* oldest = nullptr;
+  size_t idx = this->home(request);
+  while (this->slots[idx].is_occupied){
+    if ((this->slots[idx].request == request) && ((oldest == nullptr) || (this->slots[idx].id < oldest->id))){
+      oldest = &this->slots[idx];
+    }
+    idx = (idx+1) & this->mask;
+  }
+  return oldest;
+}
+
+void request_table::erase(request_slot* slot){
+  size_t hole = slot - &this->slots[0];
+  assert(hole < this->slots.size() && this->slots[hole].is_occupied);
+  // Backward-shift deletion: pull later members of the probe run into the hole so that lookups never need tombstones
+  size_t idx = (hole+1) & this->mask;
+  while (this->slots[idx].is_occupied){
+    size_t idx_home = this->home(this->slots[idx].request);
+    if (((idx - idx_home) & this->mask) >= ((idx - hole) & this->mask)){
+      this->slots[hole] = this->slots[idx];
+      hole = idx;
+    }
+    idx = (idx+1) & this->mask;
+  }
+  this->slots[hole].is_occupied = false;
+  this->count--;
+}
+
+void request_table::clear(){
+  for (auto& slot : this->slots) slot.is_occupied = false;
+  this->count = 0;
+}
+
+}
+}
+}
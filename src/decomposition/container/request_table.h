@@ -0,0 +1,77 @@
+#ifndef CRITTER__DECOMPOSITION__CONTAINER__REQUEST_TABLE_H_
+#define CRITTER__DECOMPOSITION__CONTAINER__REQUEST_TABLE_H_
+
+#include "comm_tracker.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+/* \brief state saved by a nonblocking routine for use in the corresponding completion routine */
+struct request_slot{
+  /* \brief request handle returned by the MPI implementation */
+  MPI_Request request;
+  /* \brief cm with which the request was posted */
+  MPI_Comm comm;
+  /* \brief tracker of the MPI routine that posted the request */
+  nonblocking* track;
+  /* \brief nbytes with which the request was posted */
+  int64_t nbytes;
+  /* \brief partner with which the request was posted (-1 for collectives, might be MPI_ANY_SOURCE) */
+  int partner;
+  /* \brief root with which the request was posted (-1 unless a rooted collective) */
+  int root;
+  /* \brief process count with which the request was posted */
+  int comm_size;
+  /* \brief path data piggybacked on the user message (nullptr unless CRITTER_PIGGYBACK_P2P=1) */
+  char* payload;
+  /* \brief datatype wrapping 'payload' together with the user buffer */
+  MPI_Datatype payload_type;
+  /* \brief datatype with which the request was posted */
+  MPI_Datatype type;
+  /* \brief event id, increases monotonically across posted requests */
+  int id;
+  /* \brief true if the request propagates path data upon completion (false only for collectives skipped with CRITTER_SAMPLE_RATE>1) */
+  bool is_sampled;
+  /* \brief is_sender bool with which the request was posted */
+  bool is_sender;
+  /* \brief true if this slot holds an outstanding request */
+  bool is_occupied;
+};
+
+/* \brief open-addressing (linear probing) table of outstanding nonblocking requests keyed by request handle */
+class request_table{
+  public:
+    request_table();
+    /** \brief (re)allocate an empty table with room for at least 'capacity' outstanding requests */
+    void init(size_t capacity);
+    /** \brief claim a slot for 'request'; the caller fills in the remaining members */
+    request_slot* insert(MPI_Request request);
+    /**
+     * \brief find the oldest outstanding slot for 'request', or nullptr.
+     *        Some MPI implementations return one shared handle for all requests that complete immediately,
+     *        so handles are not unique and we hand out matching slots in the order in which they were posted.
+     */
+    request_slot* find(MPI_Request request);
+    /** \brief release 'slot'; invalidates pointers to other slots */
+    void erase(request_slot* slot);
+    /** \brief number of outstanding requests */
+    size_t size() const { return this->count; }
+    void clear();
+
+  private:
+    size_t home(MPI_Request request) const;
+    void grow();
+
+    std::vector<request_slot> slots;
+    size_t mask;
+    size_t count;
+};
+
+extern CRITTER_RANK_LOCAL request_table internal_comm_table;
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__CONTAINER__REQUEST_TABLE_H_*/
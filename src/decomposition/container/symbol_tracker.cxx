@@ -1,28 +1,146 @@
 #include "symbol_tracker.h"
+#include "../../util/symbol_registry.h"
+#include "../../util/metadata.h"
 
 namespace critter{
 namespace internal{
 namespace decomposition{
 
 // Global namespace variable 'symbol_timers' must be defined here, rather than in src/util.cxx with the rest, to avoid circular dependence between this file and src/util.h
-std::unordered_map<std::string,symbol_tracker> symbol_timers;
+CRITTER_RANK_LOCAL std::vector<symbol_tracker> symbol_timers;
+// Indexed by registry id, stores the index into 'symbol_timers' of each symbol, or -1 if it has no tracker
+static CRITTER_RANK_LOCAL std::vector<int> symbol_index;
 
-symbol_tracker::symbol_tracker(std::string name_){
-  assert(name_.size() <= max_timer_name_length);
-  assert(symbol_timers.size() < max_num_symbols);
-  this->name = std::move(name_);
+// Number of symbols the local symbol timer pads can hold
+static CRITTER_RANK_LOCAL size_t symbol_capacity = 0;
+
+void reserve_symbols(size_t count){
+  if (count <= symbol_capacity) return;
+  symbol_capacity = std::max(count,std::max((size_t)16,2*symbol_capacity));
+  size_t cp_stride = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1);
+  size_t pp_stride = pp_symbol_class_count*num_per_process_measures+1;
+  size_t vol_stride = vol_symbol_class_count*num_volume_measures+1;
+  // Note: we use 'num_per_process_measures' rather than 'num_critical_path_measures' for specifying the
+  //   length of 'symbol_timer_pad_*_cp' because we want to track idle time contribution of each symbol along a path.
+  symbol_timer_pad_local_cp.resize(cp_stride*symbol_capacity,0.);
+  symbol_timer_pad_global_cp.resize(cp_stride*symbol_capacity,0.);
+  symbol_timer_pad_local_pp.resize(pp_stride*symbol_capacity,0.);
+  symbol_timer_pad_global_pp.resize(pp_stride*symbol_capacity,0.);
+  symbol_timer_pad_local_vol.resize(vol_stride*symbol_capacity,0.);
+  // 'symbol_pad_cp', 'symbol_len_pad_cp', and 'symbol_id_pad_cp' are a factor 'symbol_path_select_size' larger because collectives reduce the data of one root per path.
+  //   The character pad is sized assuming names of typical length; it grows further wherever longer names are received.
+  //   The message pads used for p2p grow as messages are packed or received.
+  reserve_pad(symbol_len_pad_cp,symbol_path_select_size*symbol_capacity);
+  reserve_pad(symbol_id_pad_cp,symbol_path_select_size*symbol_capacity);
+  reserve_pad(symbol_pad_cp,symbol_path_select_size*max_timer_name_length*symbol_capacity);
+  // The local pads may have moved
+  for (auto& it : symbol_timers){ it.rebase(); }
+}
+
+int get_symbol_index(int id){
+  if (id >= symbol_index.size()){ symbol_index.resize(id+1,-1); }
+  if (symbol_index[id] < 0){
+    reserve_symbols(symbol_timers.size()+1);
+    symbol_index[id] = symbol_timers.size();
+    symbol_timers.push_back(symbol_tracker(id,symbol_timers.size()));
+  }
+  return symbol_index[id];
+}
+
+int get_global_symbol_index(uint64_t global_id){
+  return get_symbol_index(find_symbol(global_id));
+}
+
+void pack_symbol_ids(uint64_t* ids){
+  for (size_t i=0; i<symbol_timers.size(); i++){ ids[i] = get_symbol_global_id(symbol_timers[i].id); }
+}
+
+size_t pack_symbol_header(MPI_Comm comm, int partner, int* header){
+  comm_metadata& metadata = get_comm_metadata(comm);
+  int& names_sent = (partner == -1) ? metadata.symbol_names_broadcast : metadata.symbol_names_sent[partner];
+  size_t first_name = names_sent;
+  header[0] = symbol_timers.size();
+  header[1] = get_symbol_count() - first_name;
+  header[2] = get_symbol_name_chars(first_name);
+  names_sent = get_symbol_count();
+  return first_name;
+}
+
+// A symbol message is laid out as its header (4 ints), the global ids, the measures, and the lengths and characters of the new names.
+//   The 8-byte fields follow the 16-byte header, so every field is naturally aligned within a buffer aligned as malloc would align it.
+size_t get_symbol_message_size(int const* header, size_t data_len){
+  return 4*sizeof(int) + header[0]*sizeof(uint64_t) + data_len*sizeof(double) + header[1]*sizeof(int) + header[2];
+}
+
+void pack_symbol_message(char* buffer, int const* header, size_t first_name, double const* data, size_t data_len){
+  int* message_header = (int*)buffer;
+  message_header[0] = header[0]; message_header[1] = header[1]; message_header[2] = header[2]; message_header[3] = data_len;
+  uint64_t* ids = (uint64_t*)(buffer + 4*sizeof(int));
+  pack_symbol_ids(ids);
+  double* message_data = (double*)(ids + header[0]);
+  std::memcpy(message_data,data,data_len*sizeof(double));
+  int* lengths = (int*)(message_data + data_len);
+  pack_symbol_names(first_name,lengths,(char*)(lengths + header[1]));
+}
+
+symbol_message unpack_symbol_message(char* buffer){
+  symbol_message message;
+  message.header = (int*)buffer;
+  message.ids = (uint64_t*)(buffer + 4*sizeof(int));
+  message.data = (double*)(message.ids + message.header[0]);
+  message.lengths = (int*)(message.data + message.header[3]);
+  message.chars = (char*)(message.lengths + message.header[1]);
+  if (message.header[1]>0){ unpack_symbol_names(message.header[1],message.lengths,message.chars); }
+  return message;
+}
+
+size_t probe_symbol_message(MPI_Comm comm, int partner, int tag, MPI_Message* handle){
+  MPI_Status status; int message_size;
+  PMPI_Mprobe(partner,tag,comm,handle,&status);
+  PMPI_Get_count(&status,MPI_BYTE,&message_size);
+  return message_size;
+}
+
+symbol_message receive_symbol_message(MPI_Comm comm, int partner, int tag, std::vector<char>& pad){
+  MPI_Message handle;
+  size_t message_size = probe_symbol_message(comm,partner,tag,&handle);
+  reserve_pad(pad,message_size);
+  PMPI_Mrecv(&pad[0],message_size,MPI_BYTE,&handle,MPI_STATUS_IGNORE);
+  return unpack_symbol_message(&pad[0]);
+}
+
+void clear_symbols(){
+  for (auto& it : symbol_timers){ symbol_index[it.id] = -1; }
+  symbol_timers.clear();
+}
+
+symbol_tracker::symbol_tracker(int id_, int index_){
+  this->name = get_symbol_name(id_);
+  this->id = id_;
+  this->index = index_;
   this->cp_exclusive_contributions.resize(symbol_path_select_size,nullptr);
   this->cp_exclusive_measure.resize(symbol_path_select_size,nullptr);
   this->cp_numcalls.resize(symbol_path_select_size,nullptr);
   this->cp_incl_measure.resize(symbol_path_select_size,nullptr);
   this->cp_excl_measure.resize(symbol_path_select_size,nullptr);
+  this->rebase();
 
+  size_t cp_offset = this->index*symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1);
+  size_t pp_offset = this->index*(pp_symbol_class_count*num_per_process_measures+1);
+  size_t vol_offset = this->index*(vol_symbol_class_count*num_volume_measures+1);
+  memset(&symbol_timer_pad_local_cp[cp_offset],0,sizeof(double)*symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1));
+  memset(&symbol_timer_pad_local_pp[pp_offset],0,sizeof(double)*(pp_symbol_class_count*num_per_process_measures+1));
+  memset(&symbol_timer_pad_local_vol[vol_offset],0,sizeof(double)*(vol_symbol_class_count*num_volume_measures+1));
+  this->has_been_processed = false;
+}
+
+void symbol_tracker::rebase(){
   // Note that we use 'num_per_process_measures' instead of 'num_critical_path_measures' because we want to record the idle time along a path.
   //   A path being decomposed is not necessarily the critical path, thus idle time is possible. We don't set 'num_critical_path_measures'=='num_per_process_measures'
   //   because the latter specifies the number of global critical path metrics, none of which include idle time (wouldn't make sense).
-  size_t cp_offset = (symbol_timers.size()-1)*symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1);
-  size_t pp_offset = (symbol_timers.size()-1)*(pp_symbol_class_count*num_per_process_measures+1);
-  size_t vol_offset = (symbol_timers.size()-1)*(vol_symbol_class_count*num_volume_measures+1);
+  size_t cp_offset = this->index*symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1);
+  size_t pp_offset = this->index*(pp_symbol_class_count*num_per_process_measures+1);
+  size_t vol_offset = this->index*(vol_symbol_class_count*num_volume_measures+1);
 
   this->pp_numcalls = &symbol_timer_pad_local_pp[pp_offset];
   this->pp_incl_measure = &symbol_timer_pad_local_pp[pp_offset+1];
@@ -42,25 +160,22 @@ symbol_tracker::symbol_tracker(std::string name_){
     this->cp_exclusive_contributions[i] = &symbol_timer_pad_local_cp[cp_offset+2*num_per_process_measures+1+path_select_offset*i];
     this->cp_exclusive_measure[i] = &symbol_timer_pad_local_cp[cp_offset+3*num_per_process_measures+1+path_select_offset*i];
   }
-  memset(&symbol_timer_pad_local_cp[cp_offset],0,sizeof(double)*symbol_path_select_size*path_select_offset);
-  memset(&symbol_timer_pad_local_pp[cp_offset],0,sizeof(double)*(pp_symbol_class_count*num_per_process_measures+1));
-  memset(&symbol_timer_pad_local_vol[vol_offset],0,sizeof(double)*(vol_symbol_class_count*num_volume_measures+1));
-  this->has_been_processed = false;
 }
 
 void symbol_tracker::start(double save_time){
   if (symbol_stack.size()>0){
-    auto last_symbol_time = save_time-symbol_timers[symbol_stack.top()].start_timer.top();
+    auto& outer = symbol_timers[symbol_stack.top().index];
+    auto last_symbol_time = save_time-symbol_stack.top().start_time;
     for (auto i=0; i<symbol_path_select_size; i++){
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-1] += last_symbol_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-2] += last_symbol_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-2] += last_symbol_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-1] += last_symbol_time;
+      outer.cp_exclusive_measure[i][num_per_process_measures-1] += last_symbol_time;
+      outer.cp_exclusive_measure[i][num_per_process_measures-2] += last_symbol_time;
+      outer.cp_excl_measure[i][num_per_process_measures-2] += last_symbol_time;
+      outer.cp_excl_measure[i][num_per_process_measures-1] += last_symbol_time;
     }
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-1] += last_symbol_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-2] += last_symbol_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-2] += last_symbol_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-1] += last_symbol_time;
+    outer.pp_exclusive_measure[num_per_process_measures-1] += last_symbol_time;
+    outer.pp_exclusive_measure[num_per_process_measures-2] += last_symbol_time;
+    outer.pp_excl_measure[num_per_process_measures-2] += last_symbol_time;
+    outer.pp_excl_measure[num_per_process_measures-1] += last_symbol_time;
 
     // Save the communication pattern
     if (opt){
@@ -68,7 +183,7 @@ void symbol_tracker::start(double save_time){
       std::vector<double> measurements(num_per_process_measures,0.);
       measurements[num_per_process_measures-1]=last_symbol_time;
       measurements[num_per_process_measures-2]=last_symbol_time;
-      event_list.push_back(event(symbol_stack.top(),std::move(measurements)));
+      event_list.push_back(event(outer.name,std::move(measurements)));
     }
   }
   else{
@@ -85,16 +200,15 @@ void symbol_tracker::start(double save_time){
   volume_costs[num_volume_measures-2]        += (save_time - computation_timer);		// update local computation time
   volume_costs[num_volume_measures-1]        += (save_time - computation_timer);		// update local runtime
   for (size_t i=0; i<comm_path_select_size; i++){
-    critical_path_costs[critical_path_costs_size-1-i] += (save_time - computation_timer);
+    critical_path_breakdown[critical_path_breakdown_size-1-i] += (save_time - computation_timer);
   }
-  symbol_stack.push(this->name);
   computation_timer = MPI_Wtime();
-  this->start_timer.push((double)computation_timer);
+  symbol_stack.push(symbol_frame{this->index,(double)computation_timer});
 }
 
 void symbol_tracker::stop(double save_time){
-  assert(this->start_timer.size()>0);
-  auto last_symbol_time = save_time-this->start_timer.top();
+  assert(symbol_stack.size()>0 && symbol_stack.top().index == this->index);
+  auto last_symbol_time = save_time-symbol_stack.top().start_time;
   for (auto j=0; j<symbol_path_select_size; j++){
     this->cp_exclusive_measure[j][num_per_process_measures-1] += last_symbol_time;
     this->cp_exclusive_measure[j][num_per_process_measures-2] += last_symbol_time;
@@ -115,7 +229,7 @@ void symbol_tracker::stop(double save_time){
     std::vector<double> measurements(num_per_process_measures,0.);
     measurements[num_per_process_measures-1]=last_symbol_time;
     measurements[num_per_process_measures-2]=last_symbol_time;
-    event_list.push_back(event(symbol_stack.top(),std::move(measurements)));
+    event_list.push_back(event(this->name,std::move(measurements)));
   }
 
   for (auto j=0; j<symbol_path_select_size; j++){
@@ -128,17 +242,16 @@ void symbol_tracker::stop(double save_time){
     memset(this->cp_exclusive_measure[j],0,sizeof(double)*num_per_process_measures);
   }
   memset(this->pp_exclusive_measure,0,sizeof(double)*num_per_process_measures);
-  auto save_symbol = symbol_stack.top();
-  this->start_timer.pop(); symbol_stack.pop();
-  if (symbol_stack.size() > 0 && (save_symbol != symbol_stack.top())){
+  symbol_stack.pop();
+  if (symbol_stack.size() > 0 && (this->index != symbol_stack.top().index)){
     for (auto j=0; j<symbol_path_select_size; j++){
       for (auto i=0; i<num_per_process_measures; i++){
-        symbol_timers[symbol_stack.top()].cp_exclusive_contributions[j][i] += this->cp_exclusive_contributions[j][i];
+        symbol_timers[symbol_stack.top().index].cp_exclusive_contributions[j][i] += this->cp_exclusive_contributions[j][i];
         this->cp_incl_measure[j][i] += this->cp_exclusive_contributions[j][i];
       }
     }
     for (auto i=0; i<num_per_process_measures; i++){
-      symbol_timers[symbol_stack.top()].pp_exclusive_contributions[i] += this->pp_exclusive_contributions[i];
+      symbol_timers[symbol_stack.top().index].pp_exclusive_contributions[i] += this->pp_exclusive_contributions[i];
       this->pp_incl_measure[i] += this->pp_exclusive_contributions[i];
     }
     for (auto j=0; j<symbol_path_select_size; j++){
@@ -163,9 +276,9 @@ void symbol_tracker::stop(double save_time){
   critical_path_costs[num_critical_path_measures-1] += (save_time - computation_timer);		// update critical path runtime
   volume_costs[num_volume_measures-2]        += (save_time - computation_timer);		// update local computation time
   volume_costs[num_volume_measures-1]        += (save_time - computation_timer);		// update local runtime
-  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_costs[critical_path_costs_size-1-i] += (save_time - computation_timer); }
+  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_breakdown[critical_path_breakdown_size-1-i] += (save_time - computation_timer); }
   computation_timer = MPI_Wtime();
-  if (symbol_stack.size()>0){ symbol_timers[symbol_stack.top()].start_timer.top() = computation_timer; }
+  if (symbol_stack.size()>0){ symbol_stack.top().start_time = computation_timer; }
 }
 
 }
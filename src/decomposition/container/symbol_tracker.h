@@ -11,13 +11,16 @@ namespace decomposition{
 class symbol_tracker{
   public:
     symbol_tracker() {}
-    symbol_tracker(std::string name_);
+    symbol_tracker(int id_, int index_);
+    /** \brief point the measures of this symbol into the local symbol timer pads, which move when they grow */
+    void rebase();
     void stop(double save_time);
     void start(double save_time);
     bool operator<(const symbol_tracker& w) const ;
 
     std::string name;
-    std::stack<double> start_timer;
+    int id;// id in the symbol registry
+    int index;// position in 'symbol_timers'
     std::vector<double*> cp_exclusive_contributions;
     double* pp_exclusive_contributions;
     std::vector<double*> cp_exclusive_measure;
@@ -34,7 +37,34 @@ class symbol_tracker{
     bool has_been_processed;
 };
 
-extern std::unordered_map<std::string,symbol_tracker> symbol_timers;
+// Indexed by the order in which symbols are first encountered, which also determines each symbol's offset into the symbol timer pads
+extern CRITTER_RANK_LOCAL std::vector<symbol_tracker> symbol_timers;
+
+/** \brief grow the symbol timer pads geometrically to hold at least 'count' symbols, rebasing all trackers */
+void reserve_symbols(size_t count);
+/** \brief index into 'symbol_timers' of the symbol with registry id 'id', creating its tracker on first use */
+int get_symbol_index(int id);
+/** \brief index into 'symbol_timers' of the symbol with global id 'global_id' (e.g., as received from another process), creating its tracker on first use */
+int get_global_symbol_index(uint64_t global_id);
+/** \brief write the global id of each tracked symbol, in the order of 'symbol_timers' */
+void pack_symbol_ids(uint64_t* ids);
+/** \brief write the header of symbol data sent to 'partner' in 'comm' (or collectively to all of 'comm' if 'partner' is -1): the symbol count,
+           the count of registered names not yet sent over that channel, and their total length. Those names are then considered sent.
+           Returns the registry id of the first such name. */
+size_t pack_symbol_header(MPI_Comm comm, int partner, int* header);
+/** \brief size in bytes of a symbol message with header 'header' (see 'pack_symbol_header') that carries 'data_len' measures */
+size_t get_symbol_message_size(int const* header, size_t data_len);
+/** \brief pack into 'buffer' a self-describing symbol message: the header, the global id of each tracked symbol, 'data_len' measures from 'data',
+           and the names from registry id 'first_name' on */
+void pack_symbol_message(char* buffer, int const* header, size_t first_name, double const* data, size_t data_len);
+/** \brief view the symbol message in 'buffer', registering the names it carries */
+symbol_message unpack_symbol_message(char* buffer);
+/** \brief match the next symbol message sent by 'partner' in 'comm' with tag 'tag', returning its size in bytes; it is received by PMPI_Mrecv on 'handle' */
+size_t probe_symbol_message(MPI_Comm comm, int partner, int tag, MPI_Message* handle);
+/** \brief receive into 'pad' (grown to fit) the next symbol message sent by 'partner' in 'comm' with tag 'tag' */
+symbol_message receive_symbol_message(MPI_Comm comm, int partner, int tag, std::vector<char>& pad);
+/** \brief drop all symbol trackers */
+void clear_symbols();
 
 }
 }
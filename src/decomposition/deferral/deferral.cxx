@@ -0,0 +1,124 @@
+#include "deferral.h"
+#include "../container/overhead_counter.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+// The breakdown of the decomposed paths accumulated since the last node, laid out as the tail of 'critical_path_costs' would be otherwise
+static CRITTER_RANK_LOCAL std::vector<double> segment;
+// Per logged node: the predecessor of each path, as 'comm_path_select_size' encoded world ranks followed by as many node indices
+static CRITTER_RANK_LOCAL std::vector<int> node_predecessors;
+// Per logged node: the nonzero entries of its breakdown, starting at 'node_offsets[node]'.
+//   Every local contribution adds the same value to each path, so a single path's entries (grouped by 'comm_path_select_size') suffice.
+static CRITTER_RANK_LOCAL std::vector<int> node_offsets;
+static CRITTER_RANK_LOCAL std::vector<int> node_groups;
+static CRITTER_RANK_LOCAL std::vector<double> node_values;
+static CRITTER_RANK_LOCAL int world_rank;
+
+void deferral::allocate(){
+  MPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
+  segment.assign(std::max(critical_path_breakdown_size,(size_t)1),0.);
+  critical_path_breakdown = &segment[0];
+}
+
+void deferral::reset(){
+  std::fill(segment.begin(),segment.end(),0.);
+  node_predecessors.clear();
+  node_offsets.clear();
+  node_groups.clear();
+  node_values.clear();
+}
+
+void deferral::mark(){
+  if (comm_path_select_size == 0) return;
+  size_t group_count = critical_path_breakdown_size/comm_path_select_size;
+  int node = node_offsets.size();
+  node_offsets.push_back(node_groups.size());
+  for (size_t i=0; i<group_count; i++){
+    if (segment[i*comm_path_select_size] != 0.){
+      node_groups.push_back(i);
+      node_values.push_back(segment[i*comm_path_select_size]);
+    }
+  }
+  std::fill(segment.begin(),segment.end(),0.);
+  // A predecessor's world rank is stored off by one, so that zeroed path data marks the start of a path
+  double* predecessors = &critical_path_costs[num_critical_path_measures];
+  for (size_t i=0; i<2*comm_path_select_size; i++){ node_predecessors.push_back((int)predecessors[i]); }
+  for (size_t i=0; i<comm_path_select_size; i++){
+    predecessors[i] = world_rank+1;
+    predecessors[comm_path_select_size+i] = node;
+  }
+}
+
+void deferral::resolve(MPI_Comm comm){
+  if (comm_path_select_size == 0) return;
+  internal_overhead_counter.enter(overhead_collect);
+  int rank,size;
+  MPI_Comm_rank(comm,&rank);
+  MPI_Comm_size(comm,&size);
+  size_t stride = 2*comm_path_select_size;
+  // Rank 0 walks each path backward through the predecessors logged by all processes
+  int node_count = node_offsets.size();
+  std::vector<int> node_counts(rank == 0 ? size : 0), node_displs(rank == 0 ? size : 0);
+  PMPI_Gather(&node_count,1,MPI_INT,node_counts.data(),1,MPI_INT,0,comm);
+  std::vector<int> predecessor_counts(node_counts.size()), all_predecessors;
+  if (rank == 0){
+    int total = 0;
+    for (int i=0; i<size; i++){
+      node_displs[i] = total;
+      predecessor_counts[i] = node_counts[i]*stride;
+      total += predecessor_counts[i];
+    }
+    all_predecessors.resize(total);
+  }
+  PMPI_Gatherv(node_predecessors.data(),node_count*stride,MPI_INT,all_predecessors.data(),predecessor_counts.data(),node_displs.data(),MPI_INT,0,comm);
+  internal_overhead_counter.message(sizeof(int));
+  internal_overhead_counter.message(node_count*stride*sizeof(int));
+  // Each process receives the (path, node) pairs that lie on a path
+  std::vector<std::vector<int>> on_path(rank == 0 ? size : 0);
+  if (rank == 0){
+    for (size_t i=0; i<comm_path_select_size; i++){
+      int path_rank = (int)critical_path_costs[num_critical_path_measures+i];
+      int path_node = (int)critical_path_costs[num_critical_path_measures+comm_path_select_size+i];
+      while (path_rank != 0){
+        on_path[path_rank-1].push_back(i);
+        on_path[path_rank-1].push_back(path_node);
+        int* predecessors = &all_predecessors[node_displs[path_rank-1]+path_node*stride];
+        path_rank = predecessors[i];
+        path_node = predecessors[comm_path_select_size+i];
+      }
+    }
+  }
+  std::vector<int> on_path_counts(on_path.size()), on_path_displs(on_path.size()), all_on_path;
+  for (int i=0; i<(int)on_path.size(); i++){
+    on_path_counts[i] = on_path[i].size();
+    on_path_displs[i] = all_on_path.size();
+    all_on_path.insert(all_on_path.end(),on_path[i].begin(),on_path[i].end());
+  }
+  int on_path_count;
+  PMPI_Scatter(on_path_counts.data(),1,MPI_INT,&on_path_count,1,MPI_INT,0,comm);
+  std::vector<int> local_on_path(on_path_count);
+  PMPI_Scatterv(all_on_path.data(),on_path_counts.data(),on_path_displs.data(),MPI_INT,local_on_path.data(),on_path_count,MPI_INT,0,comm);
+  if (rank == 0){
+    internal_overhead_counter.message(size*sizeof(int));
+    internal_overhead_counter.message(all_on_path.size()*sizeof(int));
+  }
+
+  // The breakdown of each path is the sum of the segments of its nodes
+  std::fill(segment.begin(),segment.end(),0.);
+  for (int i=0; i<on_path_count; i+=2){
+    int path = local_on_path[i];
+    int node = local_on_path[i+1];
+    int end = (node+1 < node_count) ? node_offsets[node+1] : node_groups.size();
+    for (int j=node_offsets[node]; j<end; j++){ segment[node_groups[j]*comm_path_select_size+path] += node_values[j]; }
+  }
+  if (rank == 0){ PMPI_Reduce(MPI_IN_PLACE,&segment[0],critical_path_breakdown_size,MPI_DOUBLE,MPI_SUM,0,comm); }
+  else          { PMPI_Reduce(&segment[0],nullptr,critical_path_breakdown_size,MPI_DOUBLE,MPI_SUM,0,comm); }
+  internal_overhead_counter.message(critical_path_breakdown_size*sizeof(double));
+  internal_overhead_counter.exit();
+}
+
+}
+}
+}
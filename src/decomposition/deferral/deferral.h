@@ -0,0 +1,30 @@
+#ifndef CRITTER__DECOMPOSITION__DEFERRAL__DEFERRAL_H_
+#define CRITTER__DECOMPOSITION__DEFERRAL__DEFERRAL_H_
+
+#include "../../util/util.h"
+
+namespace critter{
+namespace internal{
+namespace decomposition{
+
+// Deferred decomposition (CRITTER_MECHANISM=1) propagates only the path measures, along with a predecessor for each decomposed path:
+//   the world rank and local node index of the process state that the path passes through last. Each process instead logs, at every node
+//   (each time its path data is sent or merged), the predecessor of each path and the breakdown accumulated since its previous node.
+//   The breakdown of each path is then resolved once, at the end, by walking the logged predecessors backward from the path's end.
+class deferral{
+public:
+  /** \brief point 'critical_path_breakdown' at the local segment; called once the path data sizes are known */
+  static void allocate();
+  /** \brief drop all logged nodes and zero the local segment */
+  static void reset();
+  /** \brief log a node for the current process state and make it the predecessor of each path; called before path data is sent or merged */
+  static void mark();
+  /** \brief gather the breakdown of each decomposed path onto rank 0 of 'comm' (which must span all processes); collective over 'comm' */
+  static void resolve(MPI_Comm comm);
+};
+
+}
+}
+}
+
+#endif /*CRITTER__DECOMPOSITION__DEFERRAL__DEFERRAL_H_*/
@@ -1,7 +1,15 @@
 #include "path.h"
 #include "../container/symbol_tracker.h"
+#include "../container/envelope_pool.h"
+#include "../container/node_hierarchy.h"
+#include "../container/path_sampler.h"
+#include "../container/overhead_governor.h"
+#include "../container/overhead_counter.h"
+#include "../deferral/deferral.h"
 #include "../../optimization/path/path.h"
 #include "../../util/util.h"
+#include "../../util/metadata.h"
+#include "../../util/symbol_registry.h"
 
 namespace critter{
 namespace internal{
@@ -42,118 +50,608 @@ static void propagate_critical_path_op(double* in, double* inout, int* len, MPI_
   update_critical_path(in,inout,static_cast<size_t>(*len));
 }
 
+// Symbol data is propagated along with path data unless the overhead governor has dropped it (CRITTER_MAX_OVERHEAD)
+static inline bool symbol_data_propagates(){
+  return (symbol_path_select_size>0) && !internal_overhead_governor.drops_symbols();
+}
+
+// A sparse path record (CRITTER_PATH_ENCODING>0) carries the breakdown of 'critical_path_costs' only for the routines flagged in its leading mask.
+//   Its layout is the mask, the 'num_critical_path_measures' path measures (always in double precision, as they decide the paths), the cost block of each flagged routine,
+//   and the per-path computation and idle times. With CRITTER_PATH_ENCODING=2, the blocks and times are sent in single precision.
+static CRITTER_RANK_LOCAL std::vector<char> path_record_pad_send;
+static CRITTER_RANK_LOCAL std::vector<char> path_record_pad_recv;
+
+static inline bool use_path_records(){
+  return (path_encoding>0) && (comm_path_select_size>0);
+}
+
+static inline size_t get_path_record_value_size(){
+  return (path_encoding==2) ? sizeof(float) : sizeof(double);
+}
+
+static inline size_t get_routine_block_size(){
+  return num_tracker_critical_path_measures*comm_path_select_size;
+}
+
+static uint64_t get_routine_mask(double const* path_data){
+  uint64_t mask = 0;
+  size_t block_size = get_routine_block_size();
+  for (size_t i=0; i<list_size; i++){
+    double const* block = path_data + num_critical_path_measures + i*block_size;
+    for (size_t j=0; j<block_size; j++){
+      if (block[j] != 0.){ mask |= ((uint64_t)1 << i); break; }
+    }
+  }
+  return mask;
+}
+
+static size_t get_path_record_size(uint64_t mask){
+  size_t routine_count = 0;
+  for (size_t i=0; i<list_size; i++){ routine_count += (mask >> i) & 1; }
+  return sizeof(uint64_t) + num_critical_path_measures*sizeof(double)
+         + (routine_count*get_routine_block_size() + 2*comm_path_select_size)*get_path_record_value_size();
+}
+
+static inline size_t get_max_path_record_size(){
+  return get_path_record_size(((uint64_t)1 << list_size) - 1);
+}
+
+template<typename T>
+static T* encode_path_values(double const* values, size_t count, T* record){
+  for (size_t j=0; j<count; j++){ record[j] = values[j]; }
+  return record + count;
+}
+
+template<typename T>
+static T const* decode_path_values(T const* record, size_t count, double* values){
+  for (size_t j=0; j<count; j++){ values[j] = record[j]; }
+  return record + count;
+}
+
+template<typename T>
+static void encode_path_record(double const* path_data, uint64_t mask, char* record){
+  size_t block_size = get_routine_block_size();
+  *(uint64_t*)record = mask;
+  std::memcpy(record+sizeof(uint64_t),path_data,num_critical_path_measures*sizeof(double));
+  T* values = (T*)(record + sizeof(uint64_t) + num_critical_path_measures*sizeof(double));
+  for (size_t i=0; i<list_size; i++){
+    if ((mask >> i) & 1){ values = encode_path_values(path_data + num_critical_path_measures + i*block_size,block_size,values); }
+  }
+  encode_path_values(path_data + critical_path_costs_size - 2*comm_path_select_size,2*comm_path_select_size,values);
+}
+
+template<typename T>
+static void decode_path_record(char const* record, double* path_data){
+  size_t block_size = get_routine_block_size();
+  uint64_t mask = *(uint64_t const*)record;
+  std::memcpy(path_data,record+sizeof(uint64_t),num_critical_path_measures*sizeof(double));
+  T const* values = (T const*)(record + sizeof(uint64_t) + num_critical_path_measures*sizeof(double));
+  for (size_t i=0; i<list_size; i++){
+    double* block = path_data + num_critical_path_measures + i*block_size;
+    if ((mask >> i) & 1){ values = decode_path_values(values,block_size,block); }
+    else { std::memset(block,0,block_size*sizeof(double)); }
+  }
+  decode_path_values(values,2*comm_path_select_size,path_data + critical_path_costs_size - 2*comm_path_select_size);
+}
+
+// Writes the record of 'path_data' into 'record' (which must hold 'get_max_path_record_size()' bytes unless 'mask' is given) and returns its size
+static size_t encode_path_record(double const* path_data, char* record, uint64_t mask){
+  if (path_encoding==2){ encode_path_record<float>(path_data,mask,record); }
+  else { encode_path_record<double>(path_data,mask,record); }
+  return get_path_record_size(mask);
+}
+
+static void decode_path_record(char const* record, double* path_data){
+  if (path_encoding==2){ decode_path_record<float>(record,path_data); }
+  else { decode_path_record<double>(record,path_data); }
+}
+
+// Created once in path::allocate rather than around every propagation through a user collective.
+//   Nonblocking collectives use it, as their two stages could not be chained without blocking (see 'reduce_critical_path'),
+//   as do the reductions to the root of a rooted collective (see 'root_critical_path').
+static CRITTER_RANK_LOCAL MPI_Op critical_path_op = MPI_OP_NULL;
+static CRITTER_RANK_LOCAL int persistent_propagation_keyval = MPI_KEYVAL_INVALID;
+// Communicators that hold a persistent_propagation attribute, from which path::deallocate deletes it
+static CRITTER_RANK_LOCAL std::vector<MPI_Comm> persistent_propagation_comms;
+// Offset of this process's MPI_Wtime from that of world rank 0, added to arrival timestamps exchanged by the p2p handshake
+static CRITTER_RANK_LOCAL double wtime_offset = 0;
+
+// Persistent requests that exchange 'critical_path_costs' (into 'new_cs' on the receive side) with the same partners over and over,
+//   cached as an attribute so that they are released when the communicator is freed.
+struct persistent_propagation{
+  std::unordered_map<int,MPI_Request> send_requests;// keyed by destination
+  std::unordered_map<int,MPI_Request> recv_requests;// keyed by source
+};
+
+static int delete_persistent_propagation(MPI_Comm comm, int keyval, void* attribute_val, void* extra_state){
+  persistent_propagation* channels = (persistent_propagation*)attribute_val;
+  for (auto& it : channels->send_requests){ PMPI_Request_free(&it.second); }
+  for (auto& it : channels->recv_requests){ PMPI_Request_free(&it.second); }
+  delete channels;
+  persistent_propagation_comms.erase(std::find(persistent_propagation_comms.begin(),persistent_propagation_comms.end(),comm));
+  return MPI_SUCCESS;
+}
+
+static persistent_propagation& get_persistent_propagation(MPI_Comm comm){
+  persistent_propagation* channels; int flag;
+  MPI_Comm_get_attr(comm,persistent_propagation_keyval,&channels,&flag);
+  if (!flag){
+    channels = new persistent_propagation();
+    MPI_Comm_set_attr(comm,persistent_propagation_keyval,channels);
+    persistent_propagation_comms.push_back(comm);
+  }
+  return *channels;
+}
+
+// Equivalent to a PMPI_Sendrecv of 'critical_path_costs' to 'dest' and into 'new_cs' from 'source'
+static void exchange_critical_path(MPI_Comm comm, int dest, int source){
+  if (use_path_records()){
+    // Record sizes vary from one exchange to the next, so persistent requests do not apply; the receive is posted for the largest record.
+    reserve_pad(path_record_pad_send,get_max_path_record_size());
+    reserve_pad(path_record_pad_recv,get_max_path_record_size());
+    size_t record_size = encode_path_record(&critical_path_costs[0],&path_record_pad_send[0],get_routine_mask(&critical_path_costs[0]));
+    internal_overhead_counter.message(record_size);
+    PMPI_Sendrecv(&path_record_pad_send[0], record_size, MPI_BYTE, dest, internal_tag2,
+                  &path_record_pad_recv[0], get_max_path_record_size(), MPI_BYTE, source, internal_tag2, comm, MPI_STATUS_IGNORE);
+    decode_path_record(&path_record_pad_recv[0],&new_cs[0]);
+    return;
+  }
+  persistent_propagation& channels = get_persistent_propagation(comm);
+  auto recv_it = channels.recv_requests.find(source);
+  if (recv_it == channels.recv_requests.end()){
+    MPI_Request request;
+    PMPI_Recv_init(&new_cs[0], critical_path_costs.size(), MPI_DOUBLE, source, internal_tag2, comm, &request);
+    recv_it = channels.recv_requests.insert(std::make_pair(source,request)).first;
+  }
+  auto send_it = channels.send_requests.find(dest);
+  if (send_it == channels.send_requests.end()){
+    MPI_Request request;
+    PMPI_Send_init(&critical_path_costs[0], critical_path_costs.size(), MPI_DOUBLE, dest, internal_tag2, comm, &request);
+    send_it = channels.send_requests.insert(std::make_pair(dest,request)).first;
+  }
+  PMPI_Start(&recv_it->second);
+  PMPI_Start(&send_it->second);
+  internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+  PMPI_Wait(&recv_it->second, MPI_STATUS_IGNORE);
+  PMPI_Wait(&send_it->second, MPI_STATUS_IGNORE);
+}
+
+// Propagation through a blocking collective proceeds in two stages. The path measures are first reduced with MAXLOC, which determines the root of each path
+//   (and which the symbol propagation reuses). Each process then zeroes the breakdown of the paths it does not root, so that summing the breakdowns yields each root's.
+//   This replaces a reduction of all of 'critical_path_costs' with 'critical_path_op', which must decide the root of each path anew at every step.
+static void reduce_critical_path(MPI_Comm comm, int rank){
+  if ((comm_path_select_size==0) && (symbol_path_select_size==0)){
+    internal_node_hierarchy.allreduce(&critical_path_costs[0], num_critical_path_measures, MPI_DOUBLE, MPI_MAX, comm);
+    return;
+  }
+  for (int i=0; i<num_critical_path_measures; i++){
+    info_receiver[i].first = critical_path_costs[i];
+    info_receiver[i].second = rank;
+  }
+  // Over communicators spanning MPI_COMM_WORLD, each stage first reduces within each node, and only node leaders communicate over the network
+  internal_node_hierarchy.allreduce(&info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, MPI_MAXLOC, comm);
+  for (int i=0; i<num_critical_path_measures; i++){ critical_path_costs[i] = info_receiver[i].first; }
+  if (comm_path_select_size==0) return;
+
+  size_t breakdown_idx=0;
+  for (int i=0; i<num_critical_path_measures; i++){
+    if (comm_path_select[i]=='1'){ decisions[breakdown_idx++] = (info_receiver[i].second == rank); }
+  }
+  for (int i=num_critical_path_measures; i<critical_path_costs_size; i++){
+    if (!decisions[(i-num_critical_path_measures)%comm_path_select_size]){ critical_path_costs[i] = 0.; }
+  }
+  if (use_path_records()){
+    // Only the values of the routines used along any of the paths are summed, which first requires agreement on those routines
+    uint64_t mask = get_routine_mask(&critical_path_costs[0]);
+    internal_node_hierarchy.allreduce(&mask, 1, MPI_UINT64_T, MPI_BOR, comm);
+    reserve_pad(path_record_pad_send,get_max_path_record_size());
+    size_t record_size = encode_path_record(&critical_path_costs[0],&path_record_pad_send[0],mask);
+    size_t values_offset = sizeof(uint64_t) + num_critical_path_measures*sizeof(double);
+    internal_node_hierarchy.allreduce(&path_record_pad_send[values_offset], (record_size-values_offset)/get_path_record_value_size(),
+                                      (path_encoding==2) ? MPI_FLOAT : MPI_DOUBLE, MPI_SUM, comm);
+    decode_path_record(&path_record_pad_send[0],&critical_path_costs[0]);
+    return;
+  }
+  internal_node_hierarchy.allreduce(&critical_path_costs[num_critical_path_measures], critical_path_costs_size-num_critical_path_measures, MPI_DOUBLE, MPI_SUM, comm);
+}
+
+// Data of a rooted collective flows from its root (Bcast, Scatter, and their variants) or to its root (Reduce, Gather, and their variants)
+static inline bool is_rooted_broadcast(int tag){
+  return (tag==1) || (tag==6) || (tag==11) || (tag==20) || (tag==27) || (tag==28);
+}
+
+// Propagation through a rooted collective follows its data: each process continues along the longer of its own path and the root's,
+//   or the root alone continues along the longest path of all processes. Propagation through a symbol path always reduces to all processes instead,
+//   as each process must know the root of each path (see 'reduce_critical_path').
+static void root_critical_path(MPI_Comm comm, int rank, int root, bool from_root){
+  MPI_Op op = (comm_path_select_size==0) ? MPI_MAX : critical_path_op;
+  internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+  if (from_root){
+    if (rank == root){ PMPI_Bcast(&critical_path_costs[0], critical_path_costs_size, MPI_DOUBLE, root, comm); }
+    else{
+      PMPI_Bcast(&new_cs[0], critical_path_costs_size, MPI_DOUBLE, root, comm);
+      update_critical_path(&new_cs[0],&critical_path_costs[0],critical_path_costs_size);
+    }
+  }
+  else{
+    if (rank == root){ PMPI_Reduce(MPI_IN_PLACE, &critical_path_costs[0], critical_path_costs_size, MPI_DOUBLE, op, root, comm); }
+    else             { PMPI_Reduce(&critical_path_costs[0], nullptr, critical_path_costs_size, MPI_DOUBLE, op, root, comm); }
+  }
+}
+
+// The buffer attached for eager internal communication must hold all messages of a single propagation, the largest of which scales with the number of symbols.
+//   At most all registered names accompany the symbol data, when none have been sent to the partner yet.
+static void attach_eager_pad(MPI_Comm comm){
+  static CRITTER_RANK_LOCAL size_t eager_pad_num_symbols = std::numeric_limits<size_t>::max();
+  static CRITTER_RANK_LOCAL size_t eager_pad_num_names = std::numeric_limits<size_t>::max();
+  if ((eager_pad_num_symbols != symbol_timers.size()) || (eager_pad_num_names != get_symbol_count())){
+    eager_pad_num_symbols = symbol_timers.size();
+    eager_pad_num_names = get_symbol_count();
+    int max_symbol_header[3] = {(int)eager_pad_num_symbols,(int)eager_pad_num_names,(int)get_symbol_name_chars(0)};
+    int eager_msg_sizes[5];
+    MPI_Pack_size(1,MPI_CHAR,comm,&eager_msg_sizes[0]);
+    MPI_Pack_size(1,MPI_CHAR,comm,&eager_msg_sizes[1]);
+    MPI_Pack_size(num_critical_path_measures,MPI_DOUBLE_INT,comm,&eager_msg_sizes[2]);
+    if (use_path_records()) { MPI_Pack_size(get_max_path_record_size(),MPI_BYTE,comm,&eager_msg_sizes[3]); }
+    else { MPI_Pack_size(critical_path_costs_size,MPI_DOUBLE,comm,&eager_msg_sizes[3]); }
+    MPI_Pack_size(get_symbol_message_size(max_symbol_header,symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*eager_pad_num_symbols),
+                  MPI_BYTE,comm,&eager_msg_sizes[4]);
+    int eager_pad_size = 5*MPI_BSEND_OVERHEAD;
+    for (int i=0; i<5; i++) { eager_pad_size += eager_msg_sizes[i]; }
+    reserve_pad(eager_pad,eager_pad_size);
+  }
+  MPI_Buffer_attach(&eager_pad[0],eager_pad.size());
+}
+
+// Symbol data sent to a partner is a single self-describing message (internal_tag5), matched by probe so that its size need not be known in advance.
+//   Messages from a given partner are received in the order in which they were sent, as the propagations that send them complete in the same order.
+static void receive_symbols(symbol_envelope& envelope){
+  if (envelope.received) return;
+  MPI_Message handle;
+  size_t message_size = probe_symbol_message(envelope.comm,envelope.partner,internal_tag5,&handle);
+  char* buffer = internal_envelope_pool.allocate<char>(message_size);
+  PMPI_Mrecv(buffer,message_size,MPI_BYTE,&handle,MPI_STATUS_IGNORE);
+  envelope.message = unpack_symbol_message(buffer);
+  envelope.received = true;
+}
+
+// Symbol data that 'partner' sent for earlier nonblocking propagations precedes, in the same tag, whatever it sends next.
+//   It must be received before anything else from 'partner', both to keep the matching in order and because later name deltas assume its names are known.
+static void receive_pending_symbols(MPI_Comm comm, int partner){
+  for (auto& it : internal_timer_prop_recv){
+    if ((it.comm == comm) && (it.partner == partner)){ receive_symbols(it); }
+  }
+}
+
 static void complete_timers(double* remote_path_data, size_t msg_id){
-  if (eager_p2p==0){
-    int* envelope_int[2] = { internal_timer_prop_int[4*msg_id+2], internal_timer_prop_int[4*msg_id+3] };
-    double* envelope_double[2] = { remote_path_data, internal_timer_prop_double[2*msg_id+1] };
-    char* envelope_char = internal_timer_prop_char[2*msg_id+1];
-    for (auto k=0; k<symbol_path_select_size; k++){
-      // Up until this very point, we had no idea whether we, or our partner rank, determined the path for a specific metric.
-      if (envelope_double[0][symbol_path_select_index[k]] > critical_path_costs[symbol_path_select_index[k]]){
-        int ftimer_size = *envelope_int[0];
-        int symbol_offset = 0;
-        for (int i=0; i<ftimer_size; i++){
-          auto reconstructed_symbol = std::string(envelope_char+symbol_offset,envelope_char+symbol_offset+envelope_int[1][i]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          std::memcpy(symbol_timers[reconstructed_symbol].cp_numcalls[k],
-                      &envelope_double[1][(i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1)],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          symbol_offset += envelope_int[1][i];
-        }
-        // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
-        for (auto& it : symbol_timers){
-          if (it.second.has_been_processed){ it.second.has_been_processed = false; }
-          else{
-            it.second.cp_numcalls[k][0] = 0;
-            for (int j=0; j<num_per_process_measures; j++){
-              it.second.cp_incl_measure[k][j] = 0;
-              it.second.cp_excl_measure[k][j] = 0;
-            }
+  symbol_envelope& envelope = internal_timer_prop_recv[msg_id];
+  receive_symbols(envelope);
+  for (auto k=0; k<symbol_path_select_size; k++){
+    // Up until this very point, we had no idea whether we, or our partner rank, determined the path for a specific metric.
+    if (remote_path_data[symbol_path_select_index[k]] > critical_path_costs[symbol_path_select_index[k]]){
+      for (int i=0; i<envelope.message.header[0]; i++){
+        int reconstructed_index = get_global_symbol_index(envelope.message.ids[i]);
+        std::memcpy(symbol_timers[reconstructed_index].cp_numcalls[k],
+                    &envelope.message.data[(i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1)],
+                    sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
+        symbol_timers[reconstructed_index].has_been_processed = true;
+      }
+      // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
+      for (auto& it : symbol_timers){
+        if (it.has_been_processed){ it.has_been_processed = false; }
+        else{
+          it.cp_numcalls[k][0] = 0;
+          for (int j=0; j<num_per_process_measures; j++){
+            it.cp_incl_measure[k][j] = 0;
+            it.cp_excl_measure[k][j] = 0;
           }
         }
       }
     }
-  } else{
-    // Note that only receives will enter this function anyways, so no need to branch
-    int* envelope_int[2] = { internal_timer_prop_int[2*msg_id], internal_timer_prop_int[2*msg_id+1] };
-    double* envelope_double[2] = { remote_path_data, internal_timer_prop_double[msg_id] };
-    char* envelope_char = internal_timer_prop_char[msg_id];
-    for (auto k=0; k<symbol_path_select_size; k++){
-      // Up until this very point, we had no idea whether we, or our partner rank, determined the path for a specific metric.
-      if (envelope_double[0][symbol_path_select_index[k]] > critical_path_costs[symbol_path_select_index[k]]){
-        int ftimer_size = *envelope_int[0];
-        int symbol_offset = 0;
-        for (int i=0; i<ftimer_size; i++){
-          auto reconstructed_symbol = std::string(envelope_char+symbol_offset,envelope_char+symbol_offset+envelope_int[1][i]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          std::memcpy(symbol_timers[reconstructed_symbol].cp_numcalls[k],
-                      &envelope_double[1][(i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1)],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          symbol_offset += envelope_int[1][i];
-        }
-        // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
-        for (auto& it : symbol_timers){
-          if (it.second.has_been_processed){ it.second.has_been_processed = false; }
-          else{
-            it.second.cp_numcalls[k][0] = 0;
-            for (int j=0; j<num_per_process_measures; j++){
-              it.second.cp_incl_measure[k][j] = 0;
-              it.second.cp_excl_measure[k][j] = 0;
-            }
-          }
-        }
+  }
+}
+
+static void post_path_send(MPI_Comm comm, int partner){
+  MPI_Request request;
+  double* local_path_data;
+  if (use_path_records()){
+    char* record = internal_envelope_pool.allocate<char>(get_max_path_record_size());
+    size_t record_size = encode_path_record(&critical_path_costs[0],record,get_routine_mask(&critical_path_costs[0]));
+    PMPI_Isend(record, record_size, MPI_BYTE, partner, internal_tag2, comm, &request);
+    internal_overhead_counter.message(record_size);
+    local_path_data = (double*)record;
+  }
+  else{
+    local_path_data = internal_envelope_pool.allocate<double>(critical_path_costs.size());
+    std::memcpy(local_path_data, &critical_path_costs[0], critical_path_costs.size()*sizeof(double));
+    PMPI_Isend(local_path_data, critical_path_costs.size(), MPI_DOUBLE, partner, internal_tag2, comm, &request);
+    internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+  }
+  internal_comm_prop.push_back(std::make_pair(local_path_data,true));
+  internal_comm_prop_req.push_back(request);
+}
+
+// A received record is decoded within its own buffer by 'complete_path_update'
+static void post_path_recv(MPI_Comm comm, int partner){
+  MPI_Request request;
+  double* remote_path_data;
+  if (use_path_records()){
+    // Also large enough for the path data that the record is decoded into
+    char* record = internal_envelope_pool.allocate<char>(std::max(get_max_path_record_size(),critical_path_costs_size*sizeof(double)));
+    PMPI_Irecv(record, get_max_path_record_size(), MPI_BYTE, partner, internal_tag2, comm, &request);
+    remote_path_data = (double*)record;
+  }
+  else{
+    remote_path_data = internal_envelope_pool.allocate<double>(critical_path_costs.size());
+    PMPI_Irecv(remote_path_data, critical_path_costs.size(), MPI_DOUBLE, partner, internal_tag2, comm, &request);
+  }
+  internal_comm_prop.push_back(std::make_pair(remote_path_data,false));
+  internal_comm_prop_req.push_back(request);
+}
+
+// Path data piggybacked on a user message (CRITTER_PIGGYBACK_P2P=1) precedes the user data within a derived datatype.
+//   Its size is fixed, as a receiver describes the message before knowing what was sent: a copy of 'critical_path_costs', or a path record padded to the largest record size.
+static CRITTER_RANK_LOCAL std::vector<char> piggyback_pad_send;
+static CRITTER_RANK_LOCAL std::vector<char> piggyback_pad_recv;
+// Payloads of nonblocking p2p stay in flight until the user completes the request, well beyond the lifetime of an envelope
+static CRITTER_RANK_LOCAL std::vector<char*> piggyback_payloads;
+static CRITTER_RANK_LOCAL char* pending_payload = nullptr;
+static CRITTER_RANK_LOCAL MPI_Datatype pending_payload_type = MPI_DATATYPE_NULL;
+
+static inline int get_piggyback_payload_count(){
+  return use_path_records() ? get_max_path_record_size() : critical_path_costs_size;
+}
+
+// Also large enough for the path data that a received record is decoded into
+static inline size_t get_piggyback_buffer_size(){
+  return std::max(get_max_path_record_size(),critical_path_costs_size*sizeof(double));
+}
+
+static void encode_piggyback_payload(double const* path_data, char* payload){
+  if (use_path_records()){ encode_path_record(path_data,payload,get_routine_mask(path_data)); }
+  else { std::memcpy(payload,path_data,critical_path_costs_size*sizeof(double)); }
+}
+
+static MPI_Datatype create_piggyback_type(char* payload, void const* buf, int count, MPI_Datatype t){
+  int block_lengths[2] = {get_piggyback_payload_count(),count};
+  MPI_Aint displacements[2];
+  MPI_Datatype types[2] = {use_path_records() ? MPI_BYTE : MPI_DOUBLE, t};
+  MPI_Get_address(payload,&displacements[0]);
+  MPI_Get_address(buf,&displacements[1]);
+  MPI_Datatype wrapped;
+  MPI_Type_create_struct(2,block_lengths,displacements,types,&wrapped);
+  MPI_Type_commit(&wrapped);
+  return wrapped;
+}
+
+// The count of a received message includes its payload, which the user never sees
+static void correct_piggyback_status(MPI_Status* status, MPI_Datatype wrapped, MPI_Datatype t){
+  if (status == MPI_STATUS_IGNORE) return;
+  MPI_Count num_elements;
+  MPI_Get_elements_x(status,wrapped,&num_elements);
+  MPI_Status_set_elements_x(status,t,num_elements-get_piggyback_payload_count());
+}
+
+// The partner's symbols are received in 'complete_timers', once they are needed
+static void post_symbol_recv(MPI_Comm comm, int partner){
+  symbol_envelope envelope;
+  envelope.comm = comm;
+  envelope.partner = partner;
+  envelope.received = false;
+  internal_timer_prop_recv.push_back(envelope);
+}
+
+// A received payload is merged by 'complete_path_update' as if received by a nonblocking propagation
+static void post_piggyback_recv(MPI_Comm comm, int partner, char const* payload){
+  char* remote_path_data = internal_envelope_pool.allocate<char>(get_piggyback_buffer_size());
+  std::memcpy(remote_path_data,payload,get_piggyback_buffer_size());
+  internal_comm_prop.push_back(std::make_pair((double*)remote_path_data,false));
+  if (symbol_data_propagates()) post_symbol_recv(comm,partner);
+}
+
+// Deferred requests are never waited on by the process that posts them, so each keeps its own buffer until it is found complete.
+//   These are the sends of a causal propagation (CRITTER_CAUSAL_P2P=1), whose receiver merges what it receives as if it were received by a nonblocking propagation,
+//   and the receives of idle time handshake replies destined for nonblocking senders, which must not wait on their receivers.
+static CRITTER_RANK_LOCAL std::vector<MPI_Request> deferred_requests;
+static CRITTER_RANK_LOCAL std::vector<std::vector<char>> deferred_buffers;
+static CRITTER_RANK_LOCAL std::vector<std::vector<char>> deferred_free_buffers;
+static CRITTER_RANK_LOCAL std::vector<int> deferred_indices;
+
+static char* allocate_deferred(size_t nbytes){
+  deferred_buffers.emplace_back();
+  if (deferred_free_buffers.size() > 0){
+    deferred_buffers.back().swap(deferred_free_buffers.back());
+    deferred_free_buffers.pop_back();
+  }
+  reserve_pad(deferred_buffers.back(),nbytes);
+  deferred_requests.push_back(MPI_REQUEST_NULL);
+  return &deferred_buffers.back()[0];
+}
+
+static void release_deferred(){
+  size_t count=0;
+  for (size_t i=0; i<deferred_requests.size(); i++){
+    if (deferred_requests[i] == MPI_REQUEST_NULL){
+      deferred_free_buffers.push_back(std::vector<char>());
+      deferred_free_buffers.back().swap(deferred_buffers[i]);
+      continue;
+    }
+    deferred_requests[count] = deferred_requests[i];
+    deferred_buffers[count].swap(deferred_buffers[i]);
+    count++;
+  }
+  deferred_requests.resize(count);
+  deferred_buffers.resize(count);
+}
+
+static void test_deferred(){
+  if (deferred_requests.size() == 0) return;
+  int outcount;
+  deferred_indices.resize(deferred_requests.size());
+  PMPI_Testsome(deferred_requests.size(),&deferred_requests[0],&outcount,&deferred_indices[0],MPI_STATUSES_IGNORE);
+  if (outcount > 0) release_deferred();
+}
+
+static void post_causal_send(MPI_Comm comm, int partner, bool send_path_data){
+  test_deferred();
+  if (send_path_data){
+    if (mechanism == 1){ deferral::mark(); }
+    char* path_data = allocate_deferred(get_piggyback_buffer_size());
+    if (use_path_records()){
+      size_t record_size = encode_path_record(&critical_path_costs[0],path_data,get_routine_mask(&critical_path_costs[0]));
+      PMPI_Isend(path_data, record_size, MPI_BYTE, partner, internal_tag2, comm, &deferred_requests.back());
+      internal_overhead_counter.message(record_size);
+    }
+    else{
+      std::memcpy(path_data, &critical_path_costs[0], critical_path_costs_size*sizeof(double));
+      PMPI_Isend(path_data, critical_path_costs_size, MPI_DOUBLE, partner, internal_tag2, comm, &deferred_requests.back());
+      internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+    }
+  }
+  if (symbol_data_propagates()){
+    int send_header[3];
+    size_t first_name = pack_symbol_header(comm,partner,send_header);
+    int data_len_size = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*send_header[0];
+    size_t message_size = get_symbol_message_size(send_header,data_len_size);
+    char* send_buffer = allocate_deferred(message_size);
+    pack_symbol_message(send_buffer,send_header,first_name,&symbol_timer_pad_local_cp[0],data_len_size);
+    PMPI_Isend(send_buffer,message_size,MPI_BYTE,partner,internal_tag5,comm,&deferred_requests.back());
+    internal_overhead_counter.message(message_size);
+  }
+}
+
+// A nonblocking sender has no use for the reply of its receiver, but must not wait on it, as the receiver may first wait on the completion of this sender's user communication
+static void post_handshake_reply_recv(MPI_Comm comm, int partner){
+  test_deferred();
+  double* reply = (double*)allocate_deferred(sizeof(double));
+  PMPI_Irecv(reply, 1, MPI_DOUBLE, partner, internal_tag4, comm, &deferred_requests.back());
+}
+
+static void post_causal_recv(MPI_Comm comm, int partner){
+  post_path_recv(comm,partner);
+  if (symbol_data_propagates()) post_symbol_recv(comm,partner);
+}
+
+// True if this process has no outstanding requests, and no propagations whose data has yet to be sent or merged
+static bool is_quiescent(){
+  test_deferred();
+  return (internal_comm_table.size() == 0) && (internal_comm_prop.size() == 0) && (deferred_requests.size() == 0);
+}
+
+// Estimates the offset of this process's MPI_Wtime from that of world rank 0 via round trips (Cristian's algorithm), keeping the estimate of the shortest round trip.
+//   Arrival timestamps exchanged by the p2p handshake are shifted by this offset so that they are comparable across processes.
+//   Processes that share a node with world rank 0 share its clock.
+static void measure_wtime_offset(){
+  wtime_offset = 0;
+  int* is_global; int flag;
+  MPI_Comm_get_attr(MPI_COMM_WORLD,MPI_WTIME_IS_GLOBAL,&is_global,&flag);
+  if (flag && (*is_global)) return;
+  int world_rank,world_size;
+  PMPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
+  PMPI_Comm_size(MPI_COMM_WORLD,&world_size);
+  comm_metadata& world = get_comm_metadata(MPI_COMM_WORLD);
+  const int num_rounds = 4;
+  if (world_rank == 0){
+    for (int i=1; i<world_size; i++){
+      if (world.is_node_local(i)) continue;
+      for (int j=0; j<num_rounds; j++){
+        PMPI_Recv(nullptr,0,MPI_CHAR,i,internal_tag5,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+        double reference_time = MPI_Wtime();
+        PMPI_Send(&reference_time,1,MPI_DOUBLE,i,internal_tag5,MPI_COMM_WORLD);
+      }
+    }
+  }
+  else if (!world.is_node_local(0)){
+    double min_round_trip = std::numeric_limits<double>::max();
+    for (int j=0; j<num_rounds; j++){
+      double reference_time;
+      double send_time = MPI_Wtime();
+      PMPI_Send(nullptr,0,MPI_CHAR,0,internal_tag5,MPI_COMM_WORLD);
+      PMPI_Recv(&reference_time,1,MPI_DOUBLE,0,internal_tag5,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+      double recv_time = MPI_Wtime();
+      if (recv_time-send_time < min_round_trip){
+        min_round_trip = recv_time-send_time;
+        wtime_offset = reference_time - (send_time+recv_time)/2.;
       }
     }
   }
 }
 
+void path::allocate(){
+  // Note: operator is declared non-commutative so that all processes apply 'decisions' in the same order
+  MPI_Op_create((MPI_User_function*) propagate_critical_path_op,0,&critical_path_op);
+  MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,delete_persistent_propagation,&persistent_propagation_keyval,nullptr);
+  if (track_p2p_idle==1) measure_wtime_offset();
+}
+
+void path::deallocate(){
+  // Communicators the user has yet to free (MPI_COMM_WORLD among them) still hold their persistent requests, so release them explicitly.
+  //   Each deletion removes its communicator from the list.
+  while (persistent_propagation_comms.size() > 0){ MPI_Comm_delete_attr(persistent_propagation_comms.back(),persistent_propagation_keyval); }
+  MPI_Comm_free_keyval(&persistent_propagation_keyval);
+  MPI_Op_free(&critical_path_op);
+  for (auto payload : piggyback_payloads){ delete[] payload; }
+  piggyback_payloads.clear();
+  // Every deferred request is matched by its partner upon completion of the user communication, which is never delayed by this process
+  PMPI_Waitall(deferred_requests.size(),&deferred_requests[0],MPI_STATUSES_IGNORE);
+  release_deferred();
+}
+
+// Marks an entry of 'internal_comm_prop' that holds path data already reduced over a communicator (never a path record), to be merged as is.
+//   Entries otherwise hold path data (or a record) sent (true) or received (false).
+static const int reduced_path_data = 2;
+
 static void complete_path_update(){
+  internal_overhead_counter.enter(overhead_path_update);
   PMPI_Waitall(internal_comm_prop_req.size(), &internal_comm_prop_req[0], MPI_STATUSES_IGNORE);
-  if (symbol_path_select_size>0) { PMPI_Waitall(internal_timer_prop_req.size(), &internal_timer_prop_req[0], MPI_STATUSES_IGNORE); }
+  // The local path data is about to be merged, so the breakdown accumulated since it was last sent must be attributable on its own
+  if ((mechanism == 1) && (internal_comm_prop.size() > 0)){ deferral::mark(); }
   size_t msg_id=0;
   for (auto& it : internal_comm_prop){
     if (!it.second){
-      if (symbol_path_select_size>0) complete_timers(it.first,msg_id++);
+      if (use_path_records()){
+        // The record is expanded in place, as its buffer was sized for both the largest record and the path data
+        reserve_pad(path_record_pad_recv,get_max_path_record_size());
+        std::memcpy(&path_record_pad_recv[0],it.first,get_max_path_record_size());
+        decode_path_record(&path_record_pad_recv[0],it.first);
+      }
+      if (symbol_data_propagates()) complete_timers(it.first,msg_id++);
+      update_critical_path(it.first,&critical_path_costs[0],critical_path_costs_size);
+    }
+    else if (it.second == reduced_path_data){
       update_critical_path(it.first,&critical_path_costs[0],critical_path_costs_size);
     }
-    free(it.first);
   }
+  // Symbol data is only waited on after the partners' symbol data has been received, as the sends may not complete before the matching receives are posted
+  if (symbol_data_propagates()) { PMPI_Waitall(internal_timer_prop_req.size(), &internal_timer_prop_req[0], MPI_STATUSES_IGNORE); }
   internal_comm_prop.clear(); internal_comm_prop_req.clear();
-  for (auto& it : internal_timer_prop_int){ free(it); }
-  for (auto& it : internal_timer_prop_double){ free(it); }
-  for (auto& it : internal_timer_prop_double_int){ free(it); }
-  for (auto& it : internal_timer_prop_char){ free(it); }
-  internal_timer_prop_int.clear(); internal_timer_prop_double.clear(); internal_timer_prop_double_int.clear();
-  internal_timer_prop_char.clear(); internal_timer_prop_req.clear();
+  internal_timer_prop_double_int.clear(); internal_timer_prop_req.clear(); internal_timer_prop_recv.clear();
+  // All envelopes have been received or sent, so their storage can be handed out again
+  internal_envelope_pool.recycle();
+  internal_overhead_counter.exit();
 }
 
 
 void path::initiate(blocking& tracker, volatile double curtime, int64_t nelem, MPI_Datatype t, MPI_Comm comm,
-                            bool is_sender, int partner1, int partner2){
+                            bool is_sender, int partner1, int partner2, int root){
   // Save and accumulate the computation time between last communication routine as both execution-time and computation time
   //   into both the execution-time critical path data structures and the per-process data structures.
   tracker.comp_time = curtime - computation_timer;
+  internal_overhead_counter.enter(overhead_initiate,tracker.tag);
 
   assert(comm != 0);
-  int rank; MPI_Comm_rank(comm, &rank);
+  int rank = get_comm_metadata(comm).rank;
   // We consider usage of Sendrecv variants to forfeit usage of eager internal communication.
   // Note that the reason we can't force user Bsends to be 'true_eager_p2p' is because the corresponding Receives would be expecting internal communications
   bool true_eager_p2p = ((eager_p2p == 1) && (tracker.tag!=13) && (tracker.tag!=14));
   if (true_eager_p2p){
-    MPI_Buffer_attach(&eager_pad[0],eager_pad.size());
+    attach_eager_pad(comm);
   }
 
   tracker.barrier_time=0.;// might get updated below
+  double p2p_synch_time=0.;// might get updated below
   if ((partner1==-1) || (track_p2p_idle==1)){// if blocking collective, or if p2p and idle time is requested to be tracked
-    assert(partner1 != MPI_ANY_SOURCE);
+    assert((tracker.tag < 13) || (partner1 != MPI_ANY_SOURCE));// collectives pass -1, which may equal MPI_ANY_SOURCE
     if ((tracker.tag == 13) || (tracker.tag == 14)){ assert(partner2 != MPI_ANY_SOURCE); }
 
     // Use a barrier or synchronous (rendezvous protocol) send/recv to track idle time (i.e. one process will be the latest to arrive at this segment of code, thus all other processes directly wait for it)
@@ -169,91 +667,86 @@ void path::initiate(blocking& tracker, volatile double curtime, int64_t nelem, M
     //   A user Sendrecv cannot be handled with separate Send+recv because a Sendrecv is implemented via nonblocking p2p in all MPI implementations as it is a construct used in part to prevent deadlock.
 
     volatile double init_time = MPI_Wtime();
-    if (partner1 == -1){ PMPI_Barrier(comm); }
+    if (partner1 == -1){
+      PMPI_Barrier(comm);
+      tracker.barrier_time = MPI_Wtime() - init_time;
+      internal_overhead_counter.message(0);
+    }
     else {
-      MPI_Request barrier_reqs[3]; int barrier_count=0;
-      char sbuf='H'; char rbuf='H';
+      // A single handshake replaces a barrier, an exchange of idle time, and a synchronization probe: each side sends its arrival timestamp to its partner
+      //   and, unless eager protocol is enabled, the receiver replies with its own. The latest arrival determines the idle time, and the remainder of the wait is synchronization time.
+      // Note that the sender's timestamp travels via synchronous send, so that the sender waits on the receiver even without a reply.
+      MPI_Request handshake_reqs[4]; int handshake_count=0;
+      double arrival = init_time + wtime_offset;
+      double partner_arrival[3] = {arrival,arrival,arrival};
       if ((is_sender) && (rank != partner1)){
-        if (true_eager_p2p) { PMPI_Bsend(&sbuf, 1, MPI_CHAR, partner1, internal_tag3, comm); }
-        else                { PMPI_Issend(&sbuf, 1, MPI_CHAR, partner1, internal_tag3, comm, &barrier_reqs[barrier_count]); barrier_count++; }
+        internal_overhead_counter.message(sizeof(double));
+        if (true_eager_p2p) { PMPI_Bsend(&arrival, 1, MPI_DOUBLE, partner1, internal_tag3, comm); }
+        else                { PMPI_Issend(&arrival, 1, MPI_DOUBLE, partner1, internal_tag3, comm, &handshake_reqs[handshake_count]); handshake_count++; }
+        if (eager_p2p==0){ PMPI_Irecv(&partner_arrival[0], 1, MPI_DOUBLE, partner1, internal_tag4, comm, &handshake_reqs[handshake_count]); handshake_count++; }
       }
       if ((!is_sender) && (rank != partner1)){
-        PMPI_Irecv(&rbuf, 1, MPI_CHAR, partner1, internal_tag3, comm, &barrier_reqs[barrier_count]); barrier_count++;
+        PMPI_Irecv(&partner_arrival[1], 1, MPI_DOUBLE, partner1, internal_tag3, comm, &handshake_reqs[handshake_count]); handshake_count++;
+        if (eager_p2p==0){ PMPI_Isend(&arrival, 1, MPI_DOUBLE, partner1, internal_tag4, comm, &handshake_reqs[handshake_count]); handshake_count++; internal_overhead_counter.message(sizeof(double)); }
       }
       if ((partner2 != -1) && (rank != partner2)){
-        PMPI_Irecv(&rbuf, 1, MPI_CHAR, partner2, internal_tag3, comm, &barrier_reqs[barrier_count]); barrier_count++;
+        PMPI_Irecv(&partner_arrival[2], 1, MPI_DOUBLE, partner2, internal_tag3, comm, &handshake_reqs[handshake_count]); handshake_count++;
+        if (eager_p2p==0){ PMPI_Isend(&arrival, 1, MPI_DOUBLE, partner2, internal_tag4, comm, &handshake_reqs[handshake_count]); handshake_count++; internal_overhead_counter.message(sizeof(double)); }
       }
-      PMPI_Waitall(barrier_count,&barrier_reqs[0],MPI_STATUSES_IGNORE);
+      PMPI_Waitall(handshake_count,&handshake_reqs[0],MPI_STATUSES_IGNORE);
+      double wait_time = MPI_Wtime() - init_time;
+      // Arrival timestamps are shifted onto the clock of world rank 0, yet the offset estimate has an error of up to half a round trip, so the idle time is bounded by the wait itself
+      double latest_arrival = std::max(partner_arrival[0],std::max(partner_arrival[1],partner_arrival[2]));
+      tracker.barrier_time = std::min(std::max(latest_arrival-arrival,0.),wait_time);
+      p2p_synch_time = wait_time - tracker.barrier_time;
     }
-    tracker.barrier_time = MPI_Wtime() - init_time;
-
     // If eager protocol is enabled, its assumed that any message latency the sender incurs is negligable, and thus the receiver incurs its true idle time above
-    // Again, the gray-area is with Sendrecv variants, and we assume they are treated without eager protocol
-    if (!true_eager_p2p){
+    if ((partner1 == -1) && (!true_eager_p2p)){
       // We need to subtract out the idle time of the path-root along the execution-time cp so that it appears as this path has no idle time.
       // Ideally we would do this for the last process to enter this barrier (which would always determine the execution-time cp anyway, but would apply for a path defined by any metric in its distribution).
-      // This is more invasive for p2p, because it requires more handling on the nonblocking side in case of a nonblocking+blocking communication pattern.
-      // TODO: This might function within a new 2-stage mechanism, which is where I want to go next. I think its more efficient as well. See notes.
       double min_idle_time=tracker.barrier_time;
-      double recv_idle_time1=std::numeric_limits<double>::max();
-      double recv_idle_time2=std::numeric_limits<double>::max();
-      if (partner1 == -1){ PMPI_Allreduce(MPI_IN_PLACE, &min_idle_time, 1, MPI_DOUBLE, MPI_MIN, comm); }
-      else {
-        MPI_Request barrier_reqs[3]; int barrier_count=0;
-        if ((is_sender) && (rank != partner1)){
-          PMPI_Issend(&min_idle_time, 1, MPI_DOUBLE, partner1, internal_tag4, comm, &barrier_reqs[barrier_count]); barrier_count++;
-        }
-        if ((!is_sender) && (rank != partner1)){
-          PMPI_Irecv(&recv_idle_time1, 1, MPI_DOUBLE, partner1, internal_tag4, comm, &barrier_reqs[barrier_count]); barrier_count++;
-        }
-        if ((partner2 != -1) && (rank != partner2)){
-          PMPI_Irecv(&recv_idle_time2, 1, MPI_DOUBLE, partner2, internal_tag4, comm, &barrier_reqs[barrier_count]); barrier_count++;
-        }
-        PMPI_Waitall(barrier_count,&barrier_reqs[0],MPI_STATUSES_IGNORE);
-        min_idle_time = std::min(min_idle_time,std::min(recv_idle_time1,recv_idle_time2));
-      }
+      PMPI_Allreduce(MPI_IN_PLACE, &min_idle_time, 1, MPI_DOUBLE, MPI_MIN, comm);
+      internal_overhead_counter.message(sizeof(double));
       tracker.barrier_time -= min_idle_time;
     }
-    for (size_t i=0; i<comm_path_select_size; i++){ critical_path_costs[critical_path_costs_size-1-i-comm_path_select_size] += tracker.barrier_time; }
+    for (size_t i=0; i<comm_path_select_size; i++){ critical_path_breakdown[critical_path_breakdown_size-1-i-comm_path_select_size] += tracker.barrier_time; }
   }
 
   critical_path_costs[num_critical_path_measures-2] += tracker.comp_time;	// update critical path computation time
   critical_path_costs[num_critical_path_measures-1] += tracker.comp_time;	// update critical path runtime
   volume_costs[num_volume_measures-2]        += tracker.comp_time;		// update local computation time
   volume_costs[num_volume_measures-1]        += tracker.comp_time;		// update local runtime
-  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_costs[critical_path_costs_size-1-i] += tracker.comp_time; }// update each metric's critical path's computation time
+  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_breakdown[critical_path_breakdown_size-1-i] += tracker.comp_time; }// update each metric's critical path's computation time
   if (symbol_path_select_size>0 && symbol_stack.size()>0){
     // Get the current symbol's execution-time since last communication routine or its inception.
     // Accumulate as both execution-time and computation time into both the execution-time critical path data structures and the per-process data structures.
-    auto last_symbol_time = curtime - symbol_timers[symbol_stack.top()].start_timer.top();
+    auto last_symbol_time = curtime - symbol_stack.top().start_time;
     for (auto i=0; i<symbol_path_select_size; i++){
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-1] += last_symbol_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-2] += last_symbol_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-1] += last_symbol_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-2] += last_symbol_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-1] += last_symbol_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-2] += last_symbol_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-1] += last_symbol_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-2] += last_symbol_time;
     }
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-1] += last_symbol_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-2] += last_symbol_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-1] += last_symbol_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-2] += last_symbol_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-1] += last_symbol_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-2] += last_symbol_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-1] += last_symbol_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-2] += last_symbol_time;
   }
 
   // Save caller communication attributes into reference object for use in corresponding static method 'complete'
-  int word_size,np; MPI_Type_size(t, &word_size);
+  int word_size = get_type_size(t);
+  int np = get_comm_metadata(comm).size;
   int64_t nbytes = word_size * nelem;
-  MPI_Comm_size(comm, &np);
   tracker.nbytes = nbytes;
   tracker.comm = comm;
   tracker.comm_size = np;
   tracker.is_sender = is_sender;
   tracker.partner1 = partner1;
   tracker.partner2 = partner2 != -1 ? partner2 : partner1;// Useful in propagation
-  tracker.synch_time = 0.;// might get updated below
-
-  if ((partner1==-1) || (track_p2p_idle==1)){// if blocking collective, or if p2p and idle time is requested to be tracked
-    assert(partner1 != MPI_ANY_SOURCE);
-    if ((tracker.tag == 13) || (tracker.tag == 14)){ assert(partner2 != MPI_ANY_SOURCE); }
+  tracker.root = root;
+  tracker.synch_time = p2p_synch_time;// p2p synchronization time is measured by the handshake above
 
+  if (partner1==-1){// if blocking collective
     // Use the user communication routine to measre synchronization time.
     // Note the following consequences of using a tiny 1-byte message (note that 0-byte is trivially handled by most MPI implementations) on measuring synchronization time:
     // 	1) The collective communication algorithm is likely different for small messages than large messages.
@@ -261,8 +754,7 @@ void path::initiate(blocking& tracker, volatile double curtime, int64_t nelem, M
     // 		On second thought. I will force usage of Ssend. TODO: Check whether this breaks any correctness semantics.
 
     // Special arrays for use in the collective -v routines as well as Reduce_scatter.
-    std::vector<int> counts(np,1); std::vector<int> disp(np,0);// TODO: could be moved as global variables
-    if (tracker.tag>=9 && tracker.tag<=12) for (int i=1; i<np; i++) disp[i]=disp[i-1]+1;
+    int* counts = &get_comm_metadata(comm).unit_counts[0]; int* disp = &get_comm_metadata(comm).unit_displs[0];
     // start synchronization timer for communication routine
     tracker.start_time = MPI_Wtime();
     switch (tracker.tag){
@@ -270,66 +762,51 @@ void path::initiate(blocking& tracker, volatile double curtime, int64_t nelem, M
         PMPI_Barrier(comm);
         break;
       case 1:
-        PMPI_Bcast(&synch_pad_send[0], 1, MPI_CHAR, 0, comm);// arbitrary root 0
+        PMPI_Bcast(&synch_pad_send[0], 1, MPI_CHAR, root, comm);
         break;
       case 2:
-        PMPI_Reduce(&synch_pad_send[0], &synch_pad_recv[0], 1, MPI_CHAR, MPI_MAX, 0, comm);// arbitrary root 0
+        PMPI_Reduce(&synch_pad_send[0], &synch_pad_recv[0], 1, MPI_CHAR, MPI_MAX, root, comm);
         break;
       case 3:
         PMPI_Allreduce(MPI_IN_PLACE, &synch_pad_send[0], 1, MPI_CHAR, MPI_MAX, comm);
         break;
       case 4:
-        PMPI_Gather(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, 0, comm);// arbitrary root 0
+        PMPI_Gather(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, root, comm);
         break;
       case 5:
         PMPI_Allgather(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, comm);
         break;
       case 6:
-        PMPI_Scatter(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, 0, comm);// arbitrary root 0
+        PMPI_Scatter(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, root, comm);
         break;
       case 7:
-        PMPI_Reduce_scatter(&synch_pad_send[0], &synch_pad_recv[0], &counts[0], MPI_CHAR, MPI_MAX, comm);
+        PMPI_Reduce_scatter(&synch_pad_send[0], &synch_pad_recv[0], counts, MPI_CHAR, MPI_MAX, comm);
         break;
       case 8:
         PMPI_Alltoall(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, comm);
         break;
       case 9:
-        PMPI_Gatherv(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], &counts[0], &disp[0], MPI_CHAR, 0, comm);// arbitrary root 0
+        PMPI_Gatherv(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], counts, disp, MPI_CHAR, root, comm);
         break;
       case 10:
-        PMPI_Allgatherv(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], &counts[0], &disp[0], MPI_CHAR, comm);
+        PMPI_Allgatherv(&synch_pad_send[0], 1, MPI_CHAR, &synch_pad_recv[0], counts, disp, MPI_CHAR, comm);
         break;
       case 11:
-        PMPI_Scatterv(&synch_pad_send[0], &counts[0], &disp[0], MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, 0, comm);// arbitrary root 0
+        PMPI_Scatterv(&synch_pad_send[0], counts, disp, MPI_CHAR, &synch_pad_recv[0], 1, MPI_CHAR, root, comm);
         break;
       case 12:
-        PMPI_Alltoallv(&synch_pad_send[0], &counts[0], &disp[0], MPI_CHAR, &synch_pad_recv[0], &counts[0], &disp[0], MPI_CHAR, comm);
-        break;
-      case 13:
-        PMPI_Sendrecv(&synch_pad_send[0], 1, MPI_CHAR, partner1, internal_tag, &synch_pad_recv[0], 1, MPI_CHAR, partner2, internal_tag, comm, MPI_STATUS_IGNORE);
-        break;
-      case 14:
-        PMPI_Sendrecv_replace(&synch_pad_send[0], 1, MPI_CHAR, partner1, internal_tag, partner2, internal_tag, comm, MPI_STATUS_IGNORE);
-        break;
-      case 15:
-        PMPI_Ssend(&synch_pad_send[0], 1, MPI_CHAR, partner1, internal_tag, comm);
-        break;
-      case 16:
-        if (true_eager_p2p) { PMPI_Bsend(&synch_pad_send[0], 1, MPI_CHAR, partner1, internal_tag, comm); }
-        else            { PMPI_Ssend(&synch_pad_send[0], 1, MPI_CHAR, partner1, internal_tag, comm); }// forced usage of synchronous send to avoid eager sends for large messages.
-        break;
-      case 17:
-        PMPI_Recv(&synch_pad_recv[0], 1, MPI_CHAR, partner1, internal_tag, comm, MPI_STATUS_IGNORE);
-        break;
-      case 32:
-        PMPI_Bsend(&synch_pad_send[0], 1, MPI_CHAR, partner1, internal_tag, comm);
+        PMPI_Alltoallv(&synch_pad_send[0], counts, disp, MPI_CHAR, &synch_pad_recv[0], counts, disp, MPI_CHAR, comm);
         break;
     }
     tracker.synch_time = MPI_Wtime()-tracker.start_time;
+    internal_overhead_counter.message(tracker.tag == 0 ? 0 : 1);
   }
 
   // start communication timer for communication routine
   tracker.start_time = MPI_Wtime();
+  // Idle time spent waiting on the other processes is the application's, even though it is spent within critter's probe
+  internal_overhead_counter.discount(tracker.barrier_time);
+  internal_overhead_counter.exit();
 }
 
 // Used only for p2p communication. All blocking collectives use sychronous protocol
@@ -344,7 +821,9 @@ void path::complete(blocking& tracker, int recv_source){
       tracker.partner1=recv_source;
     }
   }
-  volatile double comm_time = MPI_Wtime() - tracker.start_time;	// complete communication time
+  volatile double complete_time = MPI_Wtime();
+  volatile double comm_time = complete_time - tracker.start_time;	// complete communication time
+  internal_overhead_counter.enter(overhead_complete,tracker.tag);
   std::pair<double,double> cost_bsp    = tracker.cost_func_bsp(tracker.nbytes, tracker.comm_size);
   std::pair<double,double> cost_alphabeta = tracker.cost_func_alphabeta(tracker.nbytes, tracker.comm_size);
   std::vector<std::pair<double,double>> costs = {cost_bsp,cost_alphabeta};
@@ -383,41 +862,41 @@ void path::complete(blocking& tracker, int recv_source){
       size_t save=0;
       for (int j=0; j<cost_models.size(); j++){
         if (cost_models[j]=='1'){
-          symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][save] += costs[j].second;
-          symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][cost_models.size()+save] += costs[j].first;
-          symbol_timers[symbol_stack.top()].cp_excl_measure[i][save] += costs[j].second;
-          symbol_timers[symbol_stack.top()].cp_excl_measure[i][cost_models.size()+save] += costs[j].first;
+          symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][save] += costs[j].second;
+          symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][cost_models.size()+save] += costs[j].first;
+          symbol_timers[symbol_stack.top().index].cp_excl_measure[i][save] += costs[j].second;
+          symbol_timers[symbol_stack.top().index].cp_excl_measure[i][cost_models.size()+save] += costs[j].first;
         }
         save++;
       }
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-5] += tracker.barrier_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-4] += comm_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-3] += tracker.synch_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-1] += comm_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-5] += tracker.barrier_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-4] += comm_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-3] += tracker.synch_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-1] += comm_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-5] += tracker.barrier_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-4] += comm_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-3] += tracker.synch_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-1] += comm_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-5] += tracker.barrier_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-4] += comm_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-3] += tracker.synch_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-1] += comm_time;
     }
     // update all communication-related measures for the top symbol in stack
     size_t save=0;
     for (int j=0; j<cost_models.size(); j++){
       if (cost_models[j]=='1'){
-        symbol_timers[symbol_stack.top()].pp_exclusive_measure[save] += costs[j].second;
-        symbol_timers[symbol_stack.top()].pp_exclusive_measure[cost_models.size()+save] += costs[j].first;
-        symbol_timers[symbol_stack.top()].pp_excl_measure[save] += costs[j].second;
-        symbol_timers[symbol_stack.top()].pp_excl_measure[cost_models.size()+save] += costs[j].first;
+        symbol_timers[symbol_stack.top().index].pp_exclusive_measure[save] += costs[j].second;
+        symbol_timers[symbol_stack.top().index].pp_exclusive_measure[cost_models.size()+save] += costs[j].first;
+        symbol_timers[symbol_stack.top().index].pp_excl_measure[save] += costs[j].second;
+        symbol_timers[symbol_stack.top().index].pp_excl_measure[cost_models.size()+save] += costs[j].first;
       }
       save++;
     }
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-5] += tracker.barrier_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-4] += comm_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-3] += tracker.synch_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-1] += (comm_time+tracker.barrier_time);
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-5] += tracker.barrier_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-4] += comm_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-3] += tracker.synch_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-1] += (comm_time+tracker.barrier_time);
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-5] += tracker.barrier_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-4] += comm_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-3] += tracker.synch_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-1] += (comm_time+tracker.barrier_time);
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-5] += tracker.barrier_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-4] += comm_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-3] += tracker.synch_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-1] += (comm_time+tracker.barrier_time);
   }
 
   // Update measurements that define the critical path for each metric.
@@ -448,10 +927,10 @@ void path::complete(blocking& tracker, int recv_source){
   if (symbol_path_select_size>0 && symbol_stack.size()>0){
     // Special handling of excessively large idle time caused by suspected tool interference
     // Specifically, this interference is caused by not subtracting out the barrier time of the last process to enter the barrier (which ideally is 0).
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-1] -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-1]     -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-5] -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-5]     -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-1] -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-1]     -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-5] -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-5]     -= std::max(0.,volume_costs[num_volume_measures-1]-critical_path_costs[num_critical_path_measures-1]);
   }
 
   // Due to granularity of timing, if a per-process measure ever gets more expensive than a critical path measure, we set the per-process measure to the cp measure
@@ -465,59 +944,95 @@ void path::complete(blocking& tracker, int recv_source){
                                           ? critical_path_costs[num_critical_path_measures-1] : volume_costs[num_volume_measures-1];
 
   // Propogate critical paths for all processes in communicator based on what each process has seen up until now (not including this communication)
-  propagate(tracker);
+  if ((causal_p2p==1) && (tracker.partner1 != -1)){
+    // Path data flows from sender to receiver only: Recv receives from 'partner1', the Sendrecv variants send to 'partner1' and receive from 'partner2'
+    int rank = get_comm_metadata(tracker.comm).rank;
+    int source = (tracker.tag==17) ? tracker.partner1 : tracker.partner2;
+    if ((tracker.tag!=17) && (rank != tracker.partner1)){ post_causal_send(tracker.comm,tracker.partner1,piggyback_p2p==0); }
+    if (((tracker.tag==13) || (tracker.tag==14) || (tracker.tag==17)) && (rank != source)){
+      if (piggyback_p2p==1) { post_piggyback_recv(tracker.comm,source,&piggyback_pad_recv[0]); }
+      else                  { post_causal_recv(tracker.comm,source); }
+      complete_path_update();
+    }
+  }
+  else if (tracker.partner1 != -1){ propagate(tracker); }
+  else{
+    // The overhead governor only changes what is propagated at collectives over all processes, and only once no process has propagations in flight
+    if (internal_overhead_governor.is_due(tracker.comm)){ internal_overhead_governor.update(tracker.comm,is_quiescent()); }
+    // With CRITTER_SAMPLE_RATE>1, collectives that are not sampled leave the path data of each process as is
+    if (internal_path_sampler.select(tracker.comm)){
+      internal_path_sampler.start(&critical_path_costs[0]);
+      propagate(tracker);
+      internal_path_sampler.stop(&critical_path_costs[0]);
+    }
+  }
 
   // Save the communication pattern
   if (opt && symbol_path_select_size>0 && symbol_stack.size()>0){
     //TODO: we will assume both costs models are chosen.
     std::vector<double> measurements = {costs[0].second,costs[0].first,costs[1].second,costs[1].first,tracker.barrier_time,comm_time,tracker.synch_time,tracker.comp_time,tracker.comp_time+comm_time};
-    event_list.push_back(event(symbol_stack.top(),std::move(measurements),tracker.tag,tracker.comm,tracker.partner1,tracker.partner2,tracker.is_sender,eager_p2p));
+    event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,std::move(measurements),tracker.tag,tracker.comm,tracker.partner1,tracker.partner2,tracker.is_sender,eager_p2p));
   }
 
   // Prepare to leave interception and re-enter user code by restarting computation timers.
   tracker.start_time = MPI_Wtime();
   computation_timer = tracker.start_time;
-  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_timers[symbol_stack.top()].start_timer.top() = tracker.start_time; }
+  internal_overhead_counter.exit();
+  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_stack.top().start_time = tracker.start_time; }
 }
 
 // Called by both nonblocking p2p and nonblocking collectives
 void path::initiate(nonblocking& tracker, volatile double curtime, volatile double itime, int64_t nelem,
-                            MPI_Datatype t, MPI_Comm comm, MPI_Request* request, bool is_sender, int partner){
+                            MPI_Datatype t, MPI_Comm comm, MPI_Request* request, bool is_sender, int partner, int root){
 
   // Deal with computational cost at the beginning, but don't synchronize to find computation-critical path-path yet or that will screw up calculation of overlap!
   tracker.comp_time = curtime - computation_timer + itime;
+  internal_overhead_counter.enter(overhead_initiate,tracker.tag);
   critical_path_costs[num_critical_path_measures-2] += tracker.comp_time;		// update critical path computation time
   critical_path_costs[num_critical_path_measures-1] += tracker.comp_time;		// update critical path runtime
   volume_costs[num_volume_measures-2]        += tracker.comp_time;		// update local computation time
   volume_costs[num_volume_measures-1]        += tracker.comp_time;		// update local runtime
-  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_costs[critical_path_costs_size-1-i] += tracker.comp_time; }
+  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_breakdown[critical_path_breakdown_size-1-i] += tracker.comp_time; }
   if (symbol_path_select_size>0 && symbol_stack.size()>0){
     assert(symbol_stack.size()>0);
-    assert(symbol_timers[symbol_stack.top()].start_timer.size()>0);
-    double save_time = curtime - symbol_timers[symbol_stack.top()].start_timer.top()+itime;
+    double save_time = curtime - symbol_stack.top().start_time+itime;
     for (auto i=0; i<symbol_path_select_size; i++){
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-1] += save_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-2] += save_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-1] += save_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-2] += save_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-1] += save_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-2] += save_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-1] += save_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-2] += save_time;
     }
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-1] += save_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-2] += save_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_volume_measures-1] += save_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_volume_measures-2] += save_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-1] += save_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-2] += save_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_volume_measures-1] += save_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_volume_measures-2] += save_time;
   }
 
-  int el_size,p;
-  MPI_Type_size(t, &el_size);
+  int el_size = get_type_size(t);
+  int p = get_comm_metadata(comm).size;
   int64_t nbytes = el_size * nelem;
-  MPI_Comm_size(comm, &p);
 
-  internal_comm_info[*request] = std::make_pair(is_sender,event_list_size++);
-  internal_comm_comm[*request] = std::make_pair(comm,partner);// Note 'partner' might be MPI_ANY_SOURCE
-  internal_comm_data[*request] = std::make_pair((double)nbytes,(double)p);
-  internal_comm_track[*request] = &tracker;
-
-  if (eager_p2p==1){
+  request_slot* slot = internal_comm_table.insert(*request);
+  slot->is_sender = is_sender;
+  slot->id = event_list_size++;
+  slot->comm = comm;
+  slot->partner = partner;// Note 'partner' might be MPI_ANY_SOURCE
+  slot->root = root;
+  slot->nbytes = nbytes;
+  slot->comm_size = p;
+  slot->track = &tracker;
+  slot->payload = pending_payload;
+  slot->payload_type = pending_payload_type;
+  slot->type = t;
+  slot->is_sampled = (tracker.tag < 20) || internal_path_sampler.select(comm);
+  pending_payload = nullptr;
+  pending_payload_type = MPI_DATATYPE_NULL;
+
+  // A causal sender propagates upon posting its request, as its own completion may wait on the receiver, whose completion waits on this propagation
+  if ((causal_p2p==1) && (partner != -1) && is_sender && (get_comm_metadata(comm).rank != partner)){
+    post_causal_send(comm,partner,slot->payload==nullptr);
+  }
+  if ((eager_p2p==1) && slot->is_sampled){
     tracker.comm = comm;
     tracker.is_sender = is_sender;
     tracker.partner1 = partner;
@@ -532,33 +1047,28 @@ void path::initiate(nonblocking& tracker, volatile double curtime, volatile doub
     //TODO: we will assume both costs models are chosen.
     std::vector<double> measurements = {0.,0.,0.,0.,0.,0.,0.,tracker.comp_time,tracker.comp_time};
     if (eager_p2p){
-      event_list.push_back(event(symbol_stack.top(),std::move(measurements),tracker.tag,comm,partner,is_sender,eager_p2p,event_list_size-1,true));
+      event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,std::move(measurements),tracker.tag,comm,partner,is_sender,eager_p2p,event_list_size-1,true));
     } else{
-      event_list.push_back(event(symbol_stack.top(),std::move(measurements)));
+      event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,std::move(measurements)));
     }
   }
 
   tracker.start_time = MPI_Wtime();
   computation_timer = tracker.start_time;
-  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_timers[symbol_stack.top()].start_timer.top() = tracker.start_time; }
-}
-
-void path::complete(nonblocking& tracker, MPI_Request* request, double comp_time, double comm_time){
-  auto comm_info_it = internal_comm_info.find(*request);
-  auto comm_comm_it = internal_comm_comm.find(*request);
-  auto comm_data_it = internal_comm_data.find(*request);
-  auto comm_track_it = internal_comm_track.find(*request);
-  assert(comm_info_it != internal_comm_info.end());
-  assert(comm_comm_it != internal_comm_comm.end());
-  assert(comm_data_it != internal_comm_data.end());
-  assert(comm_track_it != internal_comm_track.end());
-
-  tracker.is_sender = comm_info_it->second.first;
-  tracker.comm = comm_comm_it->second.first;
-  tracker.partner1 = comm_comm_it->second.second;
+  internal_overhead_counter.exit();
+  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_stack.top().start_time = tracker.start_time; }
+}
+
+// Expects 'slot' to have already been removed from 'internal_comm_table', with 'slot.partner' resolved if posted with MPI_ANY_SOURCE
+void path::complete(request_slot const& slot, double comp_time, double comm_time, bool propagate_slot){
+  nonblocking& tracker = *slot.track;
+  tracker.is_sender = slot.is_sender;
+  tracker.comm = slot.comm;
+  tracker.partner1 = slot.partner;
   tracker.partner2 = -1;
-  tracker.nbytes = comm_data_it->second.first;
-  tracker.comm_size = comm_data_it->second.second;
+  tracker.root = slot.root;
+  tracker.nbytes = slot.nbytes;
+  tracker.comm_size = slot.comm_size;
   tracker.synch_time=0;
 
   // Both sender and receiver will now update its critical path with the data from the communication
@@ -582,7 +1092,7 @@ void path::complete(nonblocking& tracker, MPI_Request* request, double comp_time
   critical_path_costs[num_critical_path_measures-3] += 0.;				// update critical path synchronization time
   critical_path_costs[num_critical_path_measures-2] += comp_time;			// update critical path runtime
   critical_path_costs[num_critical_path_measures-1] += comp_time+comm_time;		// update critical path runtime
-  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_costs[critical_path_costs_size-1-i] += comp_time; }
+  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_breakdown[critical_path_breakdown_size-1-i] += comp_time; }
 
   volume_costs[num_volume_measures-4] += comm_time;				// update local communication time (not volume until after the completion of the program)
   volume_costs[num_volume_measures-3] += 0.;					// update local synchronization time
@@ -632,54 +1142,60 @@ void path::complete(nonblocking& tracker, MPI_Request* request, double comp_time
       size_t save=0;
       for (int j=0; j<cost_models.size(); j++){
         if (cost_models[j]=='1'){
-          symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][save] += costs[j].second;
-          symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][cost_models.size()+save] += costs[j].first;
-          symbol_timers[symbol_stack.top()].cp_excl_measure[i][save] += costs[j].second;
-          symbol_timers[symbol_stack.top()].cp_excl_measure[i][cost_models.size()+save] += costs[j].first;
+          symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][save] += costs[j].second;
+          symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][cost_models.size()+save] += costs[j].first;
+          symbol_timers[symbol_stack.top().index].cp_excl_measure[i][save] += costs[j].second;
+          symbol_timers[symbol_stack.top().index].cp_excl_measure[i][cost_models.size()+save] += costs[j].first;
         }
         save++;
       }
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-4] += comm_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-3] += 0.;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-2] += comp_time;
-      symbol_timers[symbol_stack.top()].cp_exclusive_measure[i][num_per_process_measures-1] += (comp_time+comm_time);
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-4] += comm_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-3] += 0.;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-2] += comp_time;
-      symbol_timers[symbol_stack.top()].cp_excl_measure[i][num_per_process_measures-1] += (comp_time+comm_time);
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-4] += comm_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-3] += 0.;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-2] += comp_time;
+      symbol_timers[symbol_stack.top().index].cp_exclusive_measure[i][num_per_process_measures-1] += (comp_time+comm_time);
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-4] += comm_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-3] += 0.;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-2] += comp_time;
+      symbol_timers[symbol_stack.top().index].cp_excl_measure[i][num_per_process_measures-1] += (comp_time+comm_time);
     }
     // update all communication-related measures for the top symbol in stack
     size_t save=0;
     for (int j=0; j<cost_models.size(); j++){
       if (cost_models[j]=='1'){
-        symbol_timers[symbol_stack.top()].pp_exclusive_measure[save] += costs[j].second;
-        symbol_timers[symbol_stack.top()].pp_exclusive_measure[cost_models.size()+save] += costs[j].first;
-        symbol_timers[symbol_stack.top()].pp_excl_measure[save] += costs[j].second;
-        symbol_timers[symbol_stack.top()].pp_excl_measure[cost_models.size()+save] += costs[j].first;
+        symbol_timers[symbol_stack.top().index].pp_exclusive_measure[save] += costs[j].second;
+        symbol_timers[symbol_stack.top().index].pp_exclusive_measure[cost_models.size()+save] += costs[j].first;
+        symbol_timers[symbol_stack.top().index].pp_excl_measure[save] += costs[j].second;
+        symbol_timers[symbol_stack.top().index].pp_excl_measure[cost_models.size()+save] += costs[j].first;
       }
       save++;
     }
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-4] += comm_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-3] += 0.;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-3] += comp_time;
-    symbol_timers[symbol_stack.top()].pp_exclusive_measure[num_per_process_measures-1] += (comp_time+comm_time);
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-4] += comm_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-3] += 0.;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-2] += comp_time;
-    symbol_timers[symbol_stack.top()].pp_excl_measure[num_per_process_measures-1] += (comp_time+comm_time);
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-4] += comm_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-3] += 0.;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-3] += comp_time;
+    symbol_timers[symbol_stack.top().index].pp_exclusive_measure[num_per_process_measures-1] += (comp_time+comm_time);
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-4] += comm_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-3] += 0.;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-2] += comp_time;
+    symbol_timers[symbol_stack.top().index].pp_excl_measure[num_per_process_measures-1] += (comp_time+comm_time);
   }
 
-  if (eager_p2p==0) { propagate(tracker); }
-
-  internal_comm_info.erase(*request);
-  internal_comm_comm.erase(*request);
-  internal_comm_data.erase(*request);
-  internal_comm_track.erase(*request);
+  if ((causal_p2p==1) && (slot.partner != -1)){
+    if ((!slot.is_sender) && (get_comm_metadata(slot.comm).rank != slot.partner)){
+      if (slot.payload != nullptr) { post_piggyback_recv(slot.comm,slot.partner,slot.payload); }
+      else                         { post_causal_recv(slot.comm,slot.partner); }
+    }
+    if (slot.payload != nullptr){
+      piggyback_payloads.push_back(slot.payload);
+      MPI_Datatype payload_type = slot.payload_type;
+      MPI_Type_free(&payload_type);
+    }
+  }
+  else if ((eager_p2p==0) && propagate_slot && slot.is_sampled) { propagate(tracker); }
 
   // Save the match to the array
   if (opt && symbol_path_select_size>0 && symbol_stack.size()>0){
     if (eager_p2p){
-      opt_req_match.push_back(comm_info_it->second.second);
+      opt_req_match.push_back(slot.id);
       opt_measure_match[num_per_process_measures-9] += costs[0].second;
       opt_measure_match[num_per_process_measures-8] += costs[0].first;
       opt_measure_match[num_per_process_measures-7] += costs[1].second;
@@ -693,7 +1209,7 @@ void path::complete(nonblocking& tracker, MPI_Request* request, double comp_time
     if (!eager_p2p){
       //TODO: we will assume both costs models are chosen.
       std::vector<double> measurements(num_per_process_measures,0.);
-      event_list.push_back(event(symbol_stack.top(),measurements,tracker.tag,tracker.comm,tracker.partner1,tracker.is_sender,eager_p2p,event_list_size++,true));
+      event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,measurements,tracker.tag,tracker.comm,tracker.partner1,tracker.is_sender,eager_p2p,event_list_size++,true));
       opt_req_match.push_back(event_list_size-1);
       opt_measure_match[num_per_process_measures-9] += costs[0].second;
       opt_measure_match[num_per_process_measures-8] += costs[0].first;
@@ -710,48 +1226,61 @@ void path::complete(nonblocking& tracker, MPI_Request* request, double comp_time
   tracker.start_time = MPI_Wtime();
 }
 
+// Some MPI implementations define MPI_ANY_SOURCE as -1, which also marks the requests of nonblocking collectives (whose trackers follow those of p2p)
+static inline bool is_wildcard_p2p(request_slot const& slot){
+  return (slot.partner == MPI_ANY_SOURCE) && (slot.track->tag < 20);
+}
+
 void path::complete(double curtime, MPI_Request* request, MPI_Status* status){
   double comp_time = curtime - computation_timer;
-  auto comm_track_it = internal_comm_track.find(*request);
-  assert(comm_track_it != internal_comm_track.end());
-  auto comm_info_it = internal_comm_info.find(*request);
-  auto comm_comm_it = internal_comm_comm.find(*request);
-  MPI_Request save_request = comm_info_it->first;
-  if ((comm_comm_it->second.second!=-1) && (track_p2p_idle==1)){// if p2p and idle time is requested to be tracked (first case prevents nonblocking collectives
-    assert(comm_comm_it->second.first != 0);
-    int comm_rank; MPI_Comm_rank(comm_comm_it->second.first,&comm_rank); 
-    double max_barrier_time = 0;// counter-intuitively, a blocking partner should determine the idle time
-    if (comm_info_it->second.first && comm_rank != comm_comm_it->second.second){
-      PMPI_Send(&barrier_pad_send[0], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag3, comm_comm_it->second.first);
-      PMPI_Send(&max_barrier_time, 1, MPI_DOUBLE, comm_comm_it->second.second, internal_tag4, comm_comm_it->second.first);
-      PMPI_Send(&synch_pad_send[0], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag, comm_comm_it->second.first);
-    }
-    else if (!comm_info_it->second.first && comm_rank != comm_comm_it->second.second){
-      PMPI_Recv(&barrier_pad_recv[0], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag3, comm_comm_it->second.first, MPI_STATUS_IGNORE);
-      PMPI_Recv(&max_barrier_time, 1, MPI_DOUBLE, comm_comm_it->second.second, internal_tag4, comm_comm_it->second.first, MPI_STATUS_IGNORE);
-      PMPI_Recv(&synch_pad_recv[0], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag, comm_comm_it->second.first, MPI_STATUS_IGNORE);
+  internal_overhead_counter.enter(overhead_complete,overhead_wait);
+  // We must save the request state before the completition of a request by the MPI implementation because its handle is set to MPI_REQUEST_NULL and lost forever
+  request_slot* slot_it = internal_comm_table.find(*request);
+  assert(slot_it != nullptr);
+  request_slot slot = *slot_it;
+  internal_comm_table.erase(slot_it);
+  if ((slot.partner!=-1) && (track_p2p_idle==1)){// if p2p and idle time is requested to be tracked (first case prevents nonblocking collectives
+    assert(slot.comm != 0);
+    int comm_rank = get_comm_metadata(slot.comm).rank;
+    // A nonblocking partner takes part in the handshake of a blocking partner, which alone determines the idle time
+    double arrival = MPI_Wtime() + wtime_offset; double partner_arrival;
+    MPI_Request handshake_reqs[2]; int handshake_count=0;
+    if (slot.is_sender && comm_rank != slot.partner){
+      PMPI_Isend(&arrival, 1, MPI_DOUBLE, slot.partner, internal_tag3, slot.comm, &handshake_reqs[handshake_count]); handshake_count++;
+      internal_overhead_counter.message(sizeof(double));
+      if (eager_p2p==0) { post_handshake_reply_recv(slot.comm,slot.partner); }
+    }
+    else if (!slot.is_sender && comm_rank != slot.partner){
+      PMPI_Irecv(&partner_arrival, 1, MPI_DOUBLE, slot.partner, internal_tag3, slot.comm, &handshake_reqs[handshake_count]); handshake_count++;
+      if (eager_p2p==0) { PMPI_Isend(&arrival, 1, MPI_DOUBLE, slot.partner, internal_tag4, slot.comm, &handshake_reqs[handshake_count]); handshake_count++; internal_overhead_counter.message(sizeof(double)); }
     }
+    PMPI_Waitall(handshake_count, &handshake_reqs[0], MPI_STATUSES_IGNORE);
   }
   volatile double last_start_time = MPI_Wtime();
   PMPI_Wait(request, status);
-  double save_comm_time = MPI_Wtime() - last_start_time;
+  volatile double wait_end_time = MPI_Wtime();
+  double save_comm_time = wait_end_time - last_start_time;
+  if ((slot.payload != nullptr) && (!slot.is_sender)) { correct_piggyback_status(status,slot.payload_type,slot.type); }
   if (eager_p2p==1) { complete_path_update(); }
-  if (comm_comm_it->second.second == MPI_ANY_SOURCE) { comm_track_it->second->partner1 = status->MPI_SOURCE; }
+  if (is_wildcard_p2p(slot)) { slot.partner = status->MPI_SOURCE; }
   opt_measure_match.resize(num_per_process_measures,0.);
-  complete(*comm_track_it->second, &save_request, comp_time, save_comm_time);
+  complete(slot, comp_time, save_comm_time);
   if (eager_p2p==0) { complete_path_update(); }
   if (opt && symbol_path_select_size>0 && symbol_stack.size()>0){
-    event_list.push_back(event(symbol_stack.top(),opt_measure_match,opt_req_match));
+    event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,opt_measure_match,opt_req_match));
     opt_req_match.clear();
     opt_measure_match.clear();
   }
   computation_timer = MPI_Wtime();
-  if (symbol_path_select_size>0){ symbol_timers[symbol_stack.top()].start_timer.top() = computation_timer; }
+  internal_overhead_counter.discount(wait_end_time - last_start_time);
+  internal_overhead_counter.exit();
+  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_stack.top().start_time = computation_timer; }
 }
 
 void path::complete(double curtime, int count, MPI_Request array_of_requests[], int* indx, MPI_Status* status){
 
   double waitany_comp_time = curtime - computation_timer;
+  internal_overhead_counter.enter(overhead_complete,overhead_waitany);
   // We must force 'track_p2p_idle' to be zero because we don't know which request the MPI implementation will choose before
   //   it chooses it. Note that this is a not a problem for MPI_Waitall because all requests are chosen.
   //   Thus, we cannot participate in any idle/synch time exchanges. This is not a big deal at all if MPI_Waitany
@@ -764,29 +1293,34 @@ void path::complete(double curtime, int count, MPI_Request array_of_requests[],
   std::vector<MPI_Request> pt(count); for (int i=0;i<count;i++){pt[i]=(array_of_requests)[i];}
   volatile double last_start_time = MPI_Wtime();
   PMPI_Waitany(count,array_of_requests,indx,status);
-  double waitany_comm_time = MPI_Wtime() - last_start_time;
+  volatile double wait_end_time = MPI_Wtime();
+  double waitany_comm_time = wait_end_time - last_start_time;
   if (eager_p2p==1) { complete_path_update(); }
-  MPI_Request request = pt[*indx];
-  auto comm_track_it = internal_comm_track.find(request);
-  auto comm_comm_it = internal_comm_comm.find(request);
-  assert(comm_track_it != internal_comm_track.end());
-  if (comm_comm_it->second.second == MPI_ANY_SOURCE) { comm_track_it->second->partner1 = status->MPI_SOURCE; }
+  request_slot* slot_it = internal_comm_table.find(pt[*indx]);
+  assert(slot_it != nullptr);
+  request_slot slot = *slot_it;
+  internal_comm_table.erase(slot_it);
+  if ((slot.payload != nullptr) && (!slot.is_sender)) { correct_piggyback_status(status,slot.payload_type,slot.type); }
+  if (is_wildcard_p2p(slot)) { slot.partner = status->MPI_SOURCE; }
   opt_measure_match.resize(num_per_process_measures,0.);
-  complete(*comm_track_it->second, &request, waitany_comp_time, waitany_comm_time);
+  complete(slot, waitany_comp_time, waitany_comm_time);
   if (eager_p2p==0) { complete_path_update(); }
   if (opt && symbol_path_select_size>0 && symbol_stack.size()>0){
-    event_list.push_back(event(symbol_stack.top(),opt_measure_match,opt_req_match));
+    event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,opt_measure_match,opt_req_match));
     opt_req_match.clear();
     opt_measure_match.clear();
   }
   computation_timer = MPI_Wtime();
-  if (symbol_path_select_size>0){ symbol_timers[symbol_stack.top()].start_timer.top() = computation_timer; }
+  internal_overhead_counter.discount(wait_end_time - last_start_time);
+  internal_overhead_counter.exit();
+  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_stack.top().start_time = computation_timer; }
 }
 
 void path::complete(double curtime, int incount, MPI_Request array_of_requests[], int* outcount, int array_of_indices[],
                         MPI_Status array_of_statuses[]){
 
   double waitsome_comp_time = curtime - computation_timer;
+  internal_overhead_counter.enter(overhead_complete,overhead_waitsome);
   wait_id=true;
   // Read comment in function above. Same ideas apply for Waitsome.
   assert(track_p2p_idle==0);
@@ -794,42 +1328,80 @@ void path::complete(double curtime, int incount, MPI_Request array_of_requests[]
   std::vector<MPI_Request> pt(incount); for (int i=0;i<incount;i++){pt[i]=(array_of_requests)[i];}
   volatile double last_start_time = MPI_Wtime();
   PMPI_Waitsome(incount,array_of_requests,outcount,array_of_indices,array_of_statuses);
-  double waitsome_comm_time = MPI_Wtime() - last_start_time;
+  volatile double wait_end_time = MPI_Wtime();
+  double waitsome_comm_time = wait_end_time - last_start_time;
   if (eager_p2p==1) { complete_path_update(); }
   opt_measure_match.resize(num_per_process_measures,0.);
   for (int i=0; i<*outcount; i++){
-    MPI_Request request = pt[(array_of_indices)[i]];
-    auto comm_track_it = internal_comm_track.find(request);
-    auto comm_comm_it = internal_comm_comm.find(request);
-    assert(comm_track_it != internal_comm_track.end());
-    if (comm_comm_it->second.second == MPI_ANY_SOURCE) { comm_track_it->second->partner1 = (array_of_statuses)[i].MPI_SOURCE; }
-    complete(*comm_track_it->second, &request, waitsome_comp_time, waitsome_comm_time);
+    request_slot* slot_it = internal_comm_table.find(pt[(array_of_indices)[i]]);
+    assert(slot_it != nullptr);
+    request_slot slot = *slot_it;
+    internal_comm_table.erase(slot_it);
+    if ((slot.payload != nullptr) && (!slot.is_sender) && (array_of_statuses != MPI_STATUSES_IGNORE)){
+      correct_piggyback_status(&array_of_statuses[i],slot.payload_type,slot.type);
+    }
+    if (is_wildcard_p2p(slot)) { slot.partner = (array_of_statuses)[i].MPI_SOURCE; }
+    complete(slot, waitsome_comp_time, waitsome_comm_time);
     waitsome_comp_time=0;
     waitsome_comm_time=0;
     if (i==0){wait_id=false;}
   }
   if (eager_p2p==0) { complete_path_update(); }
   if (opt && symbol_path_select_size>0 && symbol_stack.size()>0){
-    event_list.push_back(event(symbol_stack.top(),opt_measure_match,opt_req_match));
+    event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,opt_measure_match,opt_req_match));
     opt_req_match.clear();
     opt_measure_match.clear();
   }
   computation_timer = MPI_Wtime();
-  if (symbol_path_select_size>0){ symbol_timers[symbol_stack.top()].start_timer.top() = computation_timer; }
+  internal_overhead_counter.discount(wait_end_time - last_start_time);
+  internal_overhead_counter.exit();
+  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_stack.top().start_time = computation_timer; }
+}
+
+// Requests of a Waitall that share a communicator and partner form a batch (CRITTER_BATCH_WAITALL=1), whose first request performs the internal communication on behalf of all.
+//   Otherwise each p2p request forms its own batch. Nonblocking collectives belong to no batch, which is marked by -1.
+static void get_batch_leads(std::vector<request_slot> const& pt, std::vector<int>& batch_lead){
+  batch_lead.assign(pt.size(),-1);
+  std::vector<int> order;
+  for (size_t i=0; i<pt.size(); i++){
+    if (pt[i].partner == -1) continue;
+    if (batch_waitall==0) { batch_lead[i]=i; }
+    else                  { order.push_back(i); }
+  }
+  std::stable_sort(order.begin(),order.end(),[&](int a, int b){
+    return std::make_pair(pt[a].comm,pt[a].partner) < std::make_pair(pt[b].comm,pt[b].partner); });
+  for (size_t i=0; i<order.size(); i++){
+    bool same_batch = (i>0) && (pt[order[i-1]].comm == pt[order[i]].comm) && (pt[order[i-1]].partner == pt[order[i]].partner);
+    batch_lead[order[i]] = same_batch ? batch_lead[order[i-1]] : order[i];
+  }
 }
 
 void path::complete(double curtime, int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]){
   double waitall_comp_time = curtime - computation_timer;
+  internal_overhead_counter.enter(overhead_complete,overhead_waitall);
   wait_id=true;
+  // We must save the request state before the completition of a request by the MPI implementation because its handle is set to MPI_REQUEST_NULL and lost forever
+  std::vector<request_slot> pt(count);
+  for (int i=0;i<count;i++){
+    request_slot* slot_it = internal_comm_table.find((array_of_requests)[i]);
+    assert(slot_it != nullptr);
+    pt[i] = *slot_it;
+    internal_comm_table.erase(slot_it);
+  }
+  std::vector<int> batch_lead;
   if (track_p2p_idle==1){// nonblocking collectives won't pass the if statements below anyway.
-    std::vector<MPI_Request> internal_requests(3*count,MPI_REQUEST_NULL);
-    if (count > barrier_pad_send.size()){
-      barrier_pad_send.resize(count);
-      barrier_pad_recv.resize(count);
-      synch_pad_send.resize(count);
-      synch_pad_recv.resize(count);
-    }
-    // Issue all barrier/synch communications at once because request order is not guaranteed to be sequenced together on all processes.
+    // A batch sends its partner a single arrival timestamp if any of its requests is a send, and receives a single one if any is a receive
+    get_batch_leads(pt,batch_lead);
+    std::vector<char> batch_sends(count,0), batch_recvs(count,0);
+    for (int i=0; i<count; i++){
+      assert((pt[i].track->tag >= 20) || (pt[i].partner != MPI_ANY_SOURCE));
+      if (batch_lead[i] == -1) continue;
+      if (pt[i].is_sender) { batch_sends[batch_lead[i]]=1; }
+      else                 { batch_recvs[batch_lead[i]]=1; }
+    }
+    std::vector<MPI_Request> internal_requests;
+    std::vector<double> partner_arrivals(count);
+    // Issue all handshakes at once because request order is not guaranteed to be sequenced together on all processes.
     // Necessary to avoid corruption of idle time calculation that would occur if sending out in some sequence after each request is completed.
     // Presumably the sending communications will utilize the eager protocol, but as the Waitall is issued immediately following the loop, its irrelevant.
     // TODO: Staging nonblocking receives with nonblocking sends might be a problem because the Sends will likely use the eager protocol (since 1-byte messages),
@@ -838,323 +1410,231 @@ void path::complete(double curtime, int count, MPI_Request array_of_requests[],
     //         by a Waitall. At this point, the choice is whether to issue the user-communication sends one-by-one via Waitany loop, issue the nonblocking recv 3-messages together followed by waitall,
     //         or actually issue a Waitall for the user communication rather than a loop over Waits. I am now leaning towards supporting the user-communication Waitall instead, as that might be a source of overhead
     //         with CTF. Each process can utilize its timer and record the same communication time, and then issue the exchange of path information via nonblocking communications.
-    double max_barrier_time = 0;// counter-intuitively, a blocking partner should determine the idle time
+    double arrival = MPI_Wtime() + wtime_offset;
     for (int i=0; i<count; i++){
-      auto comm_info_it = internal_comm_info.find(*(array_of_requests+i));
-      assert(comm_info_it != internal_comm_info.end());
-      auto comm_comm_it = internal_comm_comm.find(*(array_of_requests+i));
-      assert(comm_comm_it != internal_comm_comm.end());
-      assert(comm_comm_it->second.second != MPI_ANY_SOURCE);
-      if (comm_info_it->second.first && comm_comm_it->second.second != -1){
-        PMPI_Isend(&barrier_pad_send[i], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag3,
-          comm_comm_it->second.first, &internal_requests[3*i]);
-        if (eager_p2p==0) { PMPI_Isend(&max_barrier_time, 1, MPI_DOUBLE, comm_comm_it->second.second, internal_tag4,
-          comm_comm_it->second.first, &internal_requests[3*i+1]); }
-        PMPI_Isend(&synch_pad_send[i], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag,
-          comm_comm_it->second.first, &internal_requests[3*i+2]);
+      if (batch_lead[i] != i) continue;
+      if (batch_sends[i]){
+        internal_requests.push_back(MPI_REQUEST_NULL);
+        PMPI_Isend(&arrival, 1, MPI_DOUBLE, pt[i].partner, internal_tag3,
+          pt[i].comm, &internal_requests.back());
+        internal_overhead_counter.message(sizeof(double));
+        if (eager_p2p==0) { post_handshake_reply_recv(pt[i].comm,pt[i].partner); }
       }
-      else if (!comm_info_it->second.first && comm_comm_it->second.second != -1){
-        PMPI_Irecv(&barrier_pad_recv[i], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag3,
-          comm_comm_it->second.first, &internal_requests[3*i]);
-        if (eager_p2p==0) { PMPI_Irecv(&max_barrier_time, 1, MPI_DOUBLE, comm_comm_it->second.second, internal_tag4,
-          comm_comm_it->second.first, &internal_requests[3*i+1]); }
-        PMPI_Irecv(&synch_pad_recv[i], 1, MPI_CHAR, comm_comm_it->second.second, internal_tag,
-          comm_comm_it->second.first, &internal_requests[3*i+2]);
+      if (batch_recvs[i]){
+        internal_requests.push_back(MPI_REQUEST_NULL);
+        PMPI_Irecv(&partner_arrivals[i], 1, MPI_DOUBLE, pt[i].partner, internal_tag3,
+          pt[i].comm, &internal_requests.back());
+        if (eager_p2p==0) {
+          internal_requests.push_back(MPI_REQUEST_NULL);
+          PMPI_Isend(&arrival, 1, MPI_DOUBLE, pt[i].partner, internal_tag4,
+            pt[i].comm, &internal_requests.back());
+          internal_overhead_counter.message(sizeof(double));
+        }
       }
     }
     PMPI_Waitall(internal_requests.size(), &internal_requests[0], MPI_STATUSES_IGNORE);
   }
-  // We must save the requests before the completition of a request by the MPI implementation because its tag is set to MPI_REQUEST_NULL and lost forever
-  std::vector<MPI_Request> pt(count); for (int i=0;i<count;i++){pt[i]=(array_of_requests)[i];}
   volatile double last_start_time = MPI_Wtime();
   PMPI_Waitall(count,array_of_requests,array_of_statuses);
-  double waitall_comm_time = MPI_Wtime() - last_start_time;
+  volatile double wait_end_time = MPI_Wtime();
+  double waitall_comm_time = wait_end_time - last_start_time;
   if (eager_p2p==1) { complete_path_update(); }
   opt_measure_match.resize(num_per_process_measures,0.);
   for (int i=0; i<count; i++){
-    MPI_Request request = pt[i];
-    auto comm_track_it = internal_comm_track.find(request);
-    auto comm_comm_it = internal_comm_comm.find(request);
-    assert(comm_track_it != internal_comm_track.end());
-    if (comm_comm_it->second.second == MPI_ANY_SOURCE) { comm_track_it->second->partner1 = (array_of_statuses)[i].MPI_SOURCE; }
-    complete(*comm_track_it->second, &request, waitall_comp_time, waitall_comm_time);
+    if ((pt[i].payload != nullptr) && (!pt[i].is_sender) && (array_of_statuses != MPI_STATUSES_IGNORE)){
+      correct_piggyback_status(&array_of_statuses[i],pt[i].payload_type,pt[i].type);
+    }
+    if (is_wildcard_p2p(pt[i])) { pt[i].partner = (array_of_statuses)[i].MPI_SOURCE; }
+  }
+  // Requests are accounted for individually, while each batch propagates only after all of its requests have been accounted for
+  if (batch_waitall==1) { get_batch_leads(pt,batch_lead); }
+  for (int i=0; i<count; i++){
+    complete(pt[i], waitall_comp_time, waitall_comm_time, (batch_waitall==0) || (batch_lead[i]==-1));
     // Although we have to exchange the path data for each request, we do not want to double-count the computation time nor the communicaion time
     waitall_comp_time=0;
     waitall_comm_time=0;
     if (i==0){wait_id=false;}
   }
   wait_id=true;
+  if (batch_waitall==1){
+    for (int i=0; i<count; i++){
+      if (batch_lead[i] != i) continue;
+      nonblocking& tracker = *pt[i].track;
+      tracker.comm = pt[i].comm;
+      tracker.partner1 = pt[i].partner;
+      tracker.is_sender = pt[i].is_sender;
+      propagate(tracker);
+    }
+  }
   if (eager_p2p==0) { complete_path_update(); }
   if (opt && symbol_path_select_size>0 && symbol_stack.size()>0){
-    event_list.push_back(event(symbol_stack.top(),opt_measure_match,opt_req_match));
+    event_list.push_back(event(symbol_timers[symbol_stack.top().index].name,opt_measure_match,opt_req_match));
     opt_req_match.clear();
     opt_measure_match.clear();
   }
   computation_timer = MPI_Wtime();
-  if (symbol_path_select_size>0){ symbol_timers[symbol_stack.top()].start_timer.top() = computation_timer; }
+  internal_overhead_counter.discount(wait_end_time - last_start_time);
+  internal_overhead_counter.exit();
+  if (symbol_path_select_size>0 && symbol_stack.size()>0){ symbol_stack.top().start_time = computation_timer; }
 }
 
 void path::propagate_symbols(nonblocking& tracker, int rank){
-  if (eager_p2p==0){
-    MPI_Request internal_request[8];
-    int* send_envelope1 = nullptr; int* send_envelope2 = nullptr; double* send_envelope3 = nullptr; char* send_envelope5 = nullptr;
-    int* recv_envelope1 = nullptr; int* recv_envelope2 = nullptr; double* recv_envelope3 = nullptr; char* recv_envelope5 = nullptr;
-    int ftimer_size = symbol_timers.size();
-    int data_len_size = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size;
-    int num_chars = 0;
-    for (int i=0; i<ftimer_size; i++) { num_chars += symbol_order[i].size(); }
-    send_envelope1 = (int*)malloc(sizeof(int)); *send_envelope1 = ftimer_size;
-    send_envelope2 = (int*)malloc(sizeof(int)*(ftimer_size));
-    send_envelope3 = (double*)malloc(sizeof(double)*data_len_size);
-    send_envelope5 = (char*)malloc(sizeof(char)*num_chars);
-    int symbol_offset = 0;
-    for (auto i=0; i<ftimer_size; i++){
-      send_envelope2[i] = symbol_order[i].size();
-      for (auto j=0; j<symbol_order[i].size(); j++){
-        send_envelope5[symbol_offset+j] = symbol_order[i][j];
-      }
-      symbol_offset += symbol_order[i].size();
-    }
-    std::memcpy(send_envelope3,&symbol_timer_pad_local_cp[0],sizeof(double)*data_len_size);
-    PMPI_Isend(&send_envelope1[0],1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,&internal_request[0]);
-    PMPI_Isend(&send_envelope2[0],ftimer_size,MPI_INT,tracker.partner1,internal_tag2,tracker.comm,&internal_request[1]);
-    PMPI_Isend(&send_envelope3[0],data_len_size,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,&internal_request[2]);
-    PMPI_Isend(&send_envelope5[0],symbol_offset,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,&internal_request[3]);
-
-    recv_envelope1 = (int*)malloc(sizeof(int));
-    recv_envelope2 = (int*)malloc(sizeof(int)*(max_num_symbols));
-    recv_envelope3 = (double*)malloc(sizeof(double)*symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols);
-    recv_envelope5 = (char*)malloc(sizeof(char)*max_timer_name_length*max_num_symbols);
-    PMPI_Irecv(recv_envelope1,1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,&internal_request[4]);
-    PMPI_Irecv(recv_envelope2,max_num_symbols,MPI_INT,tracker.partner1,internal_tag2,tracker.comm,&internal_request[5]);
-    PMPI_Irecv(recv_envelope3,symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,&internal_request[6]);
-    PMPI_Irecv(recv_envelope5,max_timer_name_length*max_num_symbols,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,&internal_request[7]);
-
-    for (int i=0; i<8; i++) { internal_timer_prop_req.push_back(internal_request[i]); }
-    internal_timer_prop_int.push_back(send_envelope1); internal_timer_prop_int.push_back(send_envelope2);
-    internal_timer_prop_int.push_back(recv_envelope1); internal_timer_prop_int.push_back(recv_envelope2);
-    internal_timer_prop_double.push_back(send_envelope3);
-    internal_timer_prop_double.push_back(recv_envelope3);
-    internal_timer_prop_char.push_back(send_envelope5); internal_timer_prop_char.push_back(recv_envelope5);
-  } else{
-    if (tracker.is_sender){
-      MPI_Request internal_request[4];
-      int* send_envelope1 = nullptr; int* send_envelope2 = nullptr; double* send_envelope3 = nullptr; char* send_envelope5 = nullptr;
-      int ftimer_size = symbol_timers.size();
-      int data_len_size = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size;
-      int num_chars = 0;
-      for (int i=0; i<ftimer_size; i++) { num_chars += symbol_order[i].size(); }
-      send_envelope1 = (int*)malloc(sizeof(int)); *send_envelope1 = ftimer_size;
-      send_envelope2 = (int*)malloc(sizeof(int)*(ftimer_size));
-      send_envelope3 = (double*)malloc(sizeof(double)*data_len_size);
-      send_envelope5 = (char*)malloc(sizeof(char)*num_chars);
-      int symbol_offset = 0;
-      for (auto i=0; i<ftimer_size; i++){
-        send_envelope2[i] = symbol_order[i].size();
-        for (auto j=0; j<symbol_order[i].size(); j++){
-          send_envelope5[symbol_offset+j] = symbol_order[i][j];
-        }
-        symbol_offset += symbol_order[i].size();
-      }
-      std::memcpy(send_envelope3,&symbol_timer_pad_local_cp[0],sizeof(double)*data_len_size);
-      PMPI_Isend(&send_envelope1[0],1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,&internal_request[0]);
-      PMPI_Isend(&send_envelope2[0],ftimer_size,MPI_INT,tracker.partner1,internal_tag2,tracker.comm,&internal_request[1]);
-      PMPI_Isend(&send_envelope3[0],data_len_size,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,&internal_request[2]);
-      PMPI_Isend(&send_envelope5[0],symbol_offset,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,&internal_request[3]);
-
-      for (int i=0; i<4; i++) { internal_timer_prop_req.push_back(internal_request[i]); }
-      internal_timer_prop_int.push_back(send_envelope1);
-      internal_timer_prop_int.push_back(send_envelope2);
-      internal_timer_prop_double.push_back(send_envelope3);
-      internal_timer_prop_char.push_back(send_envelope5);
-    } else{
-      MPI_Request internal_request[4];
-      int* recv_envelope1 = nullptr; int* recv_envelope2 = nullptr; double* recv_envelope3 = nullptr; char* recv_envelope5 = nullptr;
-      recv_envelope1 = (int*)malloc(sizeof(int));
-      recv_envelope2 = (int*)malloc(sizeof(int)*(max_num_symbols));
-      recv_envelope3 = (double*)malloc(sizeof(double)*symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols);
-      recv_envelope5 = (char*)malloc(sizeof(char)*max_timer_name_length*max_num_symbols);
-      PMPI_Irecv(recv_envelope1,1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,&internal_request[0]);
-      PMPI_Irecv(recv_envelope2,max_num_symbols,MPI_INT,tracker.partner1,internal_tag2,tracker.comm,&internal_request[1]);
-      PMPI_Irecv(recv_envelope3,symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,&internal_request[2]);
-      PMPI_Irecv(recv_envelope5,max_timer_name_length*max_num_symbols,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,&internal_request[3]);
-
-      for (int i=0; i<4; i++) { internal_timer_prop_req.push_back(internal_request[i]); }
-      internal_timer_prop_int.push_back(recv_envelope1);
-      internal_timer_prop_int.push_back(recv_envelope2);
-      internal_timer_prop_double.push_back(recv_envelope3);
-      internal_timer_prop_char.push_back(recv_envelope5);
-    }
+  internal_overhead_counter.enter(overhead_propagate_symbols);
+  if ((eager_p2p==0) || tracker.is_sender){
+    MPI_Request internal_request;
+    int send_header[3];
+    size_t first_name = pack_symbol_header(tracker.comm,tracker.partner1,send_header);
+    int data_len_size = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*send_header[0];
+    size_t message_size = get_symbol_message_size(send_header,data_len_size);
+    char* send_buffer = internal_envelope_pool.allocate<char>(message_size);
+    pack_symbol_message(send_buffer,send_header,first_name,&symbol_timer_pad_local_cp[0],data_len_size);
+    PMPI_Isend(send_buffer,message_size,MPI_BYTE,tracker.partner1,internal_tag5,tracker.comm,&internal_request);
+    internal_overhead_counter.message(message_size);
+    internal_timer_prop_req.push_back(internal_request);
   }
+  if ((eager_p2p==0) || !tracker.is_sender){ post_symbol_recv(tracker.comm,tracker.partner1); }
+  internal_overhead_counter.exit();
 }
 
 /*
  Its important to note here that a blocking p2p call will already know whether its the cp root or not, regardless of whether its partner used a nonblocking p2p routine.
    But, because that potential nonblocking partner does not have this knowledge, and thus posted both sends and recvs, the blocking partner also has to do so as well, even if its partner (unknown to him) used a blocking p2p routine.
+ Symbols are identified by their global ids. Their names are sent only the first time a process sends them over a given channel (to a partner in a communicator, or collectively to a communicator).
 */
 void path::propagate_symbols(blocking& tracker, int rank){
+  internal_overhead_counter.enter(overhead_propagate_symbols);
   bool true_eager_p2p = ((eager_p2p == 1) && (tracker.tag!=13) && (tracker.tag!=14));
-  std::vector<int> ftimer_size_cp(symbol_path_select_size,0);
-  int ftimer_size_ncp1=0;
-  int ftimer_size_ncp2=0;
-  for (auto i=0; i<symbol_path_select_size; i++){
-    ftimer_size_cp[i] = symbol_timers.size();
-    // Specialized multi-root reductions for propagating user collectives require non-roots to set values to 0.
-    // This is not the case for p2p, so we must separate the logic.
-    if ((tracker.partner1 == -1) && (rank != info_receiver[symbol_path_select_index[i]].second)){
-      ftimer_size_cp[i] = 0;
-    }
-  }
+  size_t cp_stride = cp_symbol_class_count*num_per_process_measures+1;
 
   if (tracker.partner1 == -1){
-    PMPI_Allreduce(MPI_IN_PLACE,&ftimer_size_cp[0],symbol_path_select_size,MPI_INT,MPI_SUM,tracker.comm);
-    memset(&symbol_len_pad_cp[0],0,sizeof(int)*symbol_len_pad_cp.size());// not as simple as 'ftimer_size_cp' for blocking collectives. Dependent on the entries in that array
-    size_t symbol_offset_cp = 0;
+    // Each path is determined by a single root, whose header (symbol count, count of new names, their total length) is summed into the zeros of all other processes.
+    //   A process that roots several paths sends its new names along with the first.
+    std::vector<int> symbol_header_cp(3*symbol_path_select_size,0);
+    size_t first_name = get_symbol_count();
+    bool sent_names = false;
     for (auto k=0; k<symbol_path_select_size; k++){
-      // Only the roots determining each path will write the symbol length for its symbols.
-      //   The rest must keep the zero set above in the memset, but they will still increment the symbol offset counter.
       if (rank==info_receiver[symbol_path_select_index[k]].second){
-        for (auto i=0; i<ftimer_size_cp[k]; i++){
-          symbol_len_pad_cp[symbol_offset_cp++] = symbol_order[i].size();
-        }
+        if (!sent_names){ first_name = pack_symbol_header(tracker.comm,-1,&symbol_header_cp[3*k]); sent_names=true; }
+        else { symbol_header_cp[3*k] = symbol_timers.size(); }
       }
-      else{
-        symbol_offset_cp += ftimer_size_cp[k];
+    }
+    PMPI_Allreduce(MPI_IN_PLACE,&symbol_header_cp[0],3*symbol_path_select_size,MPI_INT,MPI_SUM,tracker.comm);
+    internal_overhead_counter.message(3*symbol_path_select_size*sizeof(int));
+    size_t ftimer_size_total = 0; size_t num_names = 0; size_t num_chars = 0;
+    for (auto k=0; k<symbol_path_select_size; k++){
+      ftimer_size_total += symbol_header_cp[3*k];
+      num_names += symbol_header_cp[3*k+1];
+      num_chars += symbol_header_cp[3*k+2];
+    }
+    if (num_names>0){
+      reserve_pad(symbol_len_pad_cp,num_names);
+      reserve_pad(symbol_pad_cp,num_chars);
+      memset(&symbol_len_pad_cp[0],0,sizeof(int)*num_names);
+      memset(&symbol_pad_cp[0],0,sizeof(char)*num_chars);
+      size_t name_offset = 0; size_t char_offset = 0;
+      for (auto k=0; k<symbol_path_select_size; k++){
+        if ((rank==info_receiver[symbol_path_select_index[k]].second) && (symbol_header_cp[3*k+1]>0)){
+          pack_symbol_names(first_name,&symbol_len_pad_cp[name_offset],&symbol_pad_cp[char_offset]);
+        }
+        name_offset += symbol_header_cp[3*k+1];
+        char_offset += symbol_header_cp[3*k+2];
       }
+      PMPI_Allreduce(MPI_IN_PLACE,&symbol_len_pad_cp[0],num_names,MPI_INT,MPI_SUM,tracker.comm);
+      PMPI_Allreduce(MPI_IN_PLACE,&symbol_pad_cp[0],num_chars,MPI_CHAR,MPI_SUM,tracker.comm);
+      internal_overhead_counter.message(num_names*sizeof(int));
+      internal_overhead_counter.message(num_chars);
+      // Registering a process's own names again is harmless, so all segments are processed alike
+      unpack_symbol_names(num_names,&symbol_len_pad_cp[0],&symbol_pad_cp[0]);
     }
-    PMPI_Allreduce(MPI_IN_PLACE,&symbol_len_pad_cp[0],symbol_offset_cp,MPI_INT,MPI_SUM,tracker.comm);
-    symbol_offset_cp = 0;
-    int char_count_cp = 0; int char_count_ncp1 = 0; int char_count_ncp2 = 0;
+    reserve_pad(symbol_id_pad_cp,ftimer_size_total);
+    reserve_pad(symbol_timer_pad_global_cp,ftimer_size_total*cp_stride);
+    size_t symbol_offset_cp = 0;
     size_t pad_global_offset = 0;
     for (auto k=0; k<symbol_path_select_size; k++){
-      // Only the roots determining each path will write the symbol length for its symbols.
-      //   The rest must keep the zero set above in the memset, but they will still increment the symbol offset counter.
+      // Only the roots determining each path will write their ids and measures.
+      //   The rest must write zeros, but they will still increment the offset counters.
       if (rank==info_receiver[symbol_path_select_index[k]].second){
-        for (auto i=0; i<ftimer_size_cp[k]; i++){
-          size_t pad_local_offset = (i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1);
+        pack_symbol_ids(&symbol_id_pad_cp[symbol_offset_cp]);
+        for (auto i=0; i<symbol_header_cp[3*k]; i++){
+          size_t pad_local_offset = (i*symbol_path_select_size+k)*cp_stride;
           std::memcpy(&symbol_timer_pad_global_cp[pad_global_offset],
                       &symbol_timer_pad_local_cp[pad_local_offset],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          for (auto j=0; j<symbol_len_pad_cp[symbol_offset_cp]; j++){
-            symbol_pad_cp[char_count_cp+j] = symbol_order[i][j];
-          }
-          pad_global_offset += (cp_symbol_class_count*num_per_process_measures+1);
-          char_count_cp += symbol_len_pad_cp[symbol_offset_cp++];
+                      sizeof(double)*cp_stride);
+          pad_global_offset += cp_stride;
         }
       }
       else{
-        memset(&symbol_timer_pad_global_cp[pad_global_offset],0,sizeof(double)*ftimer_size_cp[k]*(cp_symbol_class_count*num_per_process_measures+1));
-        pad_global_offset += ftimer_size_cp[k]*(cp_symbol_class_count*num_per_process_measures+1);
-        for (auto i=0; i<ftimer_size_cp[k]; i++){
-          memset(&symbol_pad_cp[char_count_cp],0,sizeof(char)*symbol_len_pad_cp[symbol_offset_cp]);
-          char_count_cp += symbol_len_pad_cp[symbol_offset_cp++];
-        }
+        memset(&symbol_id_pad_cp[symbol_offset_cp],0,sizeof(uint64_t)*symbol_header_cp[3*k]);
+        memset(&symbol_timer_pad_global_cp[pad_global_offset],0,sizeof(double)*symbol_header_cp[3*k]*cp_stride);
+        pad_global_offset += symbol_header_cp[3*k]*cp_stride;
       }
+      symbol_offset_cp += symbol_header_cp[3*k];
     }
+    PMPI_Allreduce(MPI_IN_PLACE,&symbol_id_pad_cp[0],ftimer_size_total,MPI_UINT64_T,MPI_SUM,tracker.comm);
     PMPI_Allreduce(MPI_IN_PLACE,&symbol_timer_pad_global_cp[0],pad_global_offset,MPI_DOUBLE,MPI_SUM,tracker.comm);
-    PMPI_Allreduce(MPI_IN_PLACE,&symbol_pad_cp[0],char_count_cp,MPI_CHAR,MPI_SUM,tracker.comm);
+    internal_overhead_counter.message(ftimer_size_total*sizeof(uint64_t));
+    internal_overhead_counter.message(pad_global_offset*sizeof(double));
     pad_global_offset = 0;
-    size_t symbol_pad_offset = 0;
-    size_t symbol_len_pad_offset=0;
+    symbol_offset_cp = 0;
     for (auto k=0; k<symbol_path_select_size; k++){
       if (rank != info_receiver[symbol_path_select_index[k]].second){
-        for (int i=0; i<ftimer_size_cp[k]; i++){
-          auto reconstructed_symbol = std::string(symbol_pad_cp.begin()+symbol_pad_offset,symbol_pad_cp.begin()+symbol_pad_offset+symbol_len_pad_cp[symbol_len_pad_offset]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          std::memcpy(symbol_timers[reconstructed_symbol].cp_numcalls[k],
+        for (int i=0; i<symbol_header_cp[3*k]; i++){
+          int reconstructed_index = get_global_symbol_index(symbol_id_pad_cp[symbol_offset_cp+i]);
+          std::memcpy(symbol_timers[reconstructed_index].cp_numcalls[k],
                       &symbol_timer_pad_global_cp[pad_global_offset],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          pad_global_offset += (cp_symbol_class_count*num_per_process_measures+1);
-          symbol_pad_offset += symbol_len_pad_cp[symbol_len_pad_offset];
-          symbol_len_pad_offset++;
+                      sizeof(double)*cp_stride);
+          symbol_timers[reconstructed_index].has_been_processed = true;
+          pad_global_offset += cp_stride;
         }
         // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
         for (auto& it : symbol_timers){
-          if (it.second.has_been_processed){ it.second.has_been_processed = false; }
+          if (it.has_been_processed){ it.has_been_processed = false; }
           else{
-            it.second.cp_numcalls[k][0] = 0;
+            it.cp_numcalls[k][0] = 0;
             for (int j=0; j<num_per_process_measures; j++){
-              it.second.cp_incl_measure[k][j] = 0;
-              it.second.cp_excl_measure[k][j] = 0;
+              it.cp_incl_measure[k][j] = 0;
+              it.cp_excl_measure[k][j] = 0;
             }
           }
         }
       }
       else{
-        for (int i=0; i<ftimer_size_cp[k]; i++){
-          symbol_pad_offset += symbol_len_pad_cp[symbol_len_pad_offset++];
-        }
-        pad_global_offset += ftimer_size_cp[k]*(cp_symbol_class_count*num_per_process_measures+1);   
+        pad_global_offset += symbol_header_cp[3*k]*cp_stride;
       }
+      symbol_offset_cp += symbol_header_cp[3*k];
     }
   }
   else if (!true_eager_p2p){
     // This propagation for p2p user communication is agnostic (for now) to which process determines the root for a specific metric.
-    //   Its simply an exchange. Note that this allows each process to only send the bare minimum. As an example, each process need only send
-    //     a single integer representing its symbol size. There is no need to send symbol_path_select_size integers with the same value.
-    MPI_Request symbol_exchance_reqs[8]; int exchange_count=0;
-    PMPI_Isend(&ftimer_size_cp[0],1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    PMPI_Irecv(&ftimer_size_ncp1,1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    if (tracker.partner1 != tracker.partner2){ PMPI_Isend(&ftimer_size_cp[0],1,MPI_INT,tracker.partner2,internal_tag1,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-                                               PMPI_Irecv(&ftimer_size_ncp2,1,MPI_INT,tracker.partner2,internal_tag1,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-                                             }
-    PMPI_Waitall(exchange_count,&symbol_exchance_reqs[0],MPI_STATUSES_IGNORE);
-    memset(&symbol_len_pad_cp[0],0,sizeof(int)*symbol_len_pad_cp.size());// not as simple as 'ftimer_size_cp' for blocking collectives. Dependent on the entries in that array
-    memset(&symbol_len_pad_ncp1[0],0,sizeof(int)*ftimer_size_ncp1);
-    memset(&symbol_len_pad_ncp2[0],0,sizeof(int)*ftimer_size_ncp2);
-    size_t symbol_offset_cp = 0; size_t symbol_offset_ncp1 = 0; size_t symbol_offset_ncp2 = 0;
-    // Each process will determine the symbol length for each of its symbols first
-    //   while incrementing simply the counters to prepare to receive.
-    for (auto i=0; i<ftimer_size_cp[0]; i++){
-      symbol_len_pad_cp[i] = symbol_order[i].size();
-    }
-    // This propagation for p2p user communication is agnostic (for now) to which process determines the root for a specific metric.
-    //   Its simply an exchange.
-    exchange_count=0;
-    PMPI_Isend(&symbol_len_pad_cp[0],ftimer_size_cp[0],MPI_INT,tracker.partner1,internal_tag2,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    PMPI_Irecv(&symbol_len_pad_ncp1[0],ftimer_size_ncp1,MPI_INT,tracker.partner1,internal_tag2,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    if (tracker.partner1 != tracker.partner2){ PMPI_Isend(&symbol_len_pad_cp[0],ftimer_size_cp[0],MPI_INT,tracker.partner2,internal_tag2,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-                                               PMPI_Irecv(&symbol_len_pad_ncp2[0],ftimer_size_ncp2,MPI_INT,tracker.partner2,internal_tag2,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-                                             }
-    PMPI_Waitall(exchange_count,&symbol_exchance_reqs[0],MPI_STATUSES_IGNORE);
-    symbol_offset_cp = 0; symbol_offset_ncp1 = 0; symbol_offset_ncp2 = 0;
-    int char_count_cp = 0; int char_count_ncp1 = 0; int char_count_ncp2 = 0;
-    size_t pad_global_offset = 0;
-    // Each process will determine the symbol length for each of its symbols first
-    //   while incrementing simply the counters to prepare to receive.
-    for (auto i=0; i<ftimer_size_cp[0]; i++){
-      for (auto j=0; j<symbol_len_pad_cp[symbol_offset_cp]; j++){
-        symbol_pad_cp[char_count_cp+j] = symbol_order[i][j];
-      }
-      char_count_cp += symbol_len_pad_cp[symbol_offset_cp++];
-    }
-    for (auto i=0; i<ftimer_size_ncp1; i++){
-      char_count_ncp1 += symbol_len_pad_ncp1[symbol_offset_ncp1++];
+    //   Its simply an exchange of a single message with each partner. Note that this allows each process to only send the bare minimum. As an example, each process need only send
+    //     a single header representing its symbol count. There is no need to send symbol_path_select_size headers with the same value.
+    MPI_Request symbol_exchance_reqs[2]; int exchange_count=0;
+    int header_cp1[3]; int header_cp2[3];
+    int data_len_cp = symbol_path_select_size*cp_stride*symbol_timers.size();
+    // The names new to each partner differ, so each partner is sent its own message. Both are packed into the same pad, the second aligned as the first.
+    size_t first_name1 = pack_symbol_header(tracker.comm,tracker.partner1,header_cp1);
+    size_t message_size1 = get_symbol_message_size(header_cp1,data_len_cp);
+    size_t message_offset2 = (message_size1 + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    size_t message_size2 = 0; size_t first_name2 = 0;
+    if (tracker.partner1 != tracker.partner2){
+      first_name2 = pack_symbol_header(tracker.comm,tracker.partner2,header_cp2);
+      message_size2 = get_symbol_message_size(header_cp2,data_len_cp);
     }
+    reserve_pad(symbol_msg_pad_cp,message_offset2+message_size2);
+    pack_symbol_message(&symbol_msg_pad_cp[0],header_cp1,first_name1,&symbol_timer_pad_local_cp[0],data_len_cp);
+    PMPI_Isend(&symbol_msg_pad_cp[0],message_size1,MPI_BYTE,tracker.partner1,internal_tag5,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
+    internal_overhead_counter.message(message_size1);
     if (tracker.partner1 != tracker.partner2){
-      for (auto i=0; i<ftimer_size_ncp2; i++){
-        char_count_ncp2 += symbol_len_pad_ncp2[symbol_offset_ncp2++];
-      }
+      pack_symbol_message(&symbol_msg_pad_cp[message_offset2],header_cp2,first_name2,&symbol_timer_pad_local_cp[0],data_len_cp);
+      PMPI_Isend(&symbol_msg_pad_cp[message_offset2],message_size2,MPI_BYTE,tracker.partner2,internal_tag5,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
+      internal_overhead_counter.message(message_size2);
     }
-    // This propagation for p2p user communication is agnostic (for now) to which process determines the root for a specific metric.
-    //   Its simply an exchange. No special copying is needed as in collectives case.
-    exchange_count=0;
-    int data_len_cp = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size_cp[0];
-    int data_len_ncp1 = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size_ncp1;
-    int data_len_ncp2 = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size_ncp2;
-    PMPI_Isend(&symbol_timer_pad_local_cp[0],data_len_cp,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    PMPI_Isend(&symbol_pad_cp[0],char_count_cp,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    PMPI_Irecv(&symbol_timer_pad_global_cp[0],data_len_ncp1,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-    PMPI_Irecv(&symbol_pad_ncp1[0],char_count_ncp1,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
+    receive_pending_symbols(tracker.comm,tracker.partner1);
+    symbol_message message_ncp1 = receive_symbol_message(tracker.comm,tracker.partner1,internal_tag5,symbol_msg_pad_ncp1);
+    symbol_message message_ncp2 = message_ncp1;
     if (tracker.partner1 != tracker.partner2){
-      PMPI_Isend(&symbol_timer_pad_local_cp[0],data_len_cp,MPI_DOUBLE,tracker.partner2,internal_tag3,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-      PMPI_Isend(&symbol_pad_cp[0],char_count_cp,MPI_CHAR,tracker.partner2,internal_tag5,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-      PMPI_Irecv(&symbol_timer_pad_global_cp2[0],data_len_ncp2,MPI_DOUBLE,tracker.partner2,internal_tag3,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
-      PMPI_Irecv(&symbol_pad_ncp2[0],char_count_ncp2,MPI_CHAR,tracker.partner2,internal_tag5,tracker.comm,&symbol_exchance_reqs[exchange_count]); exchange_count++;
+      receive_pending_symbols(tracker.comm,tracker.partner2);
+      message_ncp2 = receive_symbol_message(tracker.comm,tracker.partner2,internal_tag5,symbol_msg_pad_ncp2);
     }
     PMPI_Waitall(exchange_count,&symbol_exchance_reqs[0],MPI_STATUSES_IGNORE);
     for (auto k=0; k<symbol_path_select_size; k++){
@@ -1162,50 +1642,25 @@ void path::propagate_symbols(blocking& tracker, int rank){
       if (rank == info_receiver[symbol_path_select_index[k]].second){
         foreign_root=false;
       }
-      else if (tracker.partner1 == info_receiver[symbol_path_select_index[k]].second){
-        size_t symbol_pad_offset = 0;
-        size_t symbol_len_pad_offset=0;
-        std::string reconstructed_symbol;
-        for (int i=0; i<ftimer_size_ncp1; i++){
-          reconstructed_symbol = std::string(symbol_pad_ncp1.begin()+symbol_pad_offset,symbol_pad_ncp1.begin()+symbol_pad_offset+symbol_len_pad_ncp1[symbol_len_pad_offset]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          std::memcpy(symbol_timers[reconstructed_symbol].cp_numcalls[k],
-                      &symbol_timer_pad_global_cp[(i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1)],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          symbol_pad_offset += symbol_len_pad_ncp1[symbol_len_pad_offset++];
-        }
-      }
       else{
-        size_t symbol_pad_offset = 0;
-        size_t symbol_len_pad_offset=0;
-        std::string reconstructed_symbol;
-        for (int i=0; i<ftimer_size_ncp2; i++){
-          reconstructed_symbol = std::string(symbol_pad_ncp2.begin()+symbol_pad_offset,symbol_pad_ncp2.begin()+symbol_pad_offset+symbol_len_pad_ncp2[symbol_len_pad_offset]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          std::memcpy(&symbol_timers[reconstructed_symbol].cp_numcalls[k],
-                      &symbol_timer_pad_global_cp2[(i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1)],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          symbol_pad_offset += symbol_len_pad_ncp2[symbol_len_pad_offset];
-          symbol_len_pad_offset++;
+        symbol_message& message = (tracker.partner1 == info_receiver[symbol_path_select_index[k]].second) ? message_ncp1 : message_ncp2;
+        for (int i=0; i<message.header[0]; i++){
+          int reconstructed_index = get_global_symbol_index(message.ids[i]);
+          std::memcpy(symbol_timers[reconstructed_index].cp_numcalls[k],
+                      &message.data[(i*symbol_path_select_size+k)*cp_stride],
+                      sizeof(double)*cp_stride);
+          symbol_timers[reconstructed_index].has_been_processed = true;
         }
       }
       if (foreign_root){
         // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
         for (auto& it : symbol_timers){
-          if (it.second.has_been_processed){ it.second.has_been_processed = false; }
+          if (it.has_been_processed){ it.has_been_processed = false; }
           else{
-            it.second.cp_numcalls[k][0] = 0;
+            it.cp_numcalls[k][0] = 0;
             for (int j=0; j<num_per_process_measures; j++){
-              it.second.cp_incl_measure[k][j] = 0;
-              it.second.cp_excl_measure[k][j] = 0;
+              it.cp_incl_measure[k][j] = 0;
+              it.cp_excl_measure[k][j] = 0;
             }
           }
         }
@@ -1215,141 +1670,124 @@ void path::propagate_symbols(blocking& tracker, int rank){
   else{
     // This propagation for p2p user communication is agnostic (for now) to which process determines the root for a specific metric.
     //   Its simply an exchange. Note that this allows each process to only send the bare minimum. As an example, each process need only send
-    //     a single integer representing its symbol size. There is no need to send symbol_path_select_size integers with the same value.
+    //     a single header representing its symbol count. There is no need to send symbol_path_select_size headers with the same value.
+    symbol_message message;
     if (tracker.is_sender){
-      PMPI_Bsend(&ftimer_size_cp[0],1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm);
-      memset(&symbol_len_pad_cp[0],0,sizeof(int)*symbol_len_pad_cp.size());// not as simple as 'ftimer_size_cp' for blocking collectives. Dependent on the entries in that array
-      // Each process will determine the symbol length for each of its symbols first
-      //   while incrementing simply the counters to prepare to receive.
-      for (auto i=0; i<ftimer_size_cp[0]; i++){
-        symbol_len_pad_cp[i] = symbol_order[i].size();
-      }
-      PMPI_Bsend(&symbol_len_pad_cp[0],ftimer_size_cp[0],MPI_INT,tracker.partner1,internal_tag2,tracker.comm);
-      int char_count_cp = 0;
-      size_t pad_global_offset = 0;
-      // Each process will determine the symbol length for each of its symbols first
-      //   while incrementing simply the counters to prepare to receive.
-      for (auto i=0; i<ftimer_size_cp[0]; i++){
-        for (auto j=0; j<symbol_len_pad_cp[i]; j++){
-          symbol_pad_cp[char_count_cp+j] = symbol_order[i][j];
-        }
-        char_count_cp += symbol_len_pad_cp[i];
-      }
-      int data_len_cp = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size_cp[0];
-      PMPI_Bsend(&symbol_timer_pad_local_cp[0],data_len_cp,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm);
-      PMPI_Bsend(&symbol_pad_cp[0],char_count_cp,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm);
+      int symbol_header_cp[3];
+      size_t first_name = pack_symbol_header(tracker.comm,tracker.partner1,symbol_header_cp);
+      int data_len_cp = symbol_path_select_size*cp_stride*symbol_header_cp[0];
+      size_t message_size = get_symbol_message_size(symbol_header_cp,data_len_cp);
+      reserve_pad(symbol_msg_pad_cp,message_size);
+      pack_symbol_message(&symbol_msg_pad_cp[0],symbol_header_cp,first_name,&symbol_timer_pad_local_cp[0],data_len_cp);
+      PMPI_Bsend(&symbol_msg_pad_cp[0],message_size,MPI_BYTE,tracker.partner1,internal_tag5,tracker.comm);
+      internal_overhead_counter.message(message_size);
+      // The sender views its own message, so that any path it determines keeps its own measures
+      message = unpack_symbol_message(&symbol_msg_pad_cp[0]);
     } else{
-      PMPI_Recv(&ftimer_size_cp[0],1,MPI_INT,tracker.partner1,internal_tag1,tracker.comm,MPI_STATUS_IGNORE);
-      memset(&symbol_len_pad_cp[0],0,sizeof(int)*symbol_len_pad_cp.size());// not as simple as 'ftimer_size_cp' for blocking collectives. Dependent on the entries in that array
-      PMPI_Recv(&symbol_len_pad_cp[0],ftimer_size_cp[0],MPI_INT,tracker.partner1,internal_tag2,tracker.comm,MPI_STATUS_IGNORE);
-      int char_count_cp = 0;
-      size_t pad_global_offset = 0;
-      for (auto i=0; i<ftimer_size_cp[0]; i++){
-        char_count_cp += symbol_len_pad_cp[i];
-      }
-      int data_len_cp = symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*ftimer_size_cp[0];
-      PMPI_Recv(&symbol_timer_pad_global_cp[0],data_len_cp,MPI_DOUBLE,tracker.partner1,internal_tag3,tracker.comm,MPI_STATUS_IGNORE);
-      PMPI_Recv(&symbol_pad_cp[0],char_count_cp,MPI_CHAR,tracker.partner1,internal_tag5,tracker.comm,MPI_STATUS_IGNORE);
+      receive_pending_symbols(tracker.comm,tracker.partner1);
+      message = receive_symbol_message(tracker.comm,tracker.partner1,internal_tag5,symbol_msg_pad_ncp1);
     }
     for (auto k=0; k<symbol_path_select_size; k++){
       if (info_sender[symbol_path_select_index[k]].second < info_receiver[symbol_path_select_index[k]].second){
-        size_t symbol_pad_offset = 0;
-        size_t symbol_len_pad_offset=0;
-        std::string reconstructed_symbol;
-        for (int i=0; i<ftimer_size_cp[0]; i++){
-          reconstructed_symbol = std::string(symbol_pad_cp.begin()+symbol_pad_offset,symbol_pad_cp.begin()+symbol_pad_offset+symbol_len_pad_cp[symbol_len_pad_offset]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          std::memcpy(symbol_timers[reconstructed_symbol].cp_numcalls[k],
-                      &symbol_timer_pad_global_cp[(i*symbol_path_select_size+k)*(cp_symbol_class_count*num_per_process_measures+1)],
-                      sizeof(double)*(cp_symbol_class_count*num_per_process_measures+1));
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          symbol_pad_offset += symbol_len_pad_cp[symbol_len_pad_offset++];
+        for (int i=0; i<message.header[0]; i++){
+          int reconstructed_index = get_global_symbol_index(message.ids[i]);
+          std::memcpy(symbol_timers[reconstructed_index].cp_numcalls[k],
+                      &message.data[(i*symbol_path_select_size+k)*cp_stride],
+                      sizeof(double)*cp_stride);
+          symbol_timers[reconstructed_index].has_been_processed = true;
         }
       }
       // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
       for (auto& it : symbol_timers){
-        if (it.second.has_been_processed){ it.second.has_been_processed = false; }
+        if (it.has_been_processed){ it.has_been_processed = false; }
         else{
-          it.second.cp_numcalls[k][0] = 0;
+          it.cp_numcalls[k][0] = 0;
           for (int j=0; j<num_per_process_measures; j++){
-            it.second.cp_incl_measure[k][j] = 0;
-            it.second.cp_excl_measure[k][j] = 0;
+            it.cp_incl_measure[k][j] = 0;
+            it.cp_excl_measure[k][j] = 0;
           }
         }
       }
     }
   }
+  internal_overhead_counter.exit();
 }
 
 void path::propagate(blocking& tracker){
   assert(tracker.comm != 0);
-  int rank; MPI_Comm_rank(tracker.comm,&rank);
+  int rank = get_comm_metadata(tracker.comm).rank;
   if ((rank == tracker.partner1) && (rank == tracker.partner2)) { return; } 
+  internal_overhead_counter.enter(overhead_propagate);
+  if (mechanism == 1){ deferral::mark(); }
   bool true_eager_p2p = ((eager_p2p == 1) && (tracker.tag!=13) && (tracker.tag!=14));
-  if (symbol_path_select_size>0){
-    //TODO: Idea for 2-stage reduction: move this out of the mode>=2 if statement, and then after this, scan the critical_path_costs and zero out what is not defining a critical path and then post a MPI_Allreduce (via multi-root hack)
+  // The roots of the paths through a collective are determined while reducing its path data
+  if (symbol_data_propagates() && (tracker.partner1 != -1)){
     for (int i=0; i<num_critical_path_measures; i++){
       info_sender[i].first = critical_path_costs[i];
       info_sender[i].second = rank;
     }
-    if (tracker.partner1 == -1){
-      PMPI_Allreduce(&info_sender[0].first, &info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, MPI_MAXLOC, tracker.comm);
-    }
-    else{
-      if (!true_eager_p2p){
-        PMPI_Sendrecv(&info_sender[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag,
-                      &info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner2, internal_tag, tracker.comm, MPI_STATUS_IGNORE);
+    if (!true_eager_p2p){
+      internal_overhead_counter.message(num_critical_path_measures*sizeof(double_int));
+      PMPI_Sendrecv(&info_sender[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag,
+                    &info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner2, internal_tag, tracker.comm, MPI_STATUS_IGNORE);
+      for (int i=0; i<num_critical_path_measures; i++){
+        if (info_sender[i].first>info_receiver[i].first){info_receiver[i].second = rank;}
+        else if (info_sender[i].first==info_receiver[i].first){ info_receiver[i].second = std::min(rank,tracker.partner1); }
+        info_receiver[i].first = std::max(info_sender[i].first, info_receiver[i].first);
+      }
+      if (tracker.partner2 != tracker.partner1){
+        // Assuming the sender is always dependent on the receiver (not necessarily true or eager protocol, but we make this assumption), this condition signifies a 3-process exchange.
+        for (int i=0; i<num_critical_path_measures; i++){
+          info_sender[i].first = info_receiver[i].first;
+          info_sender[i].second = info_receiver[i].second;
+        }
+        internal_overhead_counter.message(num_critical_path_measures*sizeof(double_int));
+        PMPI_Sendrecv(&info_sender[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner2, internal_tag,
+                      &info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, MPI_STATUS_IGNORE);
         for (int i=0; i<num_critical_path_measures; i++){
           if (info_sender[i].first>info_receiver[i].first){info_receiver[i].second = rank;}
           else if (info_sender[i].first==info_receiver[i].first){ info_receiver[i].second = std::min(rank,tracker.partner1); }
           info_receiver[i].first = std::max(info_sender[i].first, info_receiver[i].first);
         }
-        if (tracker.partner2 != tracker.partner1){
-          // Assuming the sender is always dependent on the receiver (not necessarily true or eager protocol, but we make this assumption), this condition signifies a 3-process exchange.
-          for (int i=0; i<num_critical_path_measures; i++){
-            info_sender[i].first = info_receiver[i].first;
-            info_sender[i].second = info_receiver[i].second;
-          }
-          PMPI_Sendrecv(&info_sender[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner2, internal_tag,
-                        &info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, MPI_STATUS_IGNORE);
-          for (int i=0; i<num_critical_path_measures; i++){
-            if (info_sender[i].first>info_receiver[i].first){info_receiver[i].second = rank;}
-            else if (info_sender[i].first==info_receiver[i].first){ info_receiver[i].second = std::min(rank,tracker.partner1); }
-            info_receiver[i].first = std::max(info_sender[i].first, info_receiver[i].first);
-          }
-        }
       }
-      else{
-        if (tracker.is_sender){
-          PMPI_Bsend(&info_sender[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm);
-        } else{
-          PMPI_Recv(&info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, MPI_STATUS_IGNORE);
-        }
+    }
+    else{
+      if (tracker.is_sender){
+        PMPI_Bsend(&info_sender[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm);
+        internal_overhead_counter.message(num_critical_path_measures*sizeof(double_int));
+      } else{
+        PMPI_Recv(&info_receiver[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, MPI_STATUS_IGNORE);
       }
     }
   }
   // Exchange the tracked routine critical path data
-  if (tracker.partner1 == -1){
-    MPI_Op op; MPI_Op_create((MPI_User_function*) propagate_critical_path_op,0,&op);
-    PMPI_Allreduce(MPI_IN_PLACE, &critical_path_costs[0], critical_path_costs.size(), MPI_DOUBLE, op, tracker.comm);
-    MPI_Op_free(&op);
+  if ((tracker.partner1 == -1) && (tracker.root != -1) && (symbol_path_select_size==0)){
+    root_critical_path(tracker.comm,rank,tracker.root,is_rooted_broadcast(tracker.tag));
+  }
+  else if (tracker.partner1 == -1){
+    reduce_critical_path(tracker.comm,rank);
   }
   else{
     // Note that a blocking sendrecv allows exchanges even when the other party issued a request via nonblocking communication, as the process with the nonblocking request posts both sends and receives.
-    if (true_eager_p2p){ PMPI_Bsend(&critical_path_costs[0], critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm); }
-    else { PMPI_Sendrecv(&critical_path_costs[0], critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, &new_cs[0], critical_path_costs.size(),
-                         MPI_DOUBLE, tracker.partner2, internal_tag2, tracker.comm, MPI_STATUS_IGNORE); }
+    if (true_eager_p2p && use_path_records()){
+      reserve_pad(path_record_pad_send,get_max_path_record_size());
+      size_t record_size = encode_path_record(&critical_path_costs[0],&path_record_pad_send[0],get_routine_mask(&critical_path_costs[0]));
+      PMPI_Bsend(&path_record_pad_send[0], record_size, MPI_BYTE, tracker.partner1, internal_tag2, tracker.comm);
+      internal_overhead_counter.message(record_size);
+    }
+    else if (true_eager_p2p){
+      PMPI_Bsend(&critical_path_costs[0], critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm);
+      internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+    }
+    else { exchange_critical_path(tracker.comm, tracker.partner1, tracker.partner2); }
     update_critical_path(&new_cs[0],&critical_path_costs[0],critical_path_costs_size);
     if (tracker.partner2 != tracker.partner1){
       // This if-statement will never be breached if 'true_eager_p2p'=true anyways.
-      PMPI_Sendrecv(&critical_path_costs[0], critical_path_costs.size(), MPI_DOUBLE, tracker.partner2, internal_tag2, &new_cs[0], critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm, MPI_STATUS_IGNORE);
+      exchange_critical_path(tracker.comm, tracker.partner2, tracker.partner1);
       update_critical_path(&new_cs[0],&critical_path_costs[0],critical_path_costs_size);
     }
   }
-  if (symbol_path_select_size>0) { propagate_symbols(tracker,rank); }
+  if (symbol_data_propagates()) { propagate_symbols(tracker,rank); }
   if (true_eager_p2p){
     void* temp_buf; int temp_size;
     // Forces buffered messages to send. Ideally we should wait till the next invocation of 'path::initiate(blocking&,...)' to call this,
@@ -1361,13 +1799,16 @@ void path::propagate(blocking& tracker){
     // Should do nothing if symbol_path_select_size==0, but we could check for that here.
     critter::internal::optimization::replay();
   }
+  internal_overhead_counter.exit();
 }
 
 void path::propagate(nonblocking& tracker){
   assert(tracker.comm != 0);
-  int rank; MPI_Comm_rank(tracker.comm,&rank);
+  int rank = get_comm_metadata(tracker.comm).rank;
   if (rank == tracker.partner1) { return; } 
-  if (symbol_path_select_size>0){
+  internal_overhead_counter.enter(overhead_propagate);
+  if (mechanism == 1){ deferral::mark(); }
+  if (symbol_data_propagates()){
     for (int i=0; i<num_critical_path_measures; i++){
       info_sender[i].first = critical_path_costs[i];
       info_sender[i].second = rank;
@@ -1375,10 +1816,11 @@ void path::propagate(nonblocking& tracker){
     if (tracker.partner1 == -1){ assert(0); }
     else if (eager_p2p==0){
       MPI_Request req1,req2;
-      double_int* send_pathdata = (double_int*)malloc(num_critical_path_measures*sizeof(double_int));
-      double_int* recv_pathdata = (double_int*)malloc(num_critical_path_measures*sizeof(double_int));
+      double_int* send_pathdata = internal_envelope_pool.allocate<double_int>(num_critical_path_measures);
+      double_int* recv_pathdata = internal_envelope_pool.allocate<double_int>(num_critical_path_measures);
       memcpy(&send_pathdata[0].first, &info_sender[0].first, num_critical_path_measures*sizeof(double_int));
       PMPI_Isend(&send_pathdata[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, &req1);
+      internal_overhead_counter.message(num_critical_path_measures*sizeof(double_int));
       PMPI_Irecv(&recv_pathdata[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, &req2);
       internal_timer_prop_req.push_back(req1); internal_timer_prop_req.push_back(req2);
       internal_timer_prop_double_int.push_back(send_pathdata); internal_timer_prop_double_int.push_back(recv_pathdata);
@@ -1386,14 +1828,15 @@ void path::propagate(nonblocking& tracker){
     else{
       if (tracker.is_sender){
         MPI_Request req1;
-        double_int* send_pathdata = (double_int*)malloc(num_critical_path_measures*sizeof(double_int));
+        double_int* send_pathdata = internal_envelope_pool.allocate<double_int>(num_critical_path_measures);
         memcpy(&send_pathdata[0].first, &info_sender[0].first, num_critical_path_measures*sizeof(double_int));
         PMPI_Isend(&send_pathdata[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, &req1);
+      internal_overhead_counter.message(num_critical_path_measures*sizeof(double_int));
         internal_timer_prop_req.push_back(req1);
         internal_timer_prop_double_int.push_back(send_pathdata);
       } else{
         MPI_Request req1;
-        double_int* recv_pathdata = (double_int*)malloc(num_critical_path_measures*sizeof(double_int));
+        double_int* recv_pathdata = internal_envelope_pool.allocate<double_int>(num_critical_path_measures);
         PMPI_Irecv(&recv_pathdata[0].first, num_critical_path_measures, MPI_DOUBLE_INT, tracker.partner1, internal_tag, tracker.comm, &req1);
         internal_timer_prop_req.push_back(req1);
         internal_timer_prop_double_int.push_back(recv_pathdata);
@@ -1401,45 +1844,71 @@ void path::propagate(nonblocking& tracker){
     }
   }
   // Exchange the tracked routine critical path data
-  if (tracker.partner1 == -1){
-    MPI_Op op; MPI_Op_create((MPI_User_function*) propagate_critical_path_op,0,&op);
+  if ((tracker.partner1 == -1) && (tracker.root != -1) && (!use_path_records())){
+    // Only the processes to which the data of a rooted collective flows merge the propagated path data.
+    //   Received envelopes are otherwise decoded as path records, which cannot be reduced, so rooted collectives propagate as all others with CRITTER_PATH_ENCODING>0.
     MPI_Request req1;
-    double* local_path_data = (double*)malloc(critical_path_costs.size()*sizeof(double));
-    std::memcpy(local_path_data, &critical_path_costs[0], critical_path_costs.size()*sizeof(double));
-    PMPI_Iallreduce(MPI_IN_PLACE,local_path_data,critical_path_costs.size(),MPI_DOUBLE,op,tracker.comm,&req1);
-    //MPI_Op_free(&op);
-    internal_comm_prop.push_back(std::make_pair(local_path_data,true));
+    double* path_data = internal_envelope_pool.allocate<double>(critical_path_costs.size());
+    bool from_root = is_rooted_broadcast(tracker.tag);
+    if (from_root){
+      if (rank == tracker.root){ std::memcpy(path_data, &critical_path_costs[0], critical_path_costs.size()*sizeof(double)); }
+      PMPI_Ibcast(path_data,critical_path_costs.size(),MPI_DOUBLE,tracker.root,tracker.comm,&req1);
+      internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+    }
+    else{
+      std::memcpy(path_data, &critical_path_costs[0], critical_path_costs.size()*sizeof(double));
+      PMPI_Ireduce(rank == tracker.root ? MPI_IN_PLACE : path_data,path_data,critical_path_costs.size(),MPI_DOUBLE,critical_path_op,tracker.root,tracker.comm,&req1);
+      internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+    }
+    internal_comm_prop.push_back(std::make_pair(path_data,from_root == (rank == tracker.root)));
     internal_comm_prop_req.push_back(req1);
   }
-  else if (eager_p2p==0){
-    MPI_Request req1,req2;
-    double* local_path_data = (double*)malloc(critical_path_costs.size()*sizeof(double));
+  else if (tracker.partner1 == -1){
+    MPI_Request req1;
+    double* local_path_data = internal_envelope_pool.allocate<double>(critical_path_costs.size());
     std::memcpy(local_path_data, &critical_path_costs[0], critical_path_costs.size()*sizeof(double));
-    double* remote_path_data = (double*)malloc(critical_path_costs.size()*sizeof(double));
-    PMPI_Isend(local_path_data, critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm, &req1);
-    PMPI_Irecv(remote_path_data, critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm, &req2);
-    internal_comm_prop.push_back(std::make_pair(local_path_data,true));
+    PMPI_Iallreduce(MPI_IN_PLACE,local_path_data,critical_path_costs.size(),MPI_DOUBLE,critical_path_op,tracker.comm,&req1);
+    internal_overhead_counter.message(critical_path_costs_size*sizeof(double));
+    internal_comm_prop.push_back(std::make_pair(local_path_data,reduced_path_data));
     internal_comm_prop_req.push_back(req1);
-    internal_comm_prop.push_back(std::make_pair(remote_path_data,false));
-    internal_comm_prop_req.push_back(req2);
   }
   else{
-    MPI_Request req1;
-    if (tracker.is_sender){
-      double* local_path_data = (double*)malloc(critical_path_costs.size()*sizeof(double));
-      std::memcpy(local_path_data, &critical_path_costs[0], critical_path_costs.size()*sizeof(double));
-      PMPI_Isend(local_path_data, critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm, &req1);
-      internal_comm_prop.push_back(std::make_pair(local_path_data,true));
-      internal_comm_prop_req.push_back(req1);
-    }
-    else{
-      double* remote_path_data = (double*)malloc(critical_path_costs.size()*sizeof(double));
-      PMPI_Irecv(remote_path_data, critical_path_costs.size(), MPI_DOUBLE, tracker.partner1, internal_tag2, tracker.comm, &req1);
-      internal_comm_prop.push_back(std::make_pair(remote_path_data,false));
-      internal_comm_prop_req.push_back(req1);
-    }
+    if ((eager_p2p==0) || tracker.is_sender){ post_path_send(tracker.comm,tracker.partner1); }
+    if ((eager_p2p==0) || !tracker.is_sender){ post_path_recv(tracker.comm,tracker.partner1); }
+  }
+  if (symbol_data_propagates()) { propagate_symbols(tracker,rank); }
+  internal_overhead_counter.exit();
+}
+
+// Called after 'initiate', so the payload of a send includes the computation time that precedes it.
+//   Sendrecv_replace sends and receives its payload within the same buffer.
+MPI_Datatype path::piggyback(blocking& tracker, void const* buf, int count, MPI_Datatype t, bool is_sender){
+  std::vector<char>& pad = is_sender ? piggyback_pad_send : piggyback_pad_recv;
+  reserve_pad(pad,get_piggyback_buffer_size());
+  if (is_sender || (tracker.tag == 14)){ encode_piggyback_payload(&critical_path_costs[0],&pad[0]); }
+  return create_piggyback_type(&pad[0],buf,count,t);
+}
+
+// Called before the user request is posted, and thus before 'initiate' accounts for the computation time that precedes it, so that time is added to the payload here.
+//   The payload and datatype are handed to the request slot that 'initiate' creates next.
+MPI_Datatype path::piggyback(nonblocking& tracker, volatile double curtime, void const* buf, int count, MPI_Datatype t, bool is_sender){
+  if (piggyback_payloads.size() == 0){ pending_payload = new char[get_piggyback_buffer_size()]; }
+  else { pending_payload = piggyback_payloads.back(); piggyback_payloads.pop_back(); }
+  if (is_sender){
+    double comp_time = curtime - computation_timer;
+    std::memcpy(&new_cs[0], &critical_path_costs[0], critical_path_costs_size*sizeof(double));
+    new_cs[num_critical_path_measures-2] += comp_time;
+    new_cs[num_critical_path_measures-1] += comp_time;
+    for (size_t i=0; i<comm_path_select_size; i++){ new_cs[critical_path_costs_size-1-i] += comp_time; }
+    encode_piggyback_payload(&new_cs[0],pending_payload);
   }
-  if (symbol_path_select_size>0) { propagate_symbols(tracker,rank); }
+  pending_payload_type = create_piggyback_type(pending_payload,buf,count,t);
+  return pending_payload_type;
+}
+
+void path::unwrap(MPI_Datatype* wrapped, MPI_Datatype t, MPI_Status* status){
+  correct_piggyback_status(status,*wrapped,t);
+  MPI_Type_free(wrapped);
 }
 
 }
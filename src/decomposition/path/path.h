@@ -2,6 +2,7 @@
 #define CRITTER__DECOMPOSITION__PATH__PATH_H_
 
 #include "../container/comm_tracker.h"
+#include "../container/request_table.h"
 
 namespace critter{
 namespace internal{
@@ -9,10 +10,12 @@ namespace decomposition{
 
 class path{
 public:
+  static void allocate();
+  static void deallocate();
   static void initiate(blocking& tracker, volatile double curtime, int64_t nelem, MPI_Datatype t, MPI_Comm comm,
-                       bool is_sender, int partner1, int partner2);
+                       bool is_sender, int partner1, int partner2, int root);
   static void initiate(nonblocking& tracker, volatile double curtime, volatile double itime, int64_t nelem,
-                       MPI_Datatype t, MPI_Comm comm, MPI_Request* request, bool is_sender, int partner);
+                       MPI_Datatype t, MPI_Comm comm, MPI_Request* request, bool is_sender, int partner, int root);
   static void complete(blocking& tracker, int recv_source=-1);
   static void complete(double curtime, MPI_Request* request, MPI_Status* status);
   static void complete(double curtime, int count, MPI_Request array_of_requests[], int* indx, MPI_Status* status);
@@ -20,9 +23,12 @@ public:
   static void complete(double curtime, int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]);
   static void propagate(blocking& tracker);
   static void propagate(nonblocking& tracker);
+  static MPI_Datatype piggyback(blocking& tracker, void const* buf, int count, MPI_Datatype t, bool is_sender);
+  static MPI_Datatype piggyback(nonblocking& tracker, volatile double curtime, void const* buf, int count, MPI_Datatype t, bool is_sender);
+  static void unwrap(MPI_Datatype* wrapped, MPI_Datatype t, MPI_Status* status);
 
 private:
-  static void complete(nonblocking& tracker, MPI_Request* request, double comp_time, double comm_time);
+  static void complete(request_slot const& slot, double comp_time, double comm_time, bool propagate_slot=true);
   static void propagate_symbols(blocking& tracker, int rank);
   static void propagate_symbols(nonblocking& tracker, int rank);
 };
@@ -1,6 +1,11 @@
 #include "record.h"
 #include "../container/comm_tracker.h"
 #include "../container/symbol_tracker.h"
+#include "../container/request_table.h"
+#include "../container/envelope_pool.h"
+#include "../container/path_sampler.h"
+#include "../container/overhead_governor.h"
+#include "../container/overhead_counter.h"
 
 namespace critter{
 namespace internal{
@@ -91,7 +96,7 @@ void print_header(std::ofstream& Stream, size_t num_inputs){
 }
 
 void record::invoke(std::ofstream& Stream){
-  assert(internal_comm_info.size() == 0);
+  assert(internal_comm_table.size() == 0);
   if (mode){
     auto np=0; MPI_Comm_size(MPI_COMM_WORLD,&np);
     if (is_world_root){
@@ -140,8 +145,8 @@ void record::invoke(std::ofstream& Stream){
       breakdown_idx=0;
       for (auto i=0; i<comm_path_select.size(); i++){
         if (comm_path_select[i]=='0') continue;
-        Stream << "\t" << critical_path_costs[critical_path_costs_size-comm_path_select_size+breakdown_idx];// comp time
-        Stream << "\t" << critical_path_costs[critical_path_costs_size-2*comm_path_select_size+breakdown_idx];// idle time
+        Stream << "\t" << critical_path_breakdown[critical_path_breakdown_size-comm_path_select_size+breakdown_idx];// comp time
+        Stream << "\t" << critical_path_breakdown[critical_path_breakdown_size-2*comm_path_select_size+breakdown_idx];// idle time
         breakdown_idx++;
       }
       breakdown_idx=0;
@@ -164,7 +169,7 @@ void record::invoke(std::ofstream& Stream){
 }
 
 void record::invoke(std::ostream& Stream){
-  assert(internal_comm_info.size() == 0);
+  assert(internal_comm_table.size() == 0);
   int world_size; MPI_Comm_size(MPI_COMM_WORLD, &world_size);
   if (mode==0){
     if (is_world_root){
@@ -193,6 +198,17 @@ void record::invoke(std::ostream& Stream){
         else if ((i<(2*cost_model_size)) && (i%2==1)) Stream << std::left << std::setw(mode_1_width) << critical_path_costs[(i-1)/2+cost_model_size];
         else Stream << std::left << std::setw(mode_1_width) << critical_path_costs[i-1];
       }
+      if (sample_rate > 1){
+        // Each critical path measure lies, at 95% confidence, between its reported value and that value plus the bound below
+        Stream << "\n";
+        Stream << std::left << std::setw(mode_1_width) << "Sampled bound (+):";
+        for (size_t i=0; i<num_critical_path_measures+1; i++){
+          if (i==(2*cost_model_size)) Stream << std::left << std::setw(mode_1_width) << "0";
+          else if ((i<(2*cost_model_size)) && (i%2==0)) Stream << std::left << std::setw(mode_1_width) << internal_path_sampler.bound[i/2];
+          else if ((i<(2*cost_model_size)) && (i%2==1)) Stream << std::left << std::setw(mode_1_width) << internal_path_sampler.bound[(i-1)/2+cost_model_size];
+          else Stream << std::left << std::setw(mode_1_width) << internal_path_sampler.bound[i-1];
+        }
+      }
       Stream << "\n\n";
 
       Stream << std::left << std::setw(mode_1_width) << "Per-process max:";
@@ -227,6 +243,77 @@ void record::invoke(std::ostream& Stream){
       }
       Stream << "\n\n";
 
+      if (internal_envelope_pool.max_high_water[0] > 0){
+        Stream << std::left << std::setw(mode_1_width) << "Envelope pool max:";
+        Stream << std::left << std::setw(mode_1_width) << "HighWater (bytes)";
+        Stream << std::left << std::setw(mode_1_width) << "Slabs";
+        Stream << "\n";
+        Stream << std::left << std::setw(mode_1_width) << "                  ";
+        Stream << std::left << std::setw(mode_1_width) << internal_envelope_pool.max_high_water[0];
+        Stream << std::left << std::setw(mode_1_width) << internal_envelope_pool.max_high_water[1];
+        Stream << "\n\n";
+      }
+
+      if (internal_overhead_governor.decisions.size() > 0){
+        Stream << std::left << std::setw(mode_1_width) << "Overhead governor:";
+        Stream << std::left << std::setw(mode_1_width) << "Step";
+        Stream << std::left << std::setw(mode_1_width) << "Overhead (%)";
+        Stream << std::left << std::setw(mode_1_width) << "Time";
+        Stream << "\n";
+        for (auto& it : internal_overhead_governor.decisions){
+          Stream << std::left << std::setw(mode_1_width) << "                  ";
+          if (it.level == 1) Stream << std::left << std::setw(mode_1_width) << "drop symbols";
+          else if (it.level == 2) Stream << std::left << std::setw(mode_1_width) << "drop p2p idle";
+          else Stream << std::left << std::setw(mode_1_width) << "sample collectives";
+          Stream << std::left << std::setw(mode_1_width) << 100.*it.overhead;
+          Stream << std::left << std::setw(mode_1_width) << it.time;
+          Stream << "\n";
+        }
+        Stream << "\n";
+      }
+
+      if (self_overhead > 0){
+        std::vector<std::string> phase_names = {"initiate","complete","propagate","propagate_symbols","complete_path_update","collect"};
+        Stream << std::left << std::setw(mode_1_width) << "Critter overhead:";
+        Stream << std::left << std::setw(mode_1_width) << "Time (max)";
+        Stream << std::left << std::setw(mode_1_width) << "Time (avg)";
+        Stream << std::left << std::setw(mode_1_width) << "Messages (avg)";
+        Stream << std::left << std::setw(mode_1_width) << "Bytes (avg)";
+        Stream << "\n";
+        for (int i=0; i<num_overhead_phases; i++){
+          Stream << std::left << std::setw(mode_1_width) << phase_names[i];
+          for (int j=0; j<4; j++){ Stream << std::left << std::setw(mode_1_width) << internal_overhead_counter.phase_counts[4*i+j]; }
+          Stream << "\n";
+        }
+        Stream << "\n";
+        // Routines are listed by tag, followed by the completion routines
+        std::vector<std::string> routine_names(num_overhead_routines);
+        for (auto i=0; i<list_size; i++){ routine_names[list[i]->tag] = list[i]->name; }
+        routine_names[overhead_wait] = "MPI_Wait";
+        routine_names[overhead_waitany] = "MPI_Waitany";
+        routine_names[overhead_waitsome] = "MPI_Waitsome";
+        routine_names[overhead_waitall] = "MPI_Waitall";
+        Stream << std::left << std::setw(mode_1_width) << "Critter overhead:";
+        Stream << std::left << std::setw(mode_1_width) << "Time (max)";
+        Stream << std::left << std::setw(mode_1_width) << "Time (avg)";
+        Stream << std::left << std::setw(mode_1_width) << "Messages (avg)";
+        Stream << std::left << std::setw(mode_1_width) << "Bytes (avg)";
+        Stream << "\n";
+        for (int i=0; i<num_overhead_routines; i++){
+          if (internal_overhead_counter.routine_counts[4*i] == 0) continue;
+          Stream << std::left << std::setw(mode_1_width) << routine_names[i];
+          for (int j=0; j<4; j++){ Stream << std::left << std::setw(mode_1_width) << internal_overhead_counter.routine_counts[4*i+j]; }
+          Stream << "\n";
+        }
+        if (self_overhead == 2){
+          Stream << "\n";
+          Stream << std::left << std::setw(mode_1_width) << "Subtracted:";
+          Stream << std::left << std::setw(mode_1_width) << internal_overhead_counter.correction;
+          Stream << "\n";
+        }
+        Stream << "\n";
+      }
+
       size_t breakdown_idx=0;
       for (auto i=0; i<comm_path_select.size(); i++){
         if (comm_path_select[i]=='0') continue;
@@ -256,12 +343,12 @@ void record::invoke(std::ostream& Stream){
         Stream << "\n";
         Stream << std::left << std::setw(mode_1_width) << "Computation";
         Stream << std::left << std::setw(mode_1_width) << "path";
-        Stream << std::left << std::setw(mode_1_width) << critical_path_costs[critical_path_costs_size-comm_path_select_size+breakdown_idx];
+        Stream << std::left << std::setw(mode_1_width) << critical_path_breakdown[critical_path_breakdown_size-comm_path_select_size+breakdown_idx];
         Stream << "\n";
         Stream << std::left << std::setw(mode_1_width) << "Idle";
         Stream << std::left << std::setw(mode_1_width) << "path";
         Stream << std::left << std::setw(mode_1_width) << 0.0;
-        Stream << std::left << std::setw(mode_1_width) << critical_path_costs[critical_path_costs_size-2*comm_path_select_size+breakdown_idx];
+        Stream << std::left << std::setw(mode_1_width) << critical_path_breakdown[critical_path_breakdown_size-2*comm_path_select_size+breakdown_idx];
         for (int j=0; j<list_size; j++){
           list[j]->set_critical_path_costs(breakdown_idx);
         }
@@ -327,9 +414,9 @@ void record::invoke(std::ostream& Stream){
           // Reset symbol timers and sort
           size_t j=0;
           double cp_ref,pp_ref,vol_ref;
+          if (symbol_stack.size() != 0) { std::cout << "Symbol " << symbol_timers[symbol_stack.top().index].name << " is not handled properly\n"; assert(symbol_stack.size() == 0); }
           for (auto& it : symbol_timers){
-            if (it.second.start_timer.size() != 0) { std::cout << "Symbol " << it.first << " is not handled properly\n"; assert(it.second.start_timer.size() == 0); }
-              sort_info[j++] = std::make_pair(it.second.name,std::array<double,6>{it.second.cp_numcalls[z][0],it.second.cp_excl_measure[z][i],*it.second.pp_numcalls,it.second.pp_excl_measure[i],*it.second.vol_numcalls/world_size,it.second.vol_excl_measure[i]/world_size});
+              sort_info[j++] = std::make_pair(it.name,std::array<double,6>{it.cp_numcalls[z][0],it.cp_excl_measure[z][i],*it.pp_numcalls,it.pp_excl_measure[i],*it.vol_numcalls/world_size,it.vol_excl_measure[i]/world_size});
           }
           std::sort(sort_info.begin(),sort_info.end(),[](std::pair<std::string,std::array<double,6>>& vec1, std::pair<std::string,std::array<double,6>>& vec2){return vec1.second[1] > vec2.second[1];});
           if (i==2*cost_model_size){
@@ -390,8 +477,7 @@ void record::invoke(std::ostream& Stream){
           sort_info.clear(); sort_info.resize(symbol_timers.size());
           j=0;
           for (auto& it : symbol_timers){
-            assert(it.second.start_timer.size() == 0);
-            sort_info[j++] = std::make_pair(it.second.name,std::array<double,6>{it.second.cp_numcalls[z][0],it.second.cp_incl_measure[z][i],*it.second.pp_numcalls,it.second.pp_incl_measure[i],*it.second.vol_numcalls/world_size,it.second.vol_incl_measure[i]/world_size});
+            sort_info[j++] = std::make_pair(it.name,std::array<double,6>{it.cp_numcalls[z][0],it.cp_incl_measure[z][i],*it.pp_numcalls,it.pp_incl_measure[i],*it.vol_numcalls/world_size,it.vol_incl_measure[i]/world_size});
           }
           std::sort(sort_info.begin(),sort_info.end(),[](std::pair<std::string,std::array<double,6>>& vec1, std::pair<std::string,std::array<double,6>>& vec2){return vec1.second[1] > vec2.second[1];});
           if (i==2*cost_model_size){
@@ -1,6 +1,15 @@
 #include "util.h"
 #include "../container/comm_tracker.h"
 #include "../container/symbol_tracker.h"
+#include "../container/request_table.h"
+#include "../container/envelope_pool.h"
+#include "../container/node_hierarchy.h"
+#include "../container/path_sampler.h"
+#include "../container/overhead_governor.h"
+#include "../container/overhead_counter.h"
+#include "../path/path.h"
+#include "../volumetric/volumetric.h"
+#include "../deferral/deferral.h"
 
 namespace critter{
 namespace internal{
@@ -38,59 +47,53 @@ void allocate(MPI_Comm comm){
   num_tracker_volume_measures 		= 2+2*cost_model_size;
 
   // The '2*comm_path_select_size' used below are used to track the computation time and idle time along each of the 'comm_path_select_size' paths.
-  critical_path_costs_size            	= num_critical_path_measures+num_tracker_critical_path_measures*comm_path_select_size*list_size+2*comm_path_select_size;
+  critical_path_breakdown_size		= num_tracker_critical_path_measures*comm_path_select_size*list_size+2*comm_path_select_size;
+  // The deferred mechanism propagates a predecessor (world rank and node index) per path in place of the breakdown
+  assert(mechanism == 0 || symbol_path_select_size == 0);
+  critical_path_costs_size            	= num_critical_path_measures+(mechanism == 1 ? 2*comm_path_select_size : critical_path_breakdown_size);
   per_process_costs_size              	= num_per_process_measures+num_tracker_per_process_measures*comm_path_select_size*list_size+2*comm_path_select_size;
   volume_costs_size                   	= num_volume_measures+num_tracker_volume_measures*list_size;
 
   synch_pad_send.resize(_world_size);
   synch_pad_recv.resize(_world_size);
-  barrier_pad_send.resize(_world_size);
-  barrier_pad_recv.resize(_world_size);
 
   decisions.resize(comm_path_select_size);
   critical_path_costs.resize(critical_path_costs_size);
+  if (mechanism == 1){ deferral::allocate(); }
+  else { critical_path_breakdown = &critical_path_costs[num_critical_path_measures]; }
   max_per_process_costs.resize(per_process_costs_size);
   volume_costs.resize(volume_costs_size);
   new_cs.resize(critical_path_costs_size);
-  // The reason 'symbol_pad_cp' and 'symbol_len_pad_cp' are a factor 'symbol_path_select_size' larger than the 'ncp*'
-  //   variants is because those variants are used solely for p2p, in which we simply transfer a process's path data, rather than reduce it using a special multi-root trick.
-  symbol_pad_cp.resize(symbol_path_select_size*max_timer_name_length*max_num_symbols);
-  symbol_pad_ncp1.resize(max_timer_name_length*max_num_symbols);
-  symbol_pad_ncp2.resize(max_timer_name_length*max_num_symbols);
-  symbol_len_pad_cp.resize(symbol_path_select_size*max_num_symbols);
-  symbol_len_pad_ncp1.resize(max_num_symbols);
-  symbol_len_pad_ncp2.resize(max_num_symbols);
-  // Note: we use 'num_per_process_measures' rather than 'num_critical_path_measures' for specifying the
-  //   length of 'symbol_timer_pad_*_cp' because we want to track idle time contribution of each symbol along a path.
-  symbol_timer_pad_local_cp.resize(symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,0.);
-  symbol_timer_pad_global_cp.resize(symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,0.);
-  symbol_timer_pad_local_pp.resize((pp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,0.);
-  symbol_timer_pad_global_pp.resize((pp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,0.);
-  symbol_timer_pad_local_vol.resize((vol_symbol_class_count*num_volume_measures+1)*max_num_symbols,0.);
-  symbol_timer_pad_global_vol.resize((vol_symbol_class_count*num_volume_measures+1)*max_num_symbols,0.);
-  symbol_order.resize(max_num_symbols);
+  // The symbol pads start out small and grow geometrically as symbols are encountered, either locally or via propagation
+  reserve_symbols(1);
+  symbol_stack.init(max_symbol_depth);
   info_sender.resize(num_critical_path_measures);
   info_receiver.resize(num_critical_path_measures);
+  internal_comm_table.init(1024);
+  // A slab holds the envelopes of several nonblocking propagations, each of which is dominated by two copies of 'critical_path_costs'
+  internal_envelope_pool.init(std::max((size_t)(1<<16),16*critical_path_costs_size*sizeof(double)));
+  volumetric::allocate();
+  // The largest payload reduced over all processes is either the path data or the measures fused by volumetric::collect (which include a rank per measure)
+  internal_node_hierarchy.init(std::max(critical_path_costs_size,volumetric::get_collect_size())*sizeof(double));
+  path::allocate();
+  internal_overhead_governor.init();
 
-  if (eager_p2p){
-    int eager_msg_sizes[8];
-    MPI_Pack_size(1,MPI_CHAR,comm,&eager_msg_sizes[0]);
-    MPI_Pack_size(1,MPI_CHAR,comm,&eager_msg_sizes[1]);
-    MPI_Pack_size(num_critical_path_measures,MPI_DOUBLE_INT,comm,&eager_msg_sizes[2]);
-    MPI_Pack_size(critical_path_costs_size,MPI_DOUBLE,comm,&eager_msg_sizes[3]);
-    MPI_Pack_size(1,MPI_INT,comm,&eager_msg_sizes[4]);
-    MPI_Pack_size(max_num_symbols,MPI_INT,comm,&eager_msg_sizes[5]);
-    MPI_Pack_size(max_num_symbols*max_timer_name_length,MPI_CHAR,comm,&eager_msg_sizes[6]);
-    MPI_Pack_size(symbol_path_select_size*(cp_symbol_class_count*num_per_process_measures+1)*max_num_symbols,MPI_DOUBLE,comm,&eager_msg_sizes[7]);
-    int eager_pad_size = 8*MPI_BSEND_OVERHEAD;
-    for (int i=0; i<8; i++) { eager_pad_size += eager_msg_sizes[i]; }
-    eager_pad.resize(eager_pad_size);
-  }
+}
+
+void deallocate(){
+  path::deallocate();
+  volumetric::deallocate();
+  internal_node_hierarchy.free();
 }
 
 void reset(){
+  assert(internal_comm_table.size() == 0);
   for (auto i=0; i<list_size; i++){ list[i]->init(); }
   memset(&critical_path_costs[0],0,sizeof(double)*critical_path_costs.size());
+  if (mechanism == 1){ deferral::reset(); }
+  internal_path_sampler.reset();
+  internal_overhead_counter.reset();
+  internal_overhead_governor.reset();
   memset(&max_per_process_costs[0],0,sizeof(double)*max_per_process_costs.size());
   memset(&volume_costs[0],0,sizeof(double)*volume_costs.size());
   memset(&symbol_timer_pad_local_cp[0],0,sizeof(double)*symbol_timer_pad_local_cp.size());
@@ -98,34 +101,25 @@ void reset(){
   memset(&symbol_timer_pad_local_vol[0],0,sizeof(double)*symbol_timer_pad_local_vol.size());
 }
 
-void open_symbol(const char* symbol, double curtime){
-  if (symbol_timers.find(symbol) == symbol_timers.end()){
-    symbol_timers[symbol] = symbol_tracker(symbol);
-    symbol_order[symbol_timers.size()-1] = symbol;
-    symbol_timers[symbol].start(curtime);
-  }
-  else{
-    symbol_timers[symbol].start(curtime);
-  }
+void open_symbol(int id, double curtime){
+  int index = get_symbol_index(id);
+  symbol_timers[index].start(curtime);
 }
 
-void close_symbol(const char* symbol, double curtime){
-  if (symbol_timers.find(symbol) == symbol_timers.end()){
-    assert(0);
-  }
-  else{
-    symbol_timers[symbol].stop(curtime);
-  }
+void close_symbol(int id, double curtime){
+  int index = get_symbol_index(id);
+  symbol_timers[index].stop(curtime);
 }
 
 
 void final_accumulate(double last_time){
+  assert(internal_comm_table.size() == 0);
   critical_path_costs[num_critical_path_measures-2]+=(last_time-computation_timer);	// update critical path computation time
   critical_path_costs[num_critical_path_measures-1]+=(last_time-computation_timer);	// update critical path runtime
   volume_costs[num_volume_measures-2]+=(last_time-computation_timer);			// update computation time volume
   volume_costs[num_volume_measures-1]+=(last_time-computation_timer);			// update runtime volume
   // update the computation time (i.e. time between last MPI synchronization point and this function invocation) along all paths decomposed by MPI communication routine
-  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_costs[critical_path_costs_size-1-i] += (last_time-computation_timer); }
+  for (size_t i=0; i<comm_path_select_size; i++){ critical_path_breakdown[critical_path_breakdown_size-1-i] += (last_time-computation_timer); }
   // Save the communication pattern
   if (opt){
     //TODO: we will assume both costs models are chosen.
@@ -138,7 +132,7 @@ void final_accumulate(double last_time){
 
 
 void clear(){
-  symbol_timers.clear();
+  clear_symbols();
 }
 
 }
@@ -8,9 +8,10 @@ namespace internal{
 namespace decomposition{
 
 void allocate(MPI_Comm comm);
+void deallocate();
 void reset();
-void open_symbol(const char* symbol, double curtime);
-void close_symbol(const char* symbol, double curtime);
+void open_symbol(int id, double curtime);
+void close_symbol(int id, double curtime);
 void final_accumulate(double last_time);
 void clear();
 
@@ -1,173 +1,253 @@
 #include "volumetric.h"
 #include "../container/comm_tracker.h"
 #include "../container/symbol_tracker.h"
+#include "../container/envelope_pool.h"
+#include "../container/node_hierarchy.h"
+#include "../container/overhead_counter.h"
+#include "../../util/symbol_registry.h"
 
 namespace critter{
 namespace internal{
 namespace decomposition{
 
+// The fixed-size measures gathered at the end of an iteration are reduced at once, as a single element of 'collect_type'. Its layout:
+//   per-process measures, the rank attaining each, the breakdown of each decomposed path as seen by the rank attaining its measure,
+//   volumetric measures, and the high-water marks of the envelope pool.
+static CRITTER_RANK_LOCAL size_t collect_size;
+static CRITTER_RANK_LOCAL size_t path_block_size;
+static CRITTER_RANK_LOCAL std::vector<size_t> path_measures;// index of the per-process measure that selects the process whose breakdown is reported for each decomposed path
+static CRITTER_RANK_LOCAL std::vector<double> collect_buffer;
+static CRITTER_RANK_LOCAL MPI_Datatype collect_type = MPI_DATATYPE_NULL;
+static CRITTER_RANK_LOCAL MPI_Op collect_op = MPI_OP_NULL;
+// Sorted global ids of the symbols tracked by any process, and the volumetric symbol data laid out in their order
+static CRITTER_RANK_LOCAL std::vector<uint64_t> symbol_union_ids;
+static CRITTER_RANK_LOCAL std::vector<double> symbol_volume_pad;
+
+// As with MPI_MAXLOC, ties go to the lower rank, which makes the operator commutative
+static inline bool prevails(double value, double rank, double other_value, double other_rank){
+  return (value > other_value) || ((value == other_value) && (rank < other_rank));
+}
+
+static void collect_op_function(double* in, double* inout, int* len, MPI_Datatype* dtype){
+  for (int n=0; n<*len; n++, in+=collect_size, inout+=collect_size){
+    double* in_ranks = in+num_per_process_measures;
+    double* inout_ranks = inout+num_per_process_measures;
+    // The path breakdowns are selected before the per-process measures they are selected by are overwritten
+    size_t offset = 2*num_per_process_measures;
+    for (size_t k=0; k<path_measures.size(); k++){
+      size_t z = path_measures[k];
+      if (prevails(in[z],in_ranks[z],inout[z],inout_ranks[z])){
+        std::memcpy(inout+offset+k*path_block_size,in+offset+k*path_block_size,path_block_size*sizeof(double));
+      }
+    }
+    for (size_t i=0; i<num_per_process_measures; i++){
+      if (prevails(in[i],in_ranks[i],inout[i],inout_ranks[i])){
+        inout[i] = in[i];
+        inout_ranks[i] = in_ranks[i];
+      }
+    }
+    offset += path_measures.size()*path_block_size;
+    for (size_t i=0; i<volume_costs_size; i++){ inout[offset+i] += in[offset+i]; }
+    offset += volume_costs_size;
+    inout[offset] = std::max(inout[offset],in[offset]);
+    inout[offset+1] = std::max(inout[offset+1],in[offset+1]);
+  }
+}
+
+void volumetric::allocate(){
+  path_block_size = num_tracker_per_process_measures*list_size+2;
+  path_measures.clear();
+  for (size_t i=0; i<comm_path_select.size(); i++){// don't consider idle time an option
+    if (comm_path_select[i] == '1'){ path_measures.push_back(i<(2*cost_model_size) ? i : i+1); }// careful indexing to avoid idle time
+  }
+  collect_size = 2*num_per_process_measures + path_measures.size()*path_block_size + volume_costs_size + 2;
+  collect_buffer.resize(collect_size);
+  MPI_Type_contiguous(collect_size,MPI_DOUBLE,&collect_type);
+  MPI_Type_commit(&collect_type);
+  MPI_Op_create((MPI_User_function*) collect_op_function,1,&collect_op);
+}
+
+void volumetric::deallocate(){
+  MPI_Type_free(&collect_type);
+  MPI_Op_free(&collect_op);
+}
+
+size_t volumetric::get_collect_size(){
+  return collect_size;
+}
+
 void volumetric::collect(MPI_Comm cm){
-  // First compute per-process max
+  internal_overhead_counter.enter(overhead_collect);
   int rank; MPI_Comm_rank(cm,&rank);
+  int world_size; MPI_Comm_size(MPI_COMM_WORLD,&world_size);
+  int world_rank; MPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
+  double* ranks = &collect_buffer[num_per_process_measures];
+  double* path_blocks = &collect_buffer[2*num_per_process_measures];
+  double* volumes = path_blocks+path_measures.size()*path_block_size;
+  for (size_t i=0; i<num_per_process_measures; i++){
+    collect_buffer[i] = volume_costs[i];
+    ranks[i] = rank;
+  }
+  for (size_t k=0; k<path_measures.size(); k++){
+    std::memcpy(path_blocks+k*path_block_size,&volume_costs[num_volume_measures],(path_block_size-2)*sizeof(double));
+    path_blocks[(k+1)*path_block_size-2] = volume_costs[num_volume_measures-2];
+    path_blocks[(k+1)*path_block_size-1] = volume_costs[num_volume_measures-5];
+  }
+  std::memcpy(volumes,&volume_costs[0],volume_costs_size*sizeof(double));
+  volumes[volume_costs_size] = internal_envelope_pool.high_water_bytes();
+  volumes[volume_costs_size+1] = internal_envelope_pool.slab_count();
+  internal_node_hierarchy.allreduce(&collect_buffer[0], 1, collect_type, collect_op, cm);
+
   double_int buffer[num_per_process_measures];
   for (size_t i=0; i<num_per_process_measures; i++){
-    max_per_process_costs[i] = volume_costs[i];
-    buffer[i].first          = volume_costs[i];
-    buffer[i].second         = rank;
+    max_per_process_costs[i] = collect_buffer[i];
+    buffer[i].first          = collect_buffer[i];
+    buffer[i].second         = (int)ranks[i];
   }
-  PMPI_Allreduce(MPI_IN_PLACE, &max_per_process_costs[0], num_per_process_measures, MPI_DOUBLE, MPI_MAX, cm);
-  PMPI_Allreduce(MPI_IN_PLACE, &buffer[0], num_per_process_measures, MPI_DOUBLE_INT, MPI_MAXLOC, cm);
-  size_t save=0;
-  for (size_t i=0; i<comm_path_select.size(); i++){// don't consider idle time an option
-    if (comm_path_select[i] == '0') continue;
-    size_t z = i<(2*cost_model_size) ? i : i+1;	// careful indexing to avoid idle time
-    if (rank == buffer[z].second){
-      for (size_t j=0; j<num_tracker_per_process_measures*list_size; j++){
-        max_per_process_costs[num_per_process_measures+save*(num_tracker_per_process_measures*list_size+2)+j] = volume_costs[num_volume_measures+j];
-      }
-      max_per_process_costs[num_per_process_measures+(save+1)*(num_tracker_per_process_measures*list_size+2)-2] = volume_costs[num_volume_measures-2];
-      max_per_process_costs[num_per_process_measures+(save+1)*(num_tracker_per_process_measures*list_size+2)-1] = volume_costs[num_volume_measures-5];
-    }
-    else{
-      for (size_t j=0; j<num_tracker_per_process_measures*list_size+2; j++){
-        max_per_process_costs[num_per_process_measures+save*(num_tracker_per_process_measures*list_size+2)+j] = 0.;
-      }
-    }
-    PMPI_Allreduce(MPI_IN_PLACE, &max_per_process_costs[num_per_process_measures+save*(num_tracker_per_process_measures*list_size+2)], num_tracker_per_process_measures*list_size+2, MPI_DOUBLE, MPI_MAX, cm);
-    save++;
+  std::memcpy(&max_per_process_costs[num_per_process_measures],path_blocks,path_measures.size()*path_block_size*sizeof(double));
+  internal_envelope_pool.max_high_water[0] = volumes[volume_costs_size];
+  internal_envelope_pool.max_high_water[1] = volumes[volume_costs_size+1];
+  // Now compute volumetric average
+  if (mode){
+    for (size_t i=0; i<volume_costs_size; i++){ volume_costs[i] = volumes[i]/(1.*world_size); }
   }
   // For now, buffer[num_per_process_measures-1].second holds the rank of the process with the max per-process runtime
   if (mode && symbol_path_select_size>0){
     // copy data to volume buffers to avoid corruption
-    std::memcpy(&symbol_timer_pad_local_vol[0], &symbol_timer_pad_local_pp[0], (vol_symbol_class_count*num_volume_measures+1)*max_num_symbols*sizeof(double));
+    std::memcpy(&symbol_timer_pad_local_vol[0], &symbol_timer_pad_local_pp[0], (vol_symbol_class_count*num_volume_measures+1)*symbol_timers.size()*sizeof(double));
 
     int per_process_runtime_root_rank = buffer[num_per_process_measures-1].second;
     // We consider only critical path runtime
-    int ftimer_size = 0;
+    // The header holds the root's symbol count, the count of names it has not yet sent to all of 'cm', and their total length
+    int symbol_header[3];
+    size_t first_name = 0;
     if (rank==per_process_runtime_root_rank){
-      ftimer_size = symbol_timers.size();
+      first_name = pack_symbol_header(cm,-1,symbol_header);
     }
-    PMPI_Allreduce(MPI_IN_PLACE,&ftimer_size,1,MPI_INT,MPI_SUM,cm);
-
-    for (auto i=0; i<symbol_len_pad_cp.size(); i++){ symbol_len_pad_cp[i]=0.; }
-    if (rank==per_process_runtime_root_rank){
-      int symbol_offset = 0;
-      for (auto i=0; i<symbol_timers.size(); i++){
-        symbol_len_pad_cp[i] = symbol_order[i].size();
-        for (auto j=0; j<symbol_len_pad_cp[i]; j++){
-          symbol_pad_cp[symbol_offset+j] = symbol_order[i][j];
-        }
-        symbol_offset += symbol_len_pad_cp[i];
+    PMPI_Bcast(&symbol_header[0],3,MPI_INT,per_process_runtime_root_rank,cm);
+    if (rank==per_process_runtime_root_rank) internal_overhead_counter.message(3*sizeof(int));
+    int ftimer_size = symbol_header[0];
+    if (symbol_header[1]>0){
+      reserve_pad(symbol_len_pad_cp,symbol_header[1]);
+      reserve_pad(symbol_pad_cp,symbol_header[2]);
+      if (rank==per_process_runtime_root_rank){
+        pack_symbol_names(first_name,&symbol_len_pad_cp[0],&symbol_pad_cp[0]);
+      }
+      PMPI_Bcast(&symbol_len_pad_cp[0],symbol_header[1],MPI_INT,per_process_runtime_root_rank,cm);
+      PMPI_Bcast(&symbol_pad_cp[0],symbol_header[2],MPI_CHAR,per_process_runtime_root_rank,cm);
+      if (rank==per_process_runtime_root_rank){
+        internal_overhead_counter.message(symbol_header[1]*sizeof(int));
+        internal_overhead_counter.message(symbol_header[2]);
+      }
+      if (rank!=per_process_runtime_root_rank){
+        unpack_symbol_names(symbol_header[1],&symbol_len_pad_cp[0],&symbol_pad_cp[0]);
       }
     }
-    PMPI_Allreduce(MPI_IN_PLACE,&symbol_len_pad_cp[0],ftimer_size,MPI_INT,MPI_SUM,cm);
-
-    int num_chars = 0;
-    for (auto i=0; i<ftimer_size; i++){
-      num_chars += symbol_len_pad_cp[i];
-    }
+    reserve_pad(symbol_id_pad_cp,ftimer_size);
+    reserve_pad(symbol_timer_pad_global_pp,(pp_symbol_class_count*num_per_process_measures+1)*ftimer_size);
     if (rank == per_process_runtime_root_rank){
+      pack_symbol_ids(&symbol_id_pad_cp[0]);
+      PMPI_Bcast(&symbol_id_pad_cp[0],ftimer_size,MPI_UINT64_T,rank,cm);
       PMPI_Bcast(&symbol_timer_pad_local_pp[0],(pp_symbol_class_count*num_per_process_measures+1)*ftimer_size,MPI_DOUBLE,rank,cm);
-      PMPI_Bcast(&symbol_pad_cp[0],num_chars,MPI_CHAR,rank,cm);
+      internal_overhead_counter.message(ftimer_size*sizeof(uint64_t));
+      internal_overhead_counter.message((pp_symbol_class_count*num_per_process_measures+1)*ftimer_size*sizeof(double));
     }
     else{
+      PMPI_Bcast(&symbol_id_pad_cp[0],ftimer_size,MPI_UINT64_T,per_process_runtime_root_rank,cm);
       PMPI_Bcast(&symbol_timer_pad_global_pp[0],(pp_symbol_class_count*num_per_process_measures+1)*ftimer_size,MPI_DOUBLE,per_process_runtime_root_rank,cm);
-      PMPI_Bcast(&symbol_pad_cp[0],num_chars,MPI_CHAR,per_process_runtime_root_rank,cm);
-      int symbol_offset = 0;
       for (int i=0; i<ftimer_size; i++){
-        auto reconstructed_symbol = std::string(symbol_pad_cp.begin()+symbol_offset,symbol_pad_cp.begin()+symbol_offset+symbol_len_pad_cp[i]);
-        if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-          symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-          symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-        }
-        *symbol_timers[reconstructed_symbol].pp_numcalls = symbol_timer_pad_global_pp[(pp_symbol_class_count*num_per_process_measures+1)*i];
+        int reconstructed_index = get_global_symbol_index(symbol_id_pad_cp[i]);
+        *symbol_timers[reconstructed_index].pp_numcalls = symbol_timer_pad_global_pp[(pp_symbol_class_count*num_per_process_measures+1)*i];
         for (int j=0; j<num_per_process_measures; j++){
-          symbol_timers[reconstructed_symbol].pp_incl_measure[j] = symbol_timer_pad_global_pp[(pp_symbol_class_count*num_per_process_measures+1)*i+j+1];
-          symbol_timers[reconstructed_symbol].pp_excl_measure[j] = symbol_timer_pad_global_pp[(pp_symbol_class_count*num_per_process_measures+1)*i+num_per_process_measures+j+1];
+          symbol_timers[reconstructed_index].pp_incl_measure[j] = symbol_timer_pad_global_pp[(pp_symbol_class_count*num_per_process_measures+1)*i+j+1];
+          symbol_timers[reconstructed_index].pp_excl_measure[j] = symbol_timer_pad_global_pp[(pp_symbol_class_count*num_per_process_measures+1)*i+num_per_process_measures+j+1];
         }
-        symbol_timers[reconstructed_symbol].has_been_processed = true;
-        symbol_offset += symbol_len_pad_cp[i];
+        symbol_timers[reconstructed_index].has_been_processed = true;
       }
       // Now cycle through and find the symbols that were not processed and set their accumulated measures to 0
       for (auto& it : symbol_timers){
-        if (it.second.has_been_processed){ it.second.has_been_processed = false; }
+        if (it.has_been_processed){ it.has_been_processed = false; }
         else{
-          *it.second.pp_numcalls = 0;
+          *it.pp_numcalls = 0;
           for (int j=0; j<num_per_process_measures; j++){
-            it.second.pp_incl_measure[j] = 0;
-            it.second.pp_excl_measure[j] = 0;
+            it.pp_incl_measure[j] = 0;
+            it.pp_excl_measure[j] = 0;
           }
         }
       }
     }
   }
 
-  // Now compute volumetric average
-  int world_size; MPI_Comm_size(MPI_COMM_WORLD,&world_size);
-  int world_rank; MPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
-  if (mode){
-    PMPI_Allreduce(MPI_IN_PLACE, &volume_costs[0], volume_costs.size(), MPI_DOUBLE, MPI_SUM, cm);
-    for (int i=0; i<volume_costs.size(); i++){ volume_costs[i] /= (1.*world_size); }
-  }
   if (mode && symbol_path_select_size>0){
-    size_t active_size = world_size;
-    size_t active_rank = world_rank;
-    size_t active_mult = 1;
-    while (active_size>1){
-      if (active_rank % 2 == 1){
-        int partner = (active_rank-1)*active_mult;
-        int ftimer_size = symbol_timers.size();
-        PMPI_Send(&ftimer_size, 1, MPI_INT, partner, internal_tag, cm);
-        for (auto i=0; i<symbol_len_pad_cp.size(); i++){ symbol_len_pad_cp[i]=0.; }
-        int symbol_offset = 0;
-        for (auto i=0; i<symbol_timers.size(); i++){
-          symbol_len_pad_cp[i] = symbol_order[i].size();
-          for (auto j=0; j<symbol_len_pad_cp[i]; j++){
-            symbol_pad_cp[symbol_offset+j] = symbol_order[i][j];
-          }
-          symbol_offset += symbol_len_pad_cp[i];
-        }
-        PMPI_Send(&symbol_len_pad_cp[0],ftimer_size,MPI_INT,partner,internal_tag1,cm);
-        int num_chars = 0;
-        for (auto i=0; i<ftimer_size; i++){
-          num_chars += symbol_len_pad_cp[i];
-        }
-        PMPI_Send(&symbol_timer_pad_local_vol[0],(vol_symbol_class_count*num_volume_measures+1)*ftimer_size,MPI_DOUBLE,partner,internal_tag2,cm);
-        PMPI_Send(&symbol_pad_cp[0],num_chars,MPI_CHAR,partner,internal_tag3,cm);
-        break;
+    // The volumetric symbol data of all processes is summed onto rank 0 of 'cm' in a single reduction over the union of symbols,
+    //   laid out by global id. Rank 0 first gathers the global ids of each process's symbols, along with any names it has not yet received.
+    int size; MPI_Comm_size(cm,&size);
+    int message_size = 0;
+    if (rank != 0){
+      int symbol_header[3];
+      size_t first_name = pack_symbol_header(cm,0,symbol_header);
+      message_size = get_symbol_message_size(symbol_header,0);
+      reserve_pad(symbol_msg_pad_cp,message_size);
+      pack_symbol_message(&symbol_msg_pad_cp[0],symbol_header,first_name,nullptr,0);
+    }
+    std::vector<int> message_sizes(rank == 0 ? size : 0), message_displs(rank == 0 ? size : 0);
+    PMPI_Gather(&message_size,1,MPI_INT,message_sizes.data(),1,MPI_INT,0,cm);
+    internal_overhead_counter.message(sizeof(int));
+    if (rank == 0){
+      // Each message is placed as malloc would align it, as its fields are read in place
+      constexpr int alignment = alignof(std::max_align_t);
+      int total_size = 0;
+      for (int i=0; i<size; i++){
+        message_displs[i] = total_size;
+        total_size += (message_sizes[i] + alignment - 1) & ~(alignment - 1);
       }
-      else if ((active_rank % 2 == 0) && (active_rank < (active_size-1))){
-        int partner = (active_rank+1)*active_mult;
-        int ftimer_size_foreign;
-        PMPI_Recv(&ftimer_size_foreign, 1, MPI_INT, partner, internal_tag, cm, MPI_STATUS_IGNORE);
-        PMPI_Recv(&symbol_len_pad_cp[0],ftimer_size_foreign,MPI_INT,partner, internal_tag1, cm, MPI_STATUS_IGNORE);
-        int num_chars = 0;
-        for (auto i=0; i<ftimer_size_foreign; i++){
-          num_chars += symbol_len_pad_cp[i];
-        }
-        PMPI_Recv(&symbol_timer_pad_global_vol[0],(vol_symbol_class_count*num_volume_measures+1)*ftimer_size_foreign,MPI_DOUBLE,partner,internal_tag2,cm, MPI_STATUS_IGNORE);
-        PMPI_Recv(&symbol_pad_cp[0],num_chars,MPI_CHAR,partner, internal_tag3,cm, MPI_STATUS_IGNORE);
-        int symbol_offset = 0;
-        for (int i=0; i<ftimer_size_foreign; i++){
-          auto reconstructed_symbol = std::string(symbol_pad_cp.begin()+symbol_offset,symbol_pad_cp.begin()+symbol_offset+symbol_len_pad_cp[i]);
-          if (symbol_timers.find(reconstructed_symbol) == symbol_timers.end()){
-            symbol_timers[reconstructed_symbol] = symbol_tracker(reconstructed_symbol);
-            symbol_order[(symbol_timers.size()-1)] = reconstructed_symbol;
-          }
-          *symbol_timers[reconstructed_symbol].vol_numcalls += symbol_timer_pad_global_vol[(vol_symbol_class_count*num_per_process_measures+1)*i];
-          for (int j=0; j<num_volume_measures; j++){
-            symbol_timers[reconstructed_symbol].vol_incl_measure[j] += symbol_timer_pad_global_vol[(vol_symbol_class_count*num_volume_measures+1)*i+j+1];
-            symbol_timers[reconstructed_symbol].vol_excl_measure[j] += symbol_timer_pad_global_vol[(vol_symbol_class_count*num_volume_measures+1)*i+num_volume_measures+j+1];
-          }
-          symbol_timers[reconstructed_symbol].has_been_processed = true;
-          symbol_offset += symbol_len_pad_cp[i];
-        }
+      reserve_pad(symbol_msg_pad_ncp1,std::max(total_size,1));
+    }
+    PMPI_Gatherv(symbol_msg_pad_cp.data(),message_size,MPI_BYTE,symbol_msg_pad_ncp1.data(),message_sizes.data(),message_displs.data(),MPI_BYTE,0,cm);
+    internal_overhead_counter.message(message_size);
+    int union_size = symbol_timers.size();
+    symbol_union_ids.resize(union_size);
+    pack_symbol_ids(symbol_union_ids.data());
+    if (rank == 0){
+      for (int i=1; i<size; i++){
+        symbol_message message = unpack_symbol_message(&symbol_msg_pad_ncp1[message_displs[i]]);
+        symbol_union_ids.insert(symbol_union_ids.end(),message.ids,message.ids+message.header[0]);
       }
-      active_size = active_size/2 + active_size%2;
-      active_rank /= 2;
-      active_mult *= 2;
+      std::sort(symbol_union_ids.begin(),symbol_union_ids.end());
+      symbol_union_ids.erase(std::unique(symbol_union_ids.begin(),symbol_union_ids.end()),symbol_union_ids.end());
+      union_size = symbol_union_ids.size();
+    }
+    PMPI_Bcast(&union_size,1,MPI_INT,0,cm);
+    symbol_union_ids.resize(union_size);
+    PMPI_Bcast(symbol_union_ids.data(),union_size,MPI_UINT64_T,0,cm);
+    if (rank == 0){
+      internal_overhead_counter.message(sizeof(int));
+      internal_overhead_counter.message(union_size*sizeof(uint64_t));
+    }
+
+    size_t stride = 2*num_volume_measures+1;
+    symbol_volume_pad.assign(stride*union_size,0.);
+    internal_overhead_counter.message(stride*union_size*sizeof(double));
+    for (auto& it : symbol_timers){
+      size_t pos = std::lower_bound(symbol_union_ids.begin(),symbol_union_ids.end(),get_symbol_global_id(it.id)) - symbol_union_ids.begin();
+      symbol_volume_pad[stride*pos] = *it.vol_numcalls;
+      std::memcpy(&symbol_volume_pad[stride*pos+1],it.vol_incl_measure,num_volume_measures*sizeof(double));
+      std::memcpy(&symbol_volume_pad[stride*pos+1+num_volume_measures],it.vol_excl_measure,num_volume_measures*sizeof(double));
+    }
+    if (rank == 0){
+      PMPI_Reduce(MPI_IN_PLACE,symbol_volume_pad.data(),stride*union_size,MPI_DOUBLE,MPI_SUM,0,cm);
+      for (int i=0; i<union_size; i++){
+        symbol_tracker& tracker = symbol_timers[get_global_symbol_index(symbol_union_ids[i])];
+        *tracker.vol_numcalls = symbol_volume_pad[stride*i];
+        std::memcpy(tracker.vol_incl_measure,&symbol_volume_pad[stride*i+1],num_volume_measures*sizeof(double));
+        std::memcpy(tracker.vol_excl_measure,&symbol_volume_pad[stride*i+1+num_volume_measures],num_volume_measures*sizeof(double));
+      }
+    }
+    else{
+      PMPI_Reduce(symbol_volume_pad.data(),nullptr,stride*union_size,MPI_DOUBLE,MPI_SUM,0,cm);
     }
   }
+  internal_overhead_counter.exit();
 }
 
 }
@@ -9,7 +9,13 @@ namespace decomposition{
 
 class volumetric{
 public:
+  /** \brief create the datatype and operator with which collect() reduces all fixed-size measures at once */
+  static void allocate();
+  static void deallocate();
+  /** \brief reduce the measures of all processes in 'comm' for reporting */
   static void collect(MPI_Comm comm);
+  /** \brief number of doubles reduced by collect() */
+  static size_t get_collect_size();
 };
 
 }
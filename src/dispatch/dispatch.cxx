@@ -1,9 +1,12 @@
 #include "dispatch.h"
 #include "../decomposition/container/comm_tracker.h"
+#include "../decomposition/container/path_sampler.h"
+#include "../decomposition/container/overhead_counter.h"
 #include "../decomposition/util/util.h"
 #include "../decomposition/volumetric/volumetric.h"
 #include "../decomposition/path/path.h"
 #include "../decomposition/record/record.h"
+#include "../decomposition/deferral/deferral.h"
 #include "../optimization/path/path.h"
 
 namespace critter{
@@ -12,31 +15,43 @@ namespace internal{
 void allocate(MPI_Comm comm){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::allocate(comm);
   }
 }
 
+void deallocate(){
+  switch (mechanism){
+    case 0:
+    case 1:
+      decomposition::deallocate();
+  }
+}
+
 void reset(){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::reset();
   }
 }
 
 void initiate(size_t id, volatile double curtime, int64_t nelem, MPI_Datatype t, MPI_Comm cm,
-              bool is_sender, int partner1, int partner2){
+              bool is_sender, int partner1, int partner2, int root){
   switch (mechanism){
     case 0:
-      decomposition::path::initiate(*(decomposition::blocking*)decomposition::list[id],curtime,nelem,t,cm,is_sender,partner1,partner2);
+    case 1:
+      decomposition::path::initiate(*(decomposition::blocking*)decomposition::list[id],curtime,nelem,t,cm,is_sender,partner1,partner2,root);
       break;
   }
 }
 
 void initiate(size_t id, volatile double curtime, volatile double itime, int64_t nelem,
-              MPI_Datatype t, MPI_Comm cm, MPI_Request* request, bool is_sender, int partner){
+              MPI_Datatype t, MPI_Comm cm, MPI_Request* request, bool is_sender, int partner, int root){
   switch (mechanism){
     case 0:
-      decomposition::path::initiate(*(decomposition::nonblocking*)decomposition::list[id],curtime,itime,nelem,t,cm,request,is_sender,partner);
+    case 1:
+      decomposition::path::initiate(*(decomposition::nonblocking*)decomposition::list[id],curtime,itime,nelem,t,cm,request,is_sender,partner,root);
       break;
   }
 }
@@ -44,6 +59,7 @@ void initiate(size_t id, volatile double curtime, volatile double itime, int64_t
 void complete(size_t id, int recv_source){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::path::complete(*(decomposition::blocking*)decomposition::list[id],recv_source);
       break;
   }
@@ -52,6 +68,7 @@ void complete(size_t id, int recv_source){
 void complete(double curtime, MPI_Request* request, MPI_Status* status){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::path::complete(curtime,request,status);
       break;
   }
@@ -60,6 +77,7 @@ void complete(double curtime, MPI_Request* request, MPI_Status* status){
 void complete(double curtime, int count, MPI_Request array_of_requests[], int* indx, MPI_Status* status){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::path::complete(curtime,count,array_of_requests,indx,status);
       break;
   }
@@ -68,6 +86,7 @@ void complete(double curtime, int count, MPI_Request array_of_requests[], int* i
 void complete(double curtime, int incount, MPI_Request array_of_requests[], int* outcount, int array_of_indices[], MPI_Status array_of_statuses[]){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::path::complete(curtime,incount,array_of_requests,outcount,array_of_indices,array_of_statuses);
       break;
   }
@@ -76,14 +95,43 @@ void complete(double curtime, int incount, MPI_Request array_of_requests[], int*
 void complete(double curtime, int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::path::complete(curtime,count,array_of_requests,array_of_statuses);
       break;
   }
 }
 
+MPI_Datatype piggyback(size_t id, const void* buf, int count, MPI_Datatype t, bool is_sender){
+  switch (mechanism){
+    case 0:
+    case 1:
+      return decomposition::path::piggyback(*(decomposition::blocking*)decomposition::list[id],buf,count,t,is_sender);
+  }
+  return t;
+}
+
+MPI_Datatype piggyback(size_t id, volatile double curtime, const void* buf, int count, MPI_Datatype t, bool is_sender){
+  switch (mechanism){
+    case 0:
+    case 1:
+      return decomposition::path::piggyback(*(decomposition::nonblocking*)decomposition::list[id],curtime,buf,count,t,is_sender);
+  }
+  return t;
+}
+
+void unwrap(MPI_Datatype* wrapped, MPI_Datatype t, MPI_Status* status){
+  switch (mechanism){
+    case 0:
+    case 1:
+      decomposition::path::unwrap(wrapped,t,status);
+      break;
+  }
+}
+
 void propagate(MPI_Comm comm){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::_MPI_Barrier.comm = comm;
       decomposition::path::propagate(decomposition::_MPI_Barrier);
       break;
@@ -93,7 +141,15 @@ void propagate(MPI_Comm comm){
 void collect(MPI_Comm comm){
   switch (mechanism){
     case 0:
+      decomposition::internal_path_sampler.collect(comm);
+      decomposition::volumetric::collect(comm);
+      decomposition::internal_overhead_counter.collect(comm);
+      break;
+    case 1:
+      decomposition::deferral::resolve(comm);
+      decomposition::internal_path_sampler.collect(comm);
       decomposition::volumetric::collect(comm);
+      decomposition::internal_overhead_counter.collect(comm);
       break;
   }
 }
@@ -101,23 +157,26 @@ void collect(MPI_Comm comm){
 void final_accumulate(double last_time){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::final_accumulate(last_time);
       break;
   }
 }
 
-void open_symbol(const char* symbol, double curtime){
+void open_symbol(int id, double curtime){
   switch (mechanism){
     case 0:
-      decomposition::open_symbol(symbol,curtime);
+    case 1:
+      decomposition::open_symbol(id,curtime);
       break;
   }
 }
 
-void close_symbol(const char* symbol, double curtime){
+void close_symbol(int id, double curtime){
   switch (mechanism){
     case 0:
-      decomposition::close_symbol(symbol,curtime);
+    case 1:
+      decomposition::close_symbol(id,curtime);
       break;
   }
 }
@@ -125,6 +184,7 @@ void close_symbol(const char* symbol, double curtime){
 void clear(){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::clear();
       break;
   }
@@ -133,6 +193,7 @@ void clear(){
 void record(std::ofstream& Stream){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::record::invoke(Stream);
       break;
   }
@@ -141,6 +202,7 @@ void record(std::ofstream& Stream){
 void record(std::ostream& Stream){
   switch (mechanism){
     case 0:
+    case 1:
       decomposition::record::invoke(Stream);
       break;
   }
@@ -1,5 +1,6 @@
 #include "comm.h"
 #include "../util/util.h"
+#include "../util/metadata.h"
 #include "../dispatch/dispatch.h"
 
 namespace critter{
@@ -12,7 +13,6 @@ void start(){
   }
   internal::stack_id++;
   if (internal::stack_id>1) { return; }
-  assert(internal::internal_comm_info.size() == 0);
   internal::wait_id=true;
   internal::reset();
 
@@ -26,7 +26,6 @@ void stop(){
   internal::stack_id--; 
   if (internal::stack_id>0) { return; }
   PMPI_Barrier(MPI_COMM_WORLD);
-  assert(internal::internal_comm_info.size() == 0);
   internal::final_accumulate(last_time); 
   internal::propagate(MPI_COMM_WORLD);
   internal::collect(MPI_COMM_WORLD);
@@ -100,16 +99,13 @@ void _init(int* argc, char*** argv){
     file_name = std::getenv("CRITTER_VIZ_FILE");
     stream_name = file_name + ".txt";
   }
-  if (std::getenv("CRITTER_MAX_NUM_SYMBOLS") != NULL){
-    max_num_symbols = atoi(std::getenv("CRITTER_MAX_NUM_SYMBOLS"));
+  if (std::getenv("CRITTER_MAX_SYMBOL_DEPTH") != NULL){
+    max_symbol_depth = atoi(std::getenv("CRITTER_MAX_SYMBOL_DEPTH"));
   } else{
-    max_num_symbols = 15;
-  }
-  if (std::getenv("CRITTER_MAX_SYMBOL_LENGTH") != NULL){
-    max_timer_name_length = atoi(std::getenv("CRITTER_MAX_SYMBOL_LENGTH"));
-  } else{
-    max_timer_name_length = 25;
+    max_symbol_depth = 64;
   }
+  // Widened as longer symbol names are registered
+  max_timer_name_length = 25;
   if (std::getenv("CRITTER_AUTO") != NULL){
     auto_capture = atoi(std::getenv("CRITTER_AUTO"));
   } else{
@@ -135,6 +131,65 @@ void _init(int* argc, char*** argv){
   } else{
     eager_p2p = 0;
   }
+  if (std::getenv("CRITTER_PATH_ENCODING") != NULL){
+    path_encoding = atoi(std::getenv("CRITTER_PATH_ENCODING"));
+  } else{
+    path_encoding = 0;
+  }
+  assert(path_encoding <= 2);
+  if (std::getenv("CRITTER_CAUSAL_P2P") != NULL){
+    causal_p2p = atoi(std::getenv("CRITTER_CAUSAL_P2P"));
+  } else{
+    causal_p2p = 0;
+  }
+  if (std::getenv("CRITTER_PIGGYBACK_P2P") != NULL){
+    piggyback_p2p = atoi(std::getenv("CRITTER_PIGGYBACK_P2P"));
+  } else{
+    piggyback_p2p = 0;
+  }
+  // Path data piggybacked on user messages can only flow from sender to receiver
+  if (piggyback_p2p == 1){ causal_p2p = 1; }
+  // The deferred mechanism merges the predecessors of the decomposed paths as plain path data, which neither records nor piggybacked payloads carry
+  if (mechanism == 1){ assert(path_encoding == 0 && piggyback_p2p == 0); }
+  if (causal_p2p == 1){
+    // Without a reply from the receiver, there is no handshake with which to measure p2p idle time
+    assert(eager_p2p == 0);
+    track_p2p_idle = 0;
+  }
+  if (std::getenv("CRITTER_BATCH_WAITALL") != NULL){
+    batch_waitall = atoi(std::getenv("CRITTER_BATCH_WAITALL"));
+  } else{
+    batch_waitall = 0;
+  }
+  // A batch stands for several requests only in the internal communication that each completion of a request performs with its partner
+  if (batch_waitall == 1){ assert(eager_p2p == 0); assert(causal_p2p == 0); }
+  if (std::getenv("CRITTER_NODE_AWARE") != NULL){
+    node_aware = atoi(std::getenv("CRITTER_NODE_AWARE"));
+  } else{
+    node_aware = 1;
+  }
+  if (std::getenv("CRITTER_NODE_AWARE_MIN_BYTES") != NULL){
+    node_aware_min_bytes = atoi(std::getenv("CRITTER_NODE_AWARE_MIN_BYTES"));
+  } else{
+    node_aware_min_bytes = 64;
+  }
+  if (std::getenv("CRITTER_SAMPLE_RATE") != NULL){
+    sample_rate = atoi(std::getenv("CRITTER_SAMPLE_RATE"));
+  } else{
+    sample_rate = 1;
+  }
+  assert(sample_rate >= 1);
+  // The budget is given in percent of the application time (e.g. 5 or 5%)
+  if (std::getenv("CRITTER_MAX_OVERHEAD") != NULL){
+    max_overhead = atof(std::getenv("CRITTER_MAX_OVERHEAD"))/100.;
+  } else{
+    max_overhead = 0;
+  }
+  if (std::getenv("CRITTER_SELF_OVERHEAD") != NULL){
+    self_overhead = atoi(std::getenv("CRITTER_SELF_OVERHEAD"));
+  } else{
+    self_overhead = 0;
+  }
   if (std::getenv("CRITTER_DELETE_COMM") != NULL){
     delete_comm = atoi(std::getenv("CRITTER_DELETE_COMM"));
   }
@@ -186,6 +241,7 @@ void _init(int* argc, char*** argv){
   _MPI_Ialltoallv__id = 31;
   _MPI_Bsend__id = 32;
 
+  init_metadata();
   allocate(MPI_COMM_WORLD);
   if (auto_capture) start();
 }
@@ -227,7 +283,7 @@ void comm_free(MPI_Comm* comm){
 void bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    initiate(_MPI_Bcast__id,curtime, count, datatype, comm);
+    initiate(_MPI_Bcast__id,curtime, count, datatype, comm, false, -1, -1, root);
     PMPI_Bcast(buffer, count, datatype, root, comm);
     complete(_MPI_Bcast__id);
   }
@@ -239,7 +295,7 @@ void bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm co
 void reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    initiate(_MPI_Reduce__id,curtime, count, datatype, comm);
+    initiate(_MPI_Reduce__id,curtime, count, datatype, comm, false, -1, -1, root);
     PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
     complete(_MPI_Reduce__id);
   }
@@ -263,9 +319,9 @@ void allreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datat
 void gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     int64_t recvbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
-    initiate(_MPI_Gather__id,curtime, recvbuf_size, sendtype, comm);
+    initiate(_MPI_Gather__id,curtime, recvbuf_size, sendtype, comm, false, -1, -1, root);
     PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
     complete(_MPI_Gather__id);
   }
@@ -277,7 +333,7 @@ void gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* rec
 void allgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     int64_t recvbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
     initiate(_MPI_Allgather__id,curtime, recvbuf_size, sendtype, comm);
     PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
@@ -291,9 +347,9 @@ void allgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void*
 void scatter(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     int64_t sendbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
-    initiate(_MPI_Scatter__id,curtime, sendbuf_size, sendtype, comm);
+    initiate(_MPI_Scatter__id,curtime, sendbuf_size, sendtype, comm, false, -1, -1, root);
     PMPI_Scatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
     complete(_MPI_Scatter__id);
   }
@@ -306,7 +362,7 @@ void reduce_scatter(const void* sendbuf, void* recvbuf, const int recvcounts[],
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
     int64_t tot_recv=0;
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_recv += recvcounts[i]; }
     initiate(_MPI_Reduce_scatter__id,curtime, tot_recv, datatype, comm);
     PMPI_Reduce_scatter(sendbuf, recvbuf, recvcounts, datatype, op, comm);
@@ -320,7 +376,7 @@ void reduce_scatter(const void* sendbuf, void* recvbuf, const int recvcounts[],
 void alltoall(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     int64_t recvbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
     initiate(_MPI_Alltoall__id,curtime,recvbuf_size, sendtype, comm);
     PMPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
@@ -335,9 +391,9 @@ void gatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* re
              MPI_Datatype recvtype, int root, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int64_t tot_recv=0; int comm_size; MPI_Comm_size(comm, &comm_size);
+    int64_t tot_recv=0; int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_recv += ((int*)recvcounts)[i]; }
-    initiate(_MPI_Gatherv__id,curtime, std::max((int64_t)sendcount,tot_recv), sendtype, comm);
+    initiate(_MPI_Gatherv__id,curtime, std::max((int64_t)sendcount,tot_recv), sendtype, comm, false, -1, -1, root);
     PMPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
     complete(_MPI_Gatherv__id);
    }
@@ -350,7 +406,7 @@ void allgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void*
              MPI_Datatype recvtype, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int64_t tot_recv=0; int comm_size; MPI_Comm_size(comm, &comm_size);
+    int64_t tot_recv=0; int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_recv += recvcounts[i]; }
     initiate(_MPI_Allgatherv__id,curtime, std::max((int64_t)sendcount,tot_recv), sendtype, comm);
     PMPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm);
@@ -365,9 +421,9 @@ void scatterv(const void* sendbuf, const int* sendcounts, const int* displs, MPI
               void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int64_t tot_send=0; int comm_size;MPI_Comm_size(comm, &comm_size);
+    int64_t tot_send=0; int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_send += ((int*)sendcounts)[i]; } 
-    initiate(_MPI_Scatterv__id,curtime, std::max(tot_send,(int64_t)recvcount), sendtype, comm);
+    initiate(_MPI_Scatterv__id,curtime, std::max(tot_send,(int64_t)recvcount), sendtype, comm, false, -1, -1, root);
     PMPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm);
     complete(_MPI_Scatterv__id);
   }
@@ -380,7 +436,7 @@ void alltoallv(const void* sendbuf, const int* sendcounts, const int* sdispls, M
                const int* recvcounts, const int* rdispls, MPI_Datatype recvtype, MPI_Comm comm){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int64_t tot_send=0, tot_recv=0; int comm_size; MPI_Comm_size(comm, &comm_size);
+    int64_t tot_send=0, tot_recv=0; int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_send += sendcounts[i]; tot_recv += recvcounts[i]; }
     initiate(_MPI_Alltoallv__id,curtime, std::max(tot_send,tot_recv), sendtype, comm);
     PMPI_Alltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf, recvcounts, rdispls, recvtype, comm);
@@ -397,7 +453,16 @@ void sendrecv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, int des
     volatile double curtime = MPI_Wtime();
     assert(sendtag != internal_tag); assert(recvtag != internal_tag);
     initiate(_MPI_Sendrecv__id,curtime, std::max(sendcount,recvcount), sendtype, comm, true, dest, source);
-    PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag, recvbuf, recvcount, recvtype, source, recvtag, comm, status);
+    if (piggyback_p2p){
+      MPI_Datatype wrapped_sendtype = piggyback(_MPI_Sendrecv__id, sendbuf, sendcount, sendtype, true);
+      MPI_Datatype wrapped_recvtype = piggyback(_MPI_Sendrecv__id, recvbuf, recvcount, recvtype, false);
+      PMPI_Sendrecv(MPI_BOTTOM, 1, wrapped_sendtype, dest, sendtag, MPI_BOTTOM, 1, wrapped_recvtype, source, recvtag, comm, status);
+      unwrap(&wrapped_sendtype, sendtype);
+      unwrap(&wrapped_recvtype, recvtype, status);
+    }
+    else{
+      PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag, recvbuf, recvcount, recvtype, source, recvtag, comm, status);
+    }
     complete(_MPI_Sendrecv__id,(source==MPI_ANY_SOURCE ? status->MPI_SOURCE : -1));
   }
   else{
@@ -411,7 +476,14 @@ void sendrecv_replace(void* buf, int count, MPI_Datatype datatype, int dest, int
     volatile double curtime = MPI_Wtime();
     assert(sendtag != internal_tag); assert(recvtag != internal_tag);
     initiate(_MPI_Sendrecv_replace__id,curtime, count, datatype, comm, true, dest, source);
-    PMPI_Sendrecv_replace(buf, count, datatype, dest, sendtag, source, recvtag, comm, status);
+    if (piggyback_p2p){
+      MPI_Datatype wrapped = piggyback(_MPI_Sendrecv_replace__id, buf, count, datatype, false);
+      PMPI_Sendrecv_replace(MPI_BOTTOM, 1, wrapped, dest, sendtag, source, recvtag, comm, status);
+      unwrap(&wrapped, datatype, status);
+    }
+    else{
+      PMPI_Sendrecv_replace(buf, count, datatype, dest, sendtag, source, recvtag, comm, status);
+    }
     complete(_MPI_Sendrecv_replace__id,(source==MPI_ANY_SOURCE ? status->MPI_SOURCE : -1));
    }
   else{
@@ -424,7 +496,14 @@ void ssend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag,
     volatile double curtime = MPI_Wtime();
     assert(tag != internal_tag);
     initiate(_MPI_Ssend__id,curtime, count, datatype, comm, true, dest);
-    PMPI_Ssend(buf, count, datatype, dest, tag, comm);
+    if (piggyback_p2p){
+      MPI_Datatype wrapped = piggyback(_MPI_Ssend__id, buf, count, datatype, true);
+      PMPI_Ssend(MPI_BOTTOM, 1, wrapped, dest, tag, comm);
+      unwrap(&wrapped, datatype);
+    }
+    else{
+      PMPI_Ssend(buf, count, datatype, dest, tag, comm);
+    }
     complete(_MPI_Ssend__id);
   }
   else{
@@ -437,11 +516,18 @@ void bsend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag,
     volatile double curtime = MPI_Wtime();
     assert(tag != internal_tag);
     initiate(_MPI_Bsend__id,curtime, count, datatype, comm, true, dest);
-    PMPI_Bsend(buf, count, datatype, dest, tag, comm);
+    if (piggyback_p2p){
+      MPI_Datatype wrapped = piggyback(_MPI_Bsend__id, buf, count, datatype, true);
+      PMPI_Bsend(MPI_BOTTOM, 1, wrapped, dest, tag, comm);
+      unwrap(&wrapped, datatype);
+    }
+    else{
+      PMPI_Bsend(buf, count, datatype, dest, tag, comm);
+    }
     complete(_MPI_Bsend__id);
   }
   else{
-    PMPI_Ssend(buf, count, datatype, dest, tag, comm);
+    PMPI_Bsend(buf, count, datatype, dest, tag, comm);
   }
 }
 
@@ -450,7 +536,14 @@ void send(const void* buf, int count, MPI_Datatype datatype, int dest, int tag,
     volatile double curtime = MPI_Wtime();
     assert(tag != internal_tag);
     initiate(_MPI_Send__id,curtime, count, datatype, comm, true, dest);
-    PMPI_Send(buf, count, datatype, dest, tag, comm);
+    if (piggyback_p2p){
+      MPI_Datatype wrapped = piggyback(_MPI_Send__id, buf, count, datatype, true);
+      PMPI_Send(MPI_BOTTOM, 1, wrapped, dest, tag, comm);
+      unwrap(&wrapped, datatype);
+    }
+    else{
+      PMPI_Send(buf, count, datatype, dest, tag, comm);
+    }
     complete(_MPI_Send__id);
   }
   else{
@@ -463,7 +556,14 @@ void recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_
     volatile double curtime = MPI_Wtime();
     assert(tag != internal_tag);
     initiate(_MPI_Recv__id,curtime, count, datatype, comm, false, source);
-    PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+    if (piggyback_p2p){
+      MPI_Datatype wrapped = piggyback(_MPI_Recv__id, buf, count, datatype, false);
+      PMPI_Recv(MPI_BOTTOM, 1, wrapped, source, tag, comm, status);
+      unwrap(&wrapped, datatype, status);
+    }
+    else{
+      PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+    }
     complete(_MPI_Recv__id,(source==MPI_ANY_SOURCE ? status->MPI_SOURCE : -1));
   }
   else{
@@ -475,8 +575,11 @@ void isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag,
   if (mode && track_p2p){
     volatile double curtime = MPI_Wtime();
     assert(tag != internal_tag);
+    // The datatype wrapping the user buffer is freed once the request completes
+    MPI_Datatype wrapped = piggyback_p2p ? piggyback(_MPI_Isend__id, curtime, buf, count, datatype, true) : datatype;
     volatile double itime = MPI_Wtime();
-    PMPI_Isend(buf, count, datatype, dest, tag, comm, request);
+    if (piggyback_p2p) { PMPI_Isend(MPI_BOTTOM, 1, wrapped, dest, tag, comm, request); }
+    else               { PMPI_Isend(buf, count, datatype, dest, tag, comm, request); }
     itime = MPI_Wtime()-itime;
     initiate(_MPI_Isend__id,curtime, itime, count, datatype, comm, request, true, dest);
   }
@@ -489,8 +592,11 @@ void irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI
   if (mode && track_p2p){
     volatile double curtime = MPI_Wtime();
     assert(tag != internal_tag);
+    // The datatype wrapping the user buffer is freed once the request completes
+    MPI_Datatype wrapped = piggyback_p2p ? piggyback(_MPI_Irecv__id, curtime, buf, count, datatype, false) : datatype;
     volatile double itime = MPI_Wtime();
-    PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+    if (piggyback_p2p) { PMPI_Irecv(MPI_BOTTOM, 1, wrapped, source, tag, comm, request); }
+    else               { PMPI_Irecv(buf, count, datatype, source, tag, comm, request); }
     itime = MPI_Wtime()-itime;
     initiate(_MPI_Irecv__id,curtime, itime, count, datatype, comm, request, false, source);
   }
@@ -505,7 +611,7 @@ void ibcast(void* buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm
     volatile double itime = MPI_Wtime();
     PMPI_Ibcast(buf, count, datatype, root, comm, request);
     itime = MPI_Wtime()-itime;
-    initiate(_MPI_Ibcast__id,curtime, itime, count, datatype, comm, request);
+    initiate(_MPI_Ibcast__id,curtime, itime, count, datatype, comm, request, false, -1, root);
   }
   else{
     PMPI_Ibcast(buf, count, datatype, root, comm, request);
@@ -532,7 +638,7 @@ void ireduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatyp
     volatile double itime = MPI_Wtime();
     PMPI_Ireduce(sendbuf, recvbuf, count, datatype, op, root, comm, request);
     itime = MPI_Wtime()-itime;
-    initiate(_MPI_Iallreduce__id,curtime, itime, count, datatype, comm, request);
+    initiate(_MPI_Ireduce__id,curtime, itime, count, datatype, comm, request, false, -1, root);
   }
   else{
     PMPI_Ireduce(sendbuf, recvbuf, count, datatype, op, root, comm, request);
@@ -543,12 +649,12 @@ void igather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* re
              int root, MPI_Comm comm, MPI_Request* request){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     int64_t recvbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
     volatile double itime = MPI_Wtime();
     PMPI_Igather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm, request);
     itime = MPI_Wtime()-itime;
-    initiate(_MPI_Igather__id, curtime, itime, recvbuf_size, sendtype, comm, request);
+    initiate(_MPI_Igather__id, curtime, itime, recvbuf_size, sendtype, comm, request, false, -1, root);
   }
   else{
     PMPI_Igather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm, request);
@@ -559,12 +665,12 @@ void igatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *r
               MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request *request){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int64_t tot_recv=0; int comm_rank,comm_size; MPI_Comm_rank(comm, &comm_rank); MPI_Comm_size(comm, &comm_size);
+    int64_t tot_recv=0; comm_metadata& comm_info = get_comm_metadata(comm); int comm_rank = comm_info.rank; int comm_size = comm_info.size;
     if (comm_rank == root) for (int i=0; i<comm_size; i++){ tot_recv += ((int*)recvcounts)[i]; }
     volatile double itime = MPI_Wtime();
     PMPI_Igatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm, request);
     itime = MPI_Wtime()-itime;
-    initiate(_MPI_Igatherv__id, curtime, itime, std::max((int64_t)sendcount,tot_recv), sendtype, comm, request);
+    initiate(_MPI_Igatherv__id, curtime, itime, std::max((int64_t)sendcount,tot_recv), sendtype, comm, request, false, -1, root);
   }
   else{
      PMPI_Igatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm, request);
@@ -575,7 +681,7 @@ void iallgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void*
                 MPI_Comm comm, MPI_Request* request){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size); int64_t recvbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
+    int comm_size = get_comm_metadata(comm).size; int64_t recvbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
     volatile double itime = MPI_Wtime();
     PMPI_Iallgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm, request);
     itime = MPI_Wtime()-itime;
@@ -590,7 +696,7 @@ void iallgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void
                  MPI_Datatype recvtype, MPI_Comm comm, MPI_Request* request){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int64_t tot_recv=0; int comm_size; MPI_Comm_size(comm, &comm_size);
+    int64_t tot_recv=0; int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_recv += recvcounts[i]; }
     volatile double itime = MPI_Wtime();
     PMPI_Iallgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm, request);
@@ -606,12 +712,12 @@ void iscatter(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* r
               MPI_Comm comm, MPI_Request* request){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     int64_t sendbuf_size = std::max((int64_t)sendcount,(int64_t)recvcount) * comm_size;
     volatile double itime = MPI_Wtime();
     PMPI_Iscatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm, request);
     itime = MPI_Wtime()-itime;
-    initiate(_MPI_Iscatter__id,curtime, itime, sendbuf_size, sendtype, comm, request);
+    initiate(_MPI_Iscatter__id,curtime, itime, sendbuf_size, sendtype, comm, request, false, -1, root);
   }
   else{
     PMPI_Iscatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm, request);
@@ -623,12 +729,12 @@ void iscatterv(const void* sendbuf, const int sendcounts[], const int displs[],
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
     int64_t tot_send=0;
-    int comm_rank, comm_size; MPI_Comm_rank(comm, &comm_rank); MPI_Comm_size(comm, &comm_size);
+    comm_metadata& comm_info = get_comm_metadata(comm); int comm_rank = comm_info.rank; int comm_size = comm_info.size;
     if (comm_rank == root) for (int i=0; i<comm_size; i++){ tot_send += ((int*)sendcounts)[i]; } 
     volatile double itime = MPI_Wtime();
     PMPI_Iscatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm, request);
     itime = MPI_Wtime()-itime;
-    initiate(_MPI_Iscatterv__id, curtime, itime, std::max(tot_send,(int64_t)recvcount), sendtype, comm, request);
+    initiate(_MPI_Iscatterv__id, curtime, itime, std::max(tot_send,(int64_t)recvcount), sendtype, comm, request, false, -1, root);
   }
   else{
     PMPI_Iscatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm, request);
@@ -640,7 +746,7 @@ void ireduce_scatter(const void* sendbuf, void* recvbuf, const int recvcounts[],
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
     int64_t tot_recv=0;
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_recv += recvcounts[i]; }
     volatile double itime = MPI_Wtime();
     PMPI_Ireduce_scatter(sendbuf, recvbuf, recvcounts, datatype, op, comm, request);
@@ -656,7 +762,7 @@ void ialltoall(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void*
                MPI_Comm comm, MPI_Request* request){
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     volatile double itime = MPI_Wtime();
     PMPI_Ialltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm, request);
     itime = MPI_Wtime()-itime;
@@ -672,7 +778,7 @@ void ialltoallv(const void* sendbuf, const int sendcounts[], const int sdispls[]
   if (mode && track_collective){
     volatile double curtime = MPI_Wtime();
     int64_t tot_send=0, tot_recv=0;
-    int comm_size; MPI_Comm_size(comm, &comm_size);
+    int comm_size = get_comm_metadata(comm).size;
     for (int i=0; i<comm_size; i++){ tot_send += sendcounts[i]; tot_recv += recvcounts[i]; }
     volatile double itime = MPI_Wtime();
     PMPI_Ialltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf, recvcounts, rdispls, recvtype, comm, request);
@@ -726,6 +832,7 @@ void waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_sta
 
 void finalize(){
   if (auto_capture) stop();
+  deallocate();
   if (is_world_root){
     if (flag == 1){
       stream.close();
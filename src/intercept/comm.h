@@ -3,6 +3,11 @@
 
 #include "mpi.h"
 
+// See src/util/util.h
+#ifndef CRITTER_RANK_LOCAL
+#define CRITTER_RANK_LOCAL
+#endif
+
 namespace critter{
 
 void start();
@@ -36,6 +41,7 @@ void sendrecv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, int des
 void sendrecv_replace(void* buf, int count, MPI_Datatype datatype, int dest, int sendtag, int source, int recvtag,
                       MPI_Comm comm, MPI_Status* status);
 void ssend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm);
+void bsend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm);
 void send(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm);
 void recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status* status);
 void isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request);
@@ -1,21 +1,27 @@
 #include "symbol.h"
 #include "../util/util.h"
+#include "../util/symbol_registry.h"
 #include "../dispatch/dispatch.h"
 
 namespace critter{
 namespace internal{
 
-void symbol_start(const char* symbol){
+// Invoked once per call site, whose id is then cached in a function-local static
+int symbol_id(const char* symbol){
+  return register_symbol(symbol);
+}
+
+void symbol_start(int id){
   if (mode && symbol_path_select_size>0){
     volatile double save_time = MPI_Wtime();
-    open_symbol(symbol,save_time);
+    open_symbol(id,save_time);
   }
 }
 
-void symbol_stop(const char* symbol){
+void symbol_stop(int id){
   if (mode && symbol_path_select_size>0){
     volatile double save_time = MPI_Wtime();
-    close_symbol(symbol,save_time);
+    close_symbol(id,save_time);
   }
 }
 
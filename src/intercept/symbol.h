@@ -4,8 +4,9 @@
 namespace critter{
 namespace internal{
 
-void symbol_start(const char* symbol);
-void symbol_stop(const char* symbol);
+int symbol_id(const char* symbol);
+void symbol_start(int id);
+void symbol_stop(int id);
 
 };
 };
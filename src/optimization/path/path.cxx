@@ -23,8 +23,8 @@ void replay(){
     gradient_scale[i] = .01*(gradient_jump_size*i);
   }
   // Fill in scale_map
-  for (auto i=0; i<symbol_order.size(); i++){
-    scale_map[symbol_order[i]] = std::make_pair(i,1.);
+  for (auto i=0; i<n; i++){
+    scale_map[critter::internal::decomposition::symbol_timers[i].name] = std::make_pair(i,1.);
   }
   // Simulation loop
   for (auto i=0; i<opt_max_iter; i++){
@@ -153,7 +153,7 @@ void replay(){
         }
       }
       if (rank==0){
-        std::cout << "Symbol " << symbol_order[j] << " used " << gradient_save_index[j] << " jumps to improve runtime from " << table[j*m] << " to " << gradient_save_val[j] << std::endl;
+        std::cout << "Symbol " << critter::internal::decomposition::symbol_timers[j].name << " used " << gradient_save_index[j] << " jumps to improve runtime from " << table[j*m] << " to " << gradient_save_val[j] << std::endl;
       }
     }
     if (rank==0) std::cout << "\n";
@@ -169,11 +169,11 @@ void replay(){
       }
     }
     // Update scale_map
-    scale_map[symbol_order[opt_kernel]].second *= (1.-gradient_scale[opt_index]);
+    scale_map[critter::internal::decomposition::symbol_timers[opt_kernel].name].second *= (1.-gradient_scale[opt_index]);
   }
   if (rank==0){
     for (auto j=0; j<n; j++){
-      std::cout << "Optimization intensity distribution to kernel " << symbol_order[j] << " is " << scale_map[symbol_order[j]].second << std::endl << std::endl;
+      std::cout << "Optimization intensity distribution to kernel " << critter::internal::decomposition::symbol_timers[j].name << " is " << scale_map[critter::internal::decomposition::symbol_timers[j].name].second << std::endl << std::endl;
     }
   }
   // reset the data structures
@@ -0,0 +1,78 @@
+#include "metadata.h"
+
+namespace critter{
+namespace internal{
+
+static CRITTER_RANK_LOCAL int comm_metadata_keyval = MPI_KEYVAL_INVALID;
+static CRITTER_RANK_LOCAL int type_size_keyval = MPI_KEYVAL_INVALID;
+// Indexed by rank in MPI_COMM_WORLD, stores the smallest world rank residing on the same node
+static CRITTER_RANK_LOCAL std::vector<int> world_node_id;
+
+static int delete_comm_metadata(MPI_Comm comm, int keyval, void* attribute_val, void* extra_state){
+  delete (comm_metadata*)attribute_val;
+  return MPI_SUCCESS;
+}
+
+bool comm_metadata::is_node_local(int partner) const{
+  return world_node_id[this->world_ranks[partner]] == world_node_id[this->world_ranks[this->rank]];
+}
+
+void init_metadata(){
+  // The attributes cached on a communicator are freed by the delete callback when the communicator is freed.
+  //   Datatype sizes are stored directly in the attribute value, so no callbacks are needed.
+  MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,delete_comm_metadata,&comm_metadata_keyval,nullptr);
+  MPI_Type_create_keyval(MPI_TYPE_NULL_COPY_FN,MPI_TYPE_NULL_DELETE_FN,&type_size_keyval,nullptr);
+
+  int world_rank,world_size;
+  MPI_Comm_rank(MPI_COMM_WORLD,&world_rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&world_size);
+  MPI_Comm node_comm;
+  PMPI_Comm_split_type(MPI_COMM_WORLD,MPI_COMM_TYPE_SHARED,world_rank,MPI_INFO_NULL,&node_comm);
+  int node_id = world_rank;
+  PMPI_Allreduce(MPI_IN_PLACE,&node_id,1,MPI_INT,MPI_MIN,node_comm);
+  world_node_id.resize(world_size);
+  PMPI_Allgather(&node_id,1,MPI_INT,&world_node_id[0],1,MPI_INT,MPI_COMM_WORLD);
+  PMPI_Comm_free(&node_comm);
+}
+
+comm_metadata& get_comm_metadata(MPI_Comm comm){
+  comm_metadata* metadata; int flag;
+  MPI_Comm_get_attr(comm,comm_metadata_keyval,&metadata,&flag);
+  if (flag) return *metadata;
+
+  // First use of 'comm': all queries below are local, so this is safe to do from within any (non-collective) routine
+  metadata = new comm_metadata();
+  MPI_Comm_rank(comm,&metadata->rank);
+  MPI_Comm_size(comm,&metadata->size);
+  std::vector<int> comm_ranks(metadata->size);
+  for (int i=0; i<metadata->size; i++){ comm_ranks[i]=i; }
+  metadata->world_ranks.resize(metadata->size);
+  MPI_Group comm_group,world_group;
+  MPI_Comm_group(comm,&comm_group);
+  MPI_Comm_group(MPI_COMM_WORLD,&world_group);
+  MPI_Group_translate_ranks(comm_group,metadata->size,&comm_ranks[0],world_group,&metadata->world_ranks[0]);
+  MPI_Group_free(&comm_group);
+  MPI_Group_free(&world_group);
+  metadata->unit_counts.resize(metadata->size,1);
+  metadata->unit_displs = comm_ranks;
+  int world_comparison;
+  MPI_Comm_compare(comm,MPI_COMM_WORLD,&world_comparison);
+  metadata->spans_world = (world_comparison == MPI_IDENT) || (world_comparison == MPI_CONGRUENT) || (world_comparison == MPI_SIMILAR);
+  metadata->symbol_names_sent.resize(metadata->size,0);
+  metadata->symbol_names_broadcast = 0;
+  metadata->collective_count = 0;
+  MPI_Comm_set_attr(comm,comm_metadata_keyval,metadata);
+  return *metadata;
+}
+
+int get_type_size(MPI_Datatype t){
+  void* attribute_val; int flag;
+  MPI_Type_get_attr(t,type_size_keyval,&attribute_val,&flag);
+  if (flag) return (int)(intptr_t)attribute_val;
+  int type_size; MPI_Type_size(t,&type_size);
+  MPI_Type_set_attr(t,type_size_keyval,(void*)(intptr_t)type_size);
+  return type_size;
+}
+
+}
+}
@@ -0,0 +1,42 @@
+#ifndef CRITTER__UTIL__METADATA_H_
+#define CRITTER__UTIL__METADATA_H_
+
+#include "util.h"
+
+namespace critter{
+namespace internal{
+
+/* \brief communicator attributes queried once and cached on the communicator via an MPI attribute keyval */
+struct comm_metadata{
+  /* \brief rank of this process in the communicator */
+  int rank;
+  /* \brief process count of the communicator */
+  int size;
+  /* \brief true if the communicator holds the same processes as MPI_COMM_WORLD */
+  bool spans_world;
+  /* \brief rank in MPI_COMM_WORLD of each process in the communicator */
+  std::vector<int> world_ranks;
+  /* \brief counts (all one) and displacements (0 to size-1) of a single element per process, as passed to the -v collectives and MPI_Reduce_scatter */
+  std::vector<int> unit_counts;
+  std::vector<int> unit_displs;
+  /* \brief number of registered symbol names (a prefix of the symbol registry) already delivered to each process in the communicator via point-to-point propagation */
+  std::vector<int> symbol_names_sent;
+  /* \brief number of registered symbol names already delivered to all processes in the communicator via a collective propagation rooted at this process */
+  int symbol_names_broadcast;
+  /* \brief number of collectives over the communicator that propagate path data or, with CRITTER_SAMPLE_RATE>1, that could have */
+  size_t collective_count;
+  /* \brief true if the process with rank 'partner' in the communicator shares a node with this process */
+  bool is_node_local(int partner) const;
+};
+
+/** \brief create the keyvals and the world node map; collective over MPI_COMM_WORLD */
+void init_metadata();
+/** \brief cached attributes of 'comm', computed on first use without communication */
+comm_metadata& get_comm_metadata(MPI_Comm comm);
+/** \brief cached size in bytes of datatype 't' */
+int get_type_size(MPI_Datatype t);
+
+}
+}
+
+#endif /*CRITTER__UTIL__METADATA_H_*/
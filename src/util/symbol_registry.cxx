@@ -0,0 +1,87 @@
+#include "symbol_registry.h"
+
+namespace critter{
+namespace internal{
+
+// Names are only hashed when a call site registers its symbol for the first time, or when a symbol name is received from another process.
+static CRITTER_RANK_LOCAL std::vector<std::string> symbol_names;
+static CRITTER_RANK_LOCAL std::unordered_map<std::string,int> symbol_ids;
+// Global ids are 64-bit FNV-1a hashes of the names, so that processes agree on them without communication
+static CRITTER_RANK_LOCAL std::vector<uint64_t> symbol_global_ids;
+static CRITTER_RANK_LOCAL std::unordered_map<uint64_t,int> global_symbol_ids;
+// Prefix sums of the name lengths, so that name deltas are sized in constant time
+static CRITTER_RANK_LOCAL std::vector<size_t> symbol_name_offsets(1,0);
+
+static uint64_t hash_symbol_name(std::string const& symbol){
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto c : symbol){
+    hash ^= (unsigned char)c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+int register_symbol(std::string const& symbol){
+  auto it = symbol_ids.find(symbol);
+  if (it != symbol_ids.end()) return it->second;
+  int id = symbol_names.size();
+  uint64_t global_id = hash_symbol_name(symbol);
+  // Two names sharing a global id would silently merge their measurements on receivers
+  assert(global_symbol_ids.find(global_id) == global_symbol_ids.end());
+  symbol_names.push_back(symbol);
+  symbol_ids[symbol] = id;
+  symbol_global_ids.push_back(global_id);
+  global_symbol_ids[global_id] = id;
+  symbol_name_offsets.push_back(symbol_name_offsets.back()+symbol.size());
+  max_timer_name_length = std::max(max_timer_name_length,symbol.size());
+  return id;
+}
+
+int register_symbol(const char* symbol){
+  return register_symbol(std::string(symbol));
+}
+
+std::string const& get_symbol_name(int id){
+  assert(id>=0 && id<symbol_names.size());
+  return symbol_names[id];
+}
+
+size_t get_symbol_count(){
+  return symbol_names.size();
+}
+
+uint64_t get_symbol_global_id(int id){
+  assert(id>=0 && id<symbol_global_ids.size());
+  return symbol_global_ids[id];
+}
+
+int find_symbol(uint64_t global_id){
+  auto it = global_symbol_ids.find(global_id);
+  assert(it != global_symbol_ids.end());
+  return it->second;
+}
+
+size_t get_symbol_name_chars(size_t first){
+  assert(first<=symbol_names.size());
+  return symbol_name_offsets.back() - symbol_name_offsets[first];
+}
+
+void pack_symbol_names(size_t first, int* lengths, char* chars){
+  size_t offset = 0;
+  for (size_t i=first; i<symbol_names.size(); i++){
+    lengths[i-first] = symbol_names[i].size();
+    std::memcpy(chars+offset,symbol_names[i].data(),symbol_names[i].size());
+    offset += symbol_names[i].size();
+  }
+}
+
+void unpack_symbol_names(size_t count, int const* lengths, char const* chars){
+  size_t offset = 0;
+  for (size_t i=0; i<count; i++){
+    register_symbol(std::string(chars+offset,lengths[i]));
+    offset += lengths[i];
+  }
+}
+
+}
+}
@@ -0,0 +1,31 @@
+#ifndef CRITTER__UTIL__SYMBOL_REGISTRY_H_
+#define CRITTER__UTIL__SYMBOL_REGISTRY_H_
+
+#include "util.h"
+
+namespace critter{
+namespace internal{
+
+/** \brief dense id of the symbol named 'symbol', assigned on first use and stable for the lifetime of the process */
+int register_symbol(const char* symbol);
+/** \brief dense id of the symbol named 'symbol', assigned on first use and stable for the lifetime of the process */
+int register_symbol(std::string const& symbol);
+/** \brief name of the symbol with id 'id' */
+std::string const& get_symbol_name(int id);
+/** \brief number of symbols registered so far */
+size_t get_symbol_count();
+/** \brief id of the symbol with id 'id' that is shared by all processes, as it is derived from the symbol's name alone */
+uint64_t get_symbol_global_id(int id);
+/** \brief id of the symbol with global id 'global_id'; its name must have been registered on this process already */
+int find_symbol(uint64_t global_id);
+/** \brief total length of the names of the symbols with ids in ['first',get_symbol_count()) */
+size_t get_symbol_name_chars(size_t first);
+/** \brief write the lengths and the concatenated characters of the names of the symbols with ids in ['first',get_symbol_count()) */
+void pack_symbol_names(size_t first, int* lengths, char* chars);
+/** \brief register the 'count' names whose lengths and concatenated characters were written by 'pack_symbol_names' on another process */
+void unpack_symbol_names(size_t count, int const* lengths, char const* chars);
+
+}
+}
+
+#endif /*CRITTER__UTIL__SYMBOL_REGISTRY_H_*/
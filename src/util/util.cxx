@@ -3,95 +3,96 @@
 namespace critter{
 namespace internal{
 
-size_t cp_symbol_class_count;
-size_t pp_symbol_class_count;
-size_t vol_symbol_class_count;
-size_t mode_1_width;
-size_t mode_2_width;
-size_t max_num_symbols;
-size_t max_timer_name_length;
-std::string _cost_models_,_symbol_path_select_,_comm_path_select_;
-size_t cost_model_size;
-size_t symbol_path_select_size;
-size_t comm_path_select_size;
-size_t auto_capture;
-std::vector<char> cost_models;
-std::vector<char> symbol_path_select;
-std::vector<char> comm_path_select;
-size_t num_critical_path_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime, CompTime, RunTime
-size_t num_per_process_measures;		// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
-size_t num_volume_measures;			// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
-size_t num_tracker_critical_path_measures;	// CommCost*, SynchCost*,           CommTime, SynchTime
-size_t num_tracker_per_process_measures;	// CommCost*, SynchCost*,           CommTime, SynchTime
-size_t num_tracker_volume_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime
-size_t critical_path_costs_size;
-size_t per_process_costs_size;
-size_t volume_costs_size;
-std::string stream_name,file_name;
-bool flag,is_first_iter,is_world_root,need_new_line,opt;
-size_t mechanism,mode,stack_id;
-std::ofstream stream;
-volatile double computation_timer;
-std::map<MPI_Request,std::pair<bool,int>> internal_comm_info;
-std::map<MPI_Request,std::pair<MPI_Comm,int>> internal_comm_comm;
-std::map<MPI_Request,std::pair<double,double>> internal_comm_data;
-std::vector<std::pair<double*,int>> internal_comm_prop;
-std::vector<MPI_Request> internal_comm_prop_req;
-std::vector<int*> internal_timer_prop_int;
-std::vector<double*> internal_timer_prop_double;
-std::vector<double_int*> internal_timer_prop_double_int;
-std::vector<char*> internal_timer_prop_char;
-std::vector<MPI_Request> internal_timer_prop_req;
-std::vector<bool> decisions;
-std::vector<double> critical_path_costs;
-std::vector<double> max_per_process_costs;
-std::vector<double> volume_costs;
-std::map<std::string,std::vector<double>> save_info;
-std::vector<double> new_cs;
-double scratch_pad;
-std::vector<char> synch_pad_send;
-std::vector<char> synch_pad_recv;
-std::vector<char> barrier_pad_send;
-std::vector<char> barrier_pad_recv;
-std::vector<char> symbol_pad_cp;
-std::vector<char> symbol_pad_ncp1;
-std::vector<char> symbol_pad_ncp2;
-std::vector<int> symbol_len_pad_cp;
-std::vector<int> symbol_len_pad_ncp1;
-std::vector<int> symbol_len_pad_ncp2;
-std::vector<double> symbol_timer_pad_local_cp;
-std::vector<double> symbol_timer_pad_global_cp;
-std::vector<double> symbol_timer_pad_global_cp2;
-std::vector<double> symbol_timer_pad_local_pp;
-std::vector<double> symbol_timer_pad_global_pp;
-std::vector<double> symbol_timer_pad_local_vol;
-std::vector<double> symbol_timer_pad_global_vol;
-std::stack<std::string> symbol_stack;
-std::vector<std::string> symbol_order;
-std::vector<double_int> info_sender;
-std::vector<double_int> info_receiver;
-std::vector<int> symbol_path_select_index;
-bool wait_id;
-int internal_tag;
-int internal_tag1;
-int internal_tag2;
-int internal_tag3;
-int internal_tag4;
-int internal_tag5;
-size_t track_collective;
-size_t track_p2p;
-size_t track_p2p_idle;
-size_t eager_p2p;
-size_t delete_comm;
-std::vector<char> eager_pad;
-std::vector<event> event_list;
-std::vector<int> opt_req_match;
-std::vector<double> opt_measure_match;
-size_t event_list_size;
-size_t opt_max_iter;
-size_t gradient_jump_size;
-size_t num_gradient_points;
-size_t
+CRITTER_RANK_LOCAL size_t cp_symbol_class_count;
+CRITTER_RANK_LOCAL size_t pp_symbol_class_count;
+CRITTER_RANK_LOCAL size_t vol_symbol_class_count;
+CRITTER_RANK_LOCAL size_t mode_1_width;
+CRITTER_RANK_LOCAL size_t mode_2_width;
+CRITTER_RANK_LOCAL size_t max_symbol_depth;
+CRITTER_RANK_LOCAL size_t max_timer_name_length;
+CRITTER_RANK_LOCAL std::string _cost_models_,_symbol_path_select_,_comm_path_select_;
+CRITTER_RANK_LOCAL size_t cost_model_size;
+CRITTER_RANK_LOCAL size_t symbol_path_select_size;
+CRITTER_RANK_LOCAL size_t comm_path_select_size;
+CRITTER_RANK_LOCAL size_t auto_capture;
+CRITTER_RANK_LOCAL std::vector<char> cost_models;
+CRITTER_RANK_LOCAL std::vector<char> symbol_path_select;
+CRITTER_RANK_LOCAL std::vector<char> comm_path_select;
+CRITTER_RANK_LOCAL size_t num_critical_path_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime, CompTime, RunTime
+CRITTER_RANK_LOCAL size_t num_per_process_measures;		// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
+CRITTER_RANK_LOCAL size_t num_volume_measures;			// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
+CRITTER_RANK_LOCAL size_t num_tracker_critical_path_measures;	// CommCost*, SynchCost*,           CommTime, SynchTime
+CRITTER_RANK_LOCAL size_t num_tracker_per_process_measures;	// CommCost*, SynchCost*,           CommTime, SynchTime
+CRITTER_RANK_LOCAL size_t num_tracker_volume_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime
+CRITTER_RANK_LOCAL size_t critical_path_costs_size;
+CRITTER_RANK_LOCAL size_t per_process_costs_size;
+CRITTER_RANK_LOCAL size_t volume_costs_size;
+CRITTER_RANK_LOCAL std::string stream_name,file_name;
+CRITTER_RANK_LOCAL bool flag,is_first_iter,is_world_root,need_new_line,opt;
+CRITTER_RANK_LOCAL size_t mechanism,mode,stack_id;
+CRITTER_RANK_LOCAL std::ofstream stream;
+CRITTER_RANK_LOCAL volatile double computation_timer;
+CRITTER_RANK_LOCAL std::vector<std::pair<double*,int>> internal_comm_prop;
+CRITTER_RANK_LOCAL std::vector<MPI_Request> internal_comm_prop_req;
+CRITTER_RANK_LOCAL std::vector<double_int*> internal_timer_prop_double_int;
+CRITTER_RANK_LOCAL std::vector<MPI_Request> internal_timer_prop_req;
+CRITTER_RANK_LOCAL std::vector<symbol_envelope> internal_timer_prop_recv;
+CRITTER_RANK_LOCAL std::vector<bool> decisions;
+CRITTER_RANK_LOCAL std::vector<double> critical_path_costs;
+CRITTER_RANK_LOCAL double* critical_path_breakdown;
+CRITTER_RANK_LOCAL size_t critical_path_breakdown_size;
+CRITTER_RANK_LOCAL std::vector<double> max_per_process_costs;
+CRITTER_RANK_LOCAL std::vector<double> volume_costs;
+CRITTER_RANK_LOCAL std::map<std::string,std::vector<double>> save_info;
+CRITTER_RANK_LOCAL std::vector<double> new_cs;
+CRITTER_RANK_LOCAL double scratch_pad;
+CRITTER_RANK_LOCAL std::vector<char> synch_pad_send;
+CRITTER_RANK_LOCAL std::vector<char> synch_pad_recv;
+CRITTER_RANK_LOCAL std::vector<char> symbol_pad_cp;
+CRITTER_RANK_LOCAL std::vector<int> symbol_len_pad_cp;
+CRITTER_RANK_LOCAL std::vector<uint64_t> symbol_id_pad_cp;
+CRITTER_RANK_LOCAL std::vector<char> symbol_msg_pad_cp;
+CRITTER_RANK_LOCAL std::vector<char> symbol_msg_pad_ncp1;
+CRITTER_RANK_LOCAL std::vector<char> symbol_msg_pad_ncp2;
+CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_local_cp;
+CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_global_cp;
+CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_local_pp;
+CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_global_pp;
+CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_local_vol;
+CRITTER_RANK_LOCAL fixed_stack<symbol_frame> symbol_stack;
+CRITTER_RANK_LOCAL std::vector<double_int> info_sender;
+CRITTER_RANK_LOCAL std::vector<double_int> info_receiver;
+CRITTER_RANK_LOCAL std::vector<int> symbol_path_select_index;
+CRITTER_RANK_LOCAL bool wait_id;
+CRITTER_RANK_LOCAL int internal_tag;
+CRITTER_RANK_LOCAL int internal_tag1;
+CRITTER_RANK_LOCAL int internal_tag2;
+CRITTER_RANK_LOCAL int internal_tag3;
+CRITTER_RANK_LOCAL int internal_tag4;
+CRITTER_RANK_LOCAL int internal_tag5;
+CRITTER_RANK_LOCAL size_t track_collective;
+CRITTER_RANK_LOCAL size_t track_p2p;
+CRITTER_RANK_LOCAL size_t track_p2p_idle;
+CRITTER_RANK_LOCAL size_t eager_p2p;
+CRITTER_RANK_LOCAL size_t path_encoding;
+CRITTER_RANK_LOCAL size_t causal_p2p;
+CRITTER_RANK_LOCAL size_t piggyback_p2p;
+CRITTER_RANK_LOCAL size_t batch_waitall;
+CRITTER_RANK_LOCAL size_t node_aware;
+CRITTER_RANK_LOCAL size_t node_aware_min_bytes;
+CRITTER_RANK_LOCAL size_t sample_rate;
+CRITTER_RANK_LOCAL double max_overhead;
+CRITTER_RANK_LOCAL size_t self_overhead;
+CRITTER_RANK_LOCAL size_t delete_comm;
+CRITTER_RANK_LOCAL std::vector<char> eager_pad;
+CRITTER_RANK_LOCAL std::vector<event> event_list;
+CRITTER_RANK_LOCAL std::vector<int> opt_req_match;
+CRITTER_RANK_LOCAL std::vector<double> opt_measure_match;
+CRITTER_RANK_LOCAL size_t event_list_size;
+CRITTER_RANK_LOCAL size_t opt_max_iter;
+CRITTER_RANK_LOCAL size_t gradient_jump_size;
+CRITTER_RANK_LOCAL size_t num_gradient_points;
+CRITTER_RANK_LOCAL size_t
          _MPI_Send__id,
          _MPI_Ssend__id,
          _MPI_Bsend__id,
@@ -3,6 +3,7 @@
 
 #include <mpi.h>
 #include <cstring>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -17,6 +18,13 @@
 #include <unordered_map>
 #include <cmath>
 #include <assert.h>
+#include <array>
+#include <limits>
+
+// Qualifies each variable holding the state of a process. Backends that run each process as a thread (see test/mock/mpi.h) define it as thread_local.
+#ifndef CRITTER_RANK_LOCAL
+#define CRITTER_RANK_LOCAL
+#endif
 
 namespace critter{
 namespace internal{
@@ -60,95 +68,142 @@ struct event{
   std::string kernel;
 };
 
-extern size_t cp_symbol_class_count;
-extern size_t pp_symbol_class_count;
-extern size_t vol_symbol_class_count;
-extern size_t mode_1_width;
-extern size_t mode_2_width;
-extern size_t max_num_symbols;
-extern size_t max_timer_name_length;
-extern std::string _cost_models_,_symbol_path_select_,_comm_path_select_;
-extern size_t cost_model_size;
-extern size_t symbol_path_select_size;
-extern size_t comm_path_select_size;
-extern size_t auto_capture;
-extern std::vector<char> cost_models;
-extern std::vector<char> symbol_path_select;
-extern std::vector<char> comm_path_select;
-extern size_t num_critical_path_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime, CompTime, RunTime
-extern size_t num_per_process_measures;			// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
-extern size_t num_volume_measures;			// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
-extern size_t num_tracker_critical_path_measures;	// CommCost*, SynchCost*,           CommTime, SynchTime
-extern size_t num_tracker_per_process_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime
-extern size_t num_tracker_volume_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime
-extern size_t critical_path_costs_size;
-extern size_t per_process_costs_size;
-extern size_t volume_costs_size;
-extern std::string stream_name,file_name;
-extern bool flag,is_first_iter,is_world_root,need_new_line,opt;
-extern size_t mechanism,mode,stack_id;
-extern std::ofstream stream;
-extern volatile double computation_timer;
-extern std::map<MPI_Request,std::pair<bool,int>> internal_comm_info;
-extern std::map<MPI_Request,std::pair<MPI_Comm,int>> internal_comm_comm;
-extern std::map<MPI_Request,std::pair<double,double>> internal_comm_data;
-extern std::vector<std::pair<double*,int>> internal_comm_prop;
-extern std::vector<MPI_Request> internal_comm_prop_req;
-extern std::vector<int*> internal_timer_prop_int;
-extern std::vector<double*> internal_timer_prop_double;
-extern std::vector<double_int*> internal_timer_prop_double_int;
-extern std::vector<char*> internal_timer_prop_char;
-extern std::vector<MPI_Request> internal_timer_prop_req;
-extern std::vector<bool> decisions;
-extern std::vector<double> critical_path_costs;
-extern std::vector<double> max_per_process_costs;
-extern std::vector<double> volume_costs;
-extern std::map<std::string,std::vector<double>> save_info;
-extern std::vector<double> new_cs;
-extern double scratch_pad;
-extern std::vector<char> synch_pad_send;
-extern std::vector<char> synch_pad_recv;
-extern std::vector<char> barrier_pad_send;
-extern std::vector<char> barrier_pad_recv;
-extern std::vector<char> symbol_pad_cp;
-extern std::vector<char> symbol_pad_ncp1;
-extern std::vector<char> symbol_pad_ncp2;
-extern std::vector<int> symbol_len_pad_cp;
-extern std::vector<int> symbol_len_pad_ncp1;
-extern std::vector<int> symbol_len_pad_ncp2;
-extern std::vector<double> symbol_timer_pad_local_cp;
-extern std::vector<double> symbol_timer_pad_global_cp;
-extern std::vector<double> symbol_timer_pad_global_cp2;
-extern std::vector<double> symbol_timer_pad_local_pp;
-extern std::vector<double> symbol_timer_pad_global_pp;
-extern std::vector<double> symbol_timer_pad_local_vol;
-extern std::vector<double> symbol_timer_pad_global_vol;
-extern std::stack<std::string> symbol_stack;
-extern std::vector<std::string> symbol_order;
-extern std::vector<double_int> info_sender;
-extern std::vector<double_int> info_receiver;
-extern std::vector<int> symbol_path_select_index;
-extern bool wait_id;
-extern int internal_tag;
-extern int internal_tag1;
-extern int internal_tag2;
-extern int internal_tag3;
-extern int internal_tag4;
-extern int internal_tag5;
-extern size_t track_collective;
-extern size_t track_p2p;
-extern size_t track_p2p_idle;
-extern size_t eager_p2p;
-extern size_t delete_comm;
-extern std::vector<char> eager_pad;
-extern std::vector<event> event_list;
-extern std::vector<int> opt_req_match;
-extern std::vector<double> opt_measure_match;
-extern size_t event_list_size;
-extern size_t opt_max_iter;
-extern size_t gradient_jump_size;
-extern size_t num_gradient_points;
-extern size_t
+/* \brief stack whose capacity is fixed at initialization, so that push and pop never allocate */
+template<typename T>
+class fixed_stack{
+  public:
+    fixed_stack(){ this->count=0; }
+    void init(size_t capacity){ this->data.resize(capacity); this->count=0; }
+    void push(T const& val){ assert(this->count < this->data.size()); this->data[this->count++] = val; }
+    void pop(){ assert(this->count > 0); this->count--; }
+    T& top(){ assert(this->count > 0); return this->data[this->count-1]; }
+    size_t size() const { return this->count; }
+
+  private:
+    std::vector<T> data;
+    size_t count;
+};
+
+/** \brief grow 'pad' geometrically so that it holds at least 'count' elements; existing elements are preserved */
+template<typename T>
+void reserve_pad(std::vector<T>& pad, size_t count){
+  if (pad.size() < count){ pad.resize(std::max(count,2*pad.size())); }
+}
+
+/* \brief entry of the symbol stack: index of an open symbol into 'symbol_timers' and the time at which its exclusive timer was last (re)started */
+struct symbol_frame{
+  int index;
+  double start_time;
+};
+
+/* \brief view into a received symbol message: the header (symbol count, count of names new to the receiver, their total length, count of measures),
+          the global id of each symbol, the measures, and the lengths and characters of the new names */
+struct symbol_message{
+  int* header;
+  uint64_t* ids;
+  double* data;
+  int* lengths;
+  char* chars;
+};
+
+/* \brief symbol message sent by the partner of a nonblocking propagation, received (into the envelope pool) once it is needed */
+struct symbol_envelope{
+  MPI_Comm comm;
+  int partner;
+  symbol_message message;
+  bool received;
+};
+
+extern CRITTER_RANK_LOCAL size_t cp_symbol_class_count;
+extern CRITTER_RANK_LOCAL size_t pp_symbol_class_count;
+extern CRITTER_RANK_LOCAL size_t vol_symbol_class_count;
+extern CRITTER_RANK_LOCAL size_t mode_1_width;
+extern CRITTER_RANK_LOCAL size_t mode_2_width;
+extern CRITTER_RANK_LOCAL size_t max_symbol_depth;
+extern CRITTER_RANK_LOCAL size_t max_timer_name_length;
+extern CRITTER_RANK_LOCAL std::string _cost_models_,_symbol_path_select_,_comm_path_select_;
+extern CRITTER_RANK_LOCAL size_t cost_model_size;
+extern CRITTER_RANK_LOCAL size_t symbol_path_select_size;
+extern CRITTER_RANK_LOCAL size_t comm_path_select_size;
+extern CRITTER_RANK_LOCAL size_t auto_capture;
+extern CRITTER_RANK_LOCAL std::vector<char> cost_models;
+extern CRITTER_RANK_LOCAL std::vector<char> symbol_path_select;
+extern CRITTER_RANK_LOCAL std::vector<char> comm_path_select;
+extern CRITTER_RANK_LOCAL size_t num_critical_path_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime, CompTime, RunTime
+extern CRITTER_RANK_LOCAL size_t num_per_process_measures;			// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
+extern CRITTER_RANK_LOCAL size_t num_volume_measures;			// CommCost*, SynchCost*, IdleTime, CommTime, SynchTime, CompTime, RunTime
+extern CRITTER_RANK_LOCAL size_t num_tracker_critical_path_measures;	// CommCost*, SynchCost*,           CommTime, SynchTime
+extern CRITTER_RANK_LOCAL size_t num_tracker_per_process_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime
+extern CRITTER_RANK_LOCAL size_t num_tracker_volume_measures;		// CommCost*, SynchCost*,           CommTime, SynchTime
+extern CRITTER_RANK_LOCAL size_t critical_path_costs_size;
+extern CRITTER_RANK_LOCAL size_t per_process_costs_size;
+extern CRITTER_RANK_LOCAL size_t volume_costs_size;
+extern CRITTER_RANK_LOCAL std::string stream_name,file_name;
+extern CRITTER_RANK_LOCAL bool flag,is_first_iter,is_world_root,need_new_line,opt;
+extern CRITTER_RANK_LOCAL size_t mechanism,mode,stack_id;
+extern CRITTER_RANK_LOCAL std::ofstream stream;
+extern CRITTER_RANK_LOCAL volatile double computation_timer;
+extern CRITTER_RANK_LOCAL std::vector<std::pair<double*,int>> internal_comm_prop;
+extern CRITTER_RANK_LOCAL std::vector<MPI_Request> internal_comm_prop_req;
+extern CRITTER_RANK_LOCAL std::vector<double_int*> internal_timer_prop_double_int;
+extern CRITTER_RANK_LOCAL std::vector<MPI_Request> internal_timer_prop_req;
+extern CRITTER_RANK_LOCAL std::vector<symbol_envelope> internal_timer_prop_recv;
+extern CRITTER_RANK_LOCAL std::vector<bool> decisions;
+extern CRITTER_RANK_LOCAL std::vector<double> critical_path_costs;
+extern CRITTER_RANK_LOCAL double* critical_path_breakdown;			// breakdown of the decomposed paths: the tail of 'critical_path_costs', or a local segment with CRITTER_MECHANISM=1
+extern CRITTER_RANK_LOCAL size_t critical_path_breakdown_size;
+extern CRITTER_RANK_LOCAL std::vector<double> max_per_process_costs;
+extern CRITTER_RANK_LOCAL std::vector<double> volume_costs;
+extern CRITTER_RANK_LOCAL std::map<std::string,std::vector<double>> save_info;
+extern CRITTER_RANK_LOCAL std::vector<double> new_cs;
+extern CRITTER_RANK_LOCAL double scratch_pad;
+extern CRITTER_RANK_LOCAL std::vector<char> synch_pad_send;
+extern CRITTER_RANK_LOCAL std::vector<char> synch_pad_recv;
+extern CRITTER_RANK_LOCAL std::vector<char> symbol_pad_cp;
+extern CRITTER_RANK_LOCAL std::vector<int> symbol_len_pad_cp;
+extern CRITTER_RANK_LOCAL std::vector<uint64_t> symbol_id_pad_cp;
+extern CRITTER_RANK_LOCAL std::vector<char> symbol_msg_pad_cp;
+extern CRITTER_RANK_LOCAL std::vector<char> symbol_msg_pad_ncp1;
+extern CRITTER_RANK_LOCAL std::vector<char> symbol_msg_pad_ncp2;
+extern CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_local_cp;
+extern CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_global_cp;
+extern CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_local_pp;
+extern CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_global_pp;
+extern CRITTER_RANK_LOCAL std::vector<double> symbol_timer_pad_local_vol;
+extern CRITTER_RANK_LOCAL fixed_stack<symbol_frame> symbol_stack;
+extern CRITTER_RANK_LOCAL std::vector<double_int> info_sender;
+extern CRITTER_RANK_LOCAL std::vector<double_int> info_receiver;
+extern CRITTER_RANK_LOCAL std::vector<int> symbol_path_select_index;
+extern CRITTER_RANK_LOCAL bool wait_id;
+extern CRITTER_RANK_LOCAL int internal_tag;
+extern CRITTER_RANK_LOCAL int internal_tag1;
+extern CRITTER_RANK_LOCAL int internal_tag2;
+extern CRITTER_RANK_LOCAL int internal_tag3;
+extern CRITTER_RANK_LOCAL int internal_tag4;
+extern CRITTER_RANK_LOCAL int internal_tag5;
+extern CRITTER_RANK_LOCAL size_t track_collective;
+extern CRITTER_RANK_LOCAL size_t track_p2p;
+extern CRITTER_RANK_LOCAL size_t track_p2p_idle;
+extern CRITTER_RANK_LOCAL size_t eager_p2p;
+extern CRITTER_RANK_LOCAL size_t path_encoding;
+extern CRITTER_RANK_LOCAL size_t causal_p2p;
+extern CRITTER_RANK_LOCAL size_t piggyback_p2p;
+extern CRITTER_RANK_LOCAL size_t batch_waitall;
+extern CRITTER_RANK_LOCAL size_t node_aware;
+extern CRITTER_RANK_LOCAL size_t node_aware_min_bytes;
+extern CRITTER_RANK_LOCAL size_t sample_rate;
+extern CRITTER_RANK_LOCAL double max_overhead;
+extern CRITTER_RANK_LOCAL size_t self_overhead;
+extern CRITTER_RANK_LOCAL size_t delete_comm;
+extern CRITTER_RANK_LOCAL std::vector<char> eager_pad;
+extern CRITTER_RANK_LOCAL std::vector<event> event_list;
+extern CRITTER_RANK_LOCAL std::vector<int> opt_req_match;
+extern CRITTER_RANK_LOCAL std::vector<double> opt_measure_match;
+extern CRITTER_RANK_LOCAL size_t event_list_size;
+extern CRITTER_RANK_LOCAL size_t opt_max_iter;
+extern CRITTER_RANK_LOCAL size_t gradient_jump_size;
+extern CRITTER_RANK_LOCAL size_t num_gradient_points;
+extern CRITTER_RANK_LOCAL size_t
          _MPI_Send__id,
          _MPI_Ssend__id,
          _MPI_Bsend__id,
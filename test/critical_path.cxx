@@ -0,0 +1,376 @@
+// Unit tests of critical path propagation: each test runs a fixed communication pattern under the thread-based MPI stand-in in test/mock
+//   (each process a thread, each computation a delay of its virtual clock), with a critical path known in closed form, and checks the
+//   'Critical path' row of critter's report against it under each configuration below.
+//   As critter spends no virtual time, CompTime and RunTime along the path match the delays exactly, as do the cost measures.
+//   As messages take no virtual time either, all waiting is idle time, so SynchTime is zero along the path and on each process. The
+//   clocks of different nodes are offset (see test/mock/mpi.h), yet the idle time of each process must match that with all on one node.
+//
+//   usage: test_critical_path [test name]
+//   Prints one line per test, configuration, and process count, and exits with nonzero status if any check fails.
+
+#include "../include/critter.h"
+#include "mock/mock.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* \brief values that the 'Critical path' row of critter's report should hold */
+struct expected{
+  double bsp_comm_cost;
+  double bsp_synch_cost;
+  double ab_comm_cost;
+  double ab_synch_cost;
+  double comp_time;
+};
+
+/* \brief communication pattern run by each process, along with the critical path it should report with 'size' processes */
+struct test_case{
+  char const* name;
+  std::function<bool(int size)> valid;
+  std::function<void(int rank, int size)> body;
+  std::function<expected(int size)> path;
+  bool nonblocking_collectives;
+};
+
+/* \brief environment of a configuration of critter */
+struct config{
+  char const* name;
+  std::vector<std::pair<char const*,char const*>> variables;
+};
+
+static const int steps = 4;
+static const int count = 16;
+static const double bytes = count*sizeof(double);
+
+/** \brief time that process 'rank' computes for before its communication at step 'step' */
+static double work(int rank, int step){
+  return 1.e-3*(1+(3*rank+5*step)%7);
+}
+
+/** \brief compute for 'seconds' within a user-defined kernel */
+static void compute(double seconds){
+  CRITTER_START(compute);
+  critter::mock::delay(seconds);
+  CRITTER_STOP(compute);
+}
+
+/** \brief computation time along a path through 'steps' steps, each closed by a routine that merges the paths of all processes */
+static double merged_path_time(int size){
+  double path = 0;
+  for (int k=0; k<steps; k++){
+    double max_time = 0;
+    for (int r=0; r<size; r++){ max_time = std::max(max_time,work(r,k)); }
+    path += max_time;
+  }
+  return path;
+}
+
+static void check_data(bool condition, char const* message){
+  if (!condition){
+    fprintf(stderr,"test_critical_path: %s\n",message);
+    MPI_Abort(MPI_COMM_WORLD,1);
+  }
+}
+
+// Rank r receives a single message from rank r-1, computes, and forwards it to rank r+1
+static test_case chain(){
+  test_case t;
+  t.name = "chain";
+  t.valid = [](int size){ return size > 1; };
+  t.body = [](int rank, int size){
+    std::vector<double> message(count,0.);
+    if (rank > 0) MPI_Recv(&message[0],count,MPI_DOUBLE,rank-1,0,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+    compute(work(rank,0));
+    for (auto& it : message){ it += 1.; }
+    if (rank < size-1) MPI_Send(&message[0],count,MPI_DOUBLE,rank+1,0,MPI_COMM_WORLD);
+    else check_data(message[0] == size,"the last process received a corrupted message");
+  };
+  t.path = [](int size){
+    expected e;
+    // If path data propagates only from sender to receiver, as of the initiation of the send, the path counts the receive and send of a
+    //   single process (see bench/proxy/ring.cxx)
+    char const* piggyback = std::getenv("CRITTER_PIGGYBACK_P2P");
+    bool sender_only = (piggyback != NULL) && (atoi(piggyback) == 1);
+    e.bsp_synch_cost = ((size > 2) && sender_only) ? 2 : size-1;
+    e.bsp_comm_cost = e.bsp_synch_cost*bytes;
+    e.ab_synch_cost = e.bsp_synch_cost;
+    e.ab_comm_cost = e.bsp_comm_cost;
+    e.comp_time = 0;
+    for (int r=0; r<size; r++){ e.comp_time += work(r,0); }
+    return e;
+  };
+  t.nonblocking_collectives = false;
+  return t;
+}
+
+// Each step computes for a time that differs by process, and then merges all paths via MPI_Allreduce
+static test_case allreduce(){
+  test_case t;
+  t.name = "allreduce";
+  t.valid = [](int size){ return true; };
+  t.body = [](int rank, int size){
+    std::vector<double> local(count), global(count);
+    for (int k=0; k<steps; k++){
+      compute(work(rank,k));
+      std::fill(local.begin(),local.end(),(double)rank);
+      MPI_Allreduce(&local[0],&global[0],count,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+      check_data(global[count-1] == size*(size-1)/2,"MPI_Allreduce returned a wrong sum");
+    }
+  };
+  t.path = [](int size){
+    expected e;
+    e.bsp_synch_cost = steps;
+    e.bsp_comm_cost = steps*bytes;
+    e.ab_synch_cost = steps*2.*log2((double)size);
+    e.ab_comm_cost = steps*2.*bytes;
+    e.comp_time = merged_path_time(size);
+    return e;
+  };
+  t.nonblocking_collectives = false;
+  return t;
+}
+
+// Each step exchanges a message between the processes of each pair (2i,2i+1) via MPI_Isend/MPI_Irecv and MPI_Waitall, which merges their paths
+static test_case exchange(){
+  test_case t;
+  t.name = "exchange";
+  t.valid = [](int size){ return size%2 == 0; };
+  t.body = [](int rank, int size){
+    std::vector<double> send(count), recv(count);
+    int partner = rank^1;
+    for (int k=0; k<steps; k++){
+      compute(work(rank,k));
+      std::fill(send.begin(),send.end(),(double)rank);
+      MPI_Request requests[2];
+      MPI_Irecv(&recv[0],count,MPI_DOUBLE,partner,k,MPI_COMM_WORLD,&requests[0]);
+      MPI_Isend(&send[0],count,MPI_DOUBLE,partner,k,MPI_COMM_WORLD,&requests[1]);
+      MPI_Waitall(2,requests,MPI_STATUSES_IGNORE);
+      check_data(recv[0] == partner,"a message holds data from the wrong process");
+    }
+  };
+  t.path = [](int size){
+    expected e;
+    e.bsp_synch_cost = 2*steps;
+    e.bsp_comm_cost = 2*steps*bytes;
+    e.ab_synch_cost = e.bsp_synch_cost;
+    e.ab_comm_cost = e.bsp_comm_cost;
+    e.comp_time = 0;
+    for (int r=0; r<size; r+=2){
+      double path = 0;
+      for (int k=0; k<steps; k++){ path = std::max(path+work(r,k),path+work(r+1,k)); }
+      e.comp_time = std::max(e.comp_time,path);
+    }
+    return e;
+  };
+  t.nonblocking_collectives = false;
+  return t;
+}
+
+// Each step overlaps an MPI_Iallreduce with computation, as in pipelined conjugate gradient, and a final MPI_Allreduce follows.
+//   Each MPI_Wait merges the paths of all processes, so each step adds the longest computation of any process to the path.
+static test_case overlap(){
+  test_case t;
+  t.name = "overlap";
+  t.valid = [](int size){ return true; };
+  t.body = [](int rank, int size){
+    for (int k=0; k<steps; k++){
+      double local[2] = {(double)rank,1.}, global[2];
+      MPI_Request request;
+      MPI_Iallreduce(local,global,2,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD,&request);
+      compute(work(rank,k));
+      MPI_Wait(&request,MPI_STATUS_IGNORE);
+      check_data(global[1] == size,"MPI_Iallreduce returned a wrong sum");
+    }
+    double local = 1., global;
+    MPI_Allreduce(&local,&global,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  };
+  t.path = [](int size){
+    expected e;
+    e.bsp_synch_cost = steps+1;
+    e.bsp_comm_cost = steps*2*sizeof(double) + sizeof(double);
+    e.ab_synch_cost = 2.*log2((double)size)*(steps+1);
+    e.ab_comm_cost = 2.*e.bsp_comm_cost;
+    e.comp_time = merged_path_time(size);
+    return e;
+  };
+  t.nonblocking_collectives = true;
+  return t;
+}
+
+// SUMMA over a 2-by-(size/2) process grid: each step broadcasts a panel along each row communicator, and then along each column communicator.
+//   The root of each broadcast rotates, so the path through each step depends on the computation of all roots before it.
+static test_case summa(){
+  test_case t;
+  t.name = "summa";
+  t.valid = [](int size){ return (size > 2) && (size%2 == 0); };
+  t.body = [](int rank, int size){
+    int pr = 2, pc = size/2;
+    int row = rank / pc, col = rank % pc;
+    MPI_Comm row_comm,col_comm;
+    PMPI_Comm_split(MPI_COMM_WORLD,row,col,&row_comm);
+    PMPI_Comm_split(MPI_COMM_WORLD,col,row,&col_comm);
+    std::vector<double> a_panel(count), b_panel(count);
+    for (int k=0; k<steps; k++){
+      compute(work(rank,k));
+      std::fill(a_panel.begin(),a_panel.end(),(double)(k%pc));
+      std::fill(b_panel.begin(),b_panel.end(),(double)(k%pr));
+      MPI_Bcast(&a_panel[0],count,MPI_DOUBLE,k%pc,row_comm);
+      MPI_Bcast(&b_panel[0],count,MPI_DOUBLE,k%pr,col_comm);
+      check_data((a_panel[0] == k%pc) && (b_panel[0] == k%pr),"MPI_Bcast returned a wrong panel");
+    }
+    MPI_Comm_free(&row_comm);
+    MPI_Comm_free(&col_comm);
+  };
+  t.path = [](int size){
+    int pr = 2, pc = size/2;
+    expected e;
+    e.bsp_synch_cost = 2*steps;
+    e.bsp_comm_cost = 2*steps*bytes;
+    e.ab_synch_cost = steps*(2.*log2((double)pc) + 2.*log2((double)pr));
+    e.ab_comm_cost = 2*steps*2*bytes;
+    // Each broadcast merges the path of its root into those of the other processes of its communicator, unless paths are decomposed by
+    //   user-defined kernel, in which case it merges the paths of all of its processes
+    char const* symbol_path_select = std::getenv("CRITTER_SYMBOL_PATH_SELECT");
+    if ((symbol_path_select != NULL) && (std::string(symbol_path_select).find('1') != std::string::npos)){
+      e.comp_time = merged_path_time(size);
+      return e;
+    }
+    std::vector<double> path(size,0.);
+    for (int k=0; k<steps; k++){
+      for (int r=0; r<size; r++){ path[r] += work(r,k); }
+      for (int r=0; r<size; r++){ path[r] = std::max(path[r],path[(r/pc)*pc+k%pc]); }
+      for (int r=0; r<size; r++){ path[r] = std::max(path[r],path[(k%pr)*pc+r%pc]); }
+    }
+    e.comp_time = *std::max_element(path.begin(),path.end());
+    return e;
+  };
+  t.nonblocking_collectives = false;
+  return t;
+}
+
+/** \brief run 't' with 'size' processes; returns the values of the 'Critical path' row of critter's report by name, those of the
+ *         'Sampled bound (+)' row (if any) by name prefixed with 'bound:', and those of the 'Per-process max' row prefixed with 'max:' */
+static std::map<std::string,double> run(test_case const& t, int size, int processes_per_node){
+  std::ostringstream report;
+  std::streambuf* saved = std::cout.rdbuf(report.rdbuf());
+  critter::mock::run(size,[&t]{
+    MPI_Init(nullptr,nullptr);
+    int rank,size;
+    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+    MPI_Comm_size(MPI_COMM_WORLD,&size);
+    critter::start();
+    t.body(rank,size);
+    critter::stop();
+    MPI_Finalize();
+  },processes_per_node);
+  std::cout.rdbuf(saved);
+
+  // Pair the names in the header of each row with the values on the line that follows
+  std::map<std::string,std::string> rows = { {"Critical path:",""}, {"Per-process max:","max:"} };
+  std::map<std::string,double> reported;
+  std::istringstream lines(report.str());
+  std::string line;
+  std::vector<std::string> path_names;
+  while (std::getline(lines,line)){
+    for (auto& row : rows){
+      if (line.compare(0,row.first.size(),row.first) != 0) continue;
+      std::istringstream names(line.substr(row.first.size()));
+      std::getline(lines,line);
+      std::istringstream values(line);
+      std::string name; double value;
+      while ((names >> name) && (values >> value)){
+        reported[row.second+name] = value;
+        if (row.second.empty()) path_names.push_back(name);
+      }
+      break;
+    }
+    // The bound on each measure of the critical path follows its values, with the same names
+    if (line.compare(0,18,"Sampled bound (+):") == 0){
+      std::istringstream values(line.substr(18));
+      double value;
+      for (auto& name : path_names){ if (values >> value) reported["bound:"+name] = value; }
+    }
+  }
+  return reported;
+}
+
+/** \brief compare each measure of 'reported' against 'e', and the idle time of each process against that reported with all processes
+ *         on one node ('single_node'); a measure reported along with a sampled bound need only lie within it of 'e', from below.
+ *         Returns the number of mismatches, each printed */
+static int compare(std::map<std::string,double>& reported, expected const& e, std::map<std::string,double>& single_node){
+  std::map<std::string,double> values = { {"BSPCommCost",e.bsp_comm_cost}, {"BSPSynchCost",e.bsp_synch_cost}, {"ABCommCost",e.ab_comm_cost},
+                                          {"ABSynchCost",e.ab_synch_cost}, {"CompTime",e.comp_time}, {"RunTime",e.comp_time},
+                                          {"SynchTime",0.}, {"max:SynchTime",0.}, {"max:IdleTime",single_node["max:IdleTime"]} };
+  int failures = 0;
+  for (auto& v : values){
+    auto it = reported.find(v.first);
+    // Values are printed to 6 significant digits, and times sum timestamps offset by as much as the clocks of nodes
+    double tolerance = std::max(1.e-5*std::fabs(v.second),1.e-9);
+    auto bound = reported.find("bound:"+v.first);
+    if ((it != reported.end()) && (bound != reported.end())){
+      if ((it->second > v.second+tolerance) || (it->second+bound->second < v.second-tolerance)){
+        printf("    %s: expected %.9g, reported %s with bound %s\n",v.first.c_str(),v.second,std::to_string(it->second).c_str(),std::to_string(bound->second).c_str());
+        failures++;
+      }
+    }
+    else if ((it == reported.end()) || (std::fabs(it->second-v.second) > tolerance)){
+      printf("    %s: expected %.9g, reported %s\n",v.first.c_str(),v.second,(it == reported.end()) ? "nothing" : std::to_string(it->second).c_str());
+      failures++;
+    }
+  }
+  return failures;
+}
+
+int main(int argc, char** argv){
+  std::vector<test_case> tests = { chain(), allreduce(), exchange(), overlap(), summa() };
+  std::vector<config> configs = {
+    {"default",{}},
+    {"comm_all",{{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    {"encoded",{{"CRITTER_COMM_PATH_SELECT","11111111"},{"CRITTER_PATH_ENCODING","1"}}},
+    {"piggyback",{{"CRITTER_PIGGYBACK_P2P","1"},{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    {"causal",{{"CRITTER_CAUSAL_P2P","1"}}},
+    {"deferred",{{"CRITTER_MECHANISM","1"},{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    {"batched",{{"CRITTER_BATCH_WAITALL","1"}}},
+    {"sampled",{{"CRITTER_SAMPLE_RATE","4"}}},
+    {"self_overhead",{{"CRITTER_SELF_OVERHEAD","2"},{"CRITTER_COMM_PATH_SELECT","11111111"}}},
+    {"symbol",{{"CRITTER_SYMBOL_PATH_SELECT","11111111"}}},
+    {"flat",{{"CRITTER_NODE_AWARE","0"}}},
+    {"node_all",{{"CRITTER_NODE_AWARE_MIN_BYTES","0"}}}
+  };
+  // Processes per node: all on one node, each on its own node, and two per node
+  std::vector<int> node_sizes = {0,1,2};
+  std::vector<int> sizes = {2,4,8};
+
+  int failures = 0, count = 0;
+  for (auto& t : tests){
+    if ((argc > 1) && (strcmp(argv[1],t.name) != 0)) continue;
+    for (auto& c : configs){
+      // User-defined kernels are not tracked through nonblocking collectives (see README)
+      if (t.nonblocking_collectives && (strcmp(c.name,"symbol") == 0)) continue;
+      for (auto size : sizes){
+        if (!t.valid(size)) continue;
+        std::map<std::string,double> single_node;
+        for (auto node_size : node_sizes){
+          for (auto& v : c.variables){ setenv(v.first,v.second,1); }
+          std::map<std::string,double> reported = run(t,size,node_size);
+          if (node_size == 0) single_node = reported;
+          int test_failures = compare(reported,t.path(size),single_node);
+          for (auto& v : c.variables){ unsetenv(v.first); }
+          printf("%s %s %s np=%d ppn=%d\n",test_failures ? "FAIL" : "ok  ",t.name,c.name,size,node_size);
+          failures += (test_failures > 0);
+          count++;
+        }
+      }
+    }
+  }
+  printf("%d of %d failed\n",failures,count);
+  return failures > 0;
+}
@@ -0,0 +1,20 @@
+#ifndef CRITTER__TEST__MOCK__MOCK_H_
+#define CRITTER__TEST__MOCK__MOCK_H_
+
+#include "mpi.h"
+#include <functional>
+
+namespace critter{
+namespace mock{
+
+/** \brief run 'body' once on each of 'num_processes' threads, each of which acts as a process of MPI_COMM_WORLD (and starts its clock at 0);
+ *         returns once all have returned. Processes are assigned to nodes (see MPI_Comm_split_type) in consecutive groups of
+ *         'processes_per_node' (all on one node if 0), and MPI_Wtime on each node is offset from that on the others. */
+void run(int num_processes, std::function<void()> const& body, int processes_per_node = 0);
+/** \brief advance the clock of the calling process by 'seconds', as if it computed for that long */
+void delay(double seconds);
+
+}
+}
+
+#endif /*CRITTER__TEST__MOCK__MOCK_H_*/
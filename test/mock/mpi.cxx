@@ -0,0 +1,1306 @@
+#include "mock.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// All state shared between processes is guarded by a single mutex, and each change to it wakes all waiting processes.
+//   Each process owns its clock, its attributes, and the buffers it passes in; others write into the latter only under the mutex.
+
+struct critter_mock_datatype{
+  /* \brief 'count' consecutive elements of the predefined type 'leaf', at 'displacement' bytes from the start of each instance */
+  struct block{
+    MPI_Aint displacement;
+    critter_mock_datatype* leaf;
+    MPI_Count count;
+  };
+  /** \brief predefined type of 'size' bytes (of which 'extent' bytes separate consecutive elements) */
+  critter_mock_datatype(int id, size_t size, MPI_Aint extent){
+    this->id = id; this->size = size; this->lb = 0; this->extent = extent; this->elements = 1;
+    this->blocks.push_back(block{0,this,1});
+  }
+  /** \brief derived type, to be filled in by the caller */
+  critter_mock_datatype(){
+    this->id = -1; this->size = 0; this->lb = 0; this->extent = 0; this->elements = 0;
+  }
+  /** \brief append the blocks of 't', displaced by 'displacement' bytes, merging blocks that continue one another */
+  void append(critter_mock_datatype const* t, MPI_Aint displacement){
+    for (auto& b : t->blocks){
+      if (!this->blocks.empty()){
+        block& last = this->blocks.back();
+        if ((last.leaf == b.leaf) && (last.displacement + last.count*last.leaf->extent == displacement + b.displacement)){
+          last.count += b.count;
+          continue;
+        }
+      }
+      this->blocks.push_back(block{displacement + b.displacement,b.leaf,b.count});
+    }
+  }
+
+  int id;// index of a predefined type, or -1
+  size_t size;
+  MPI_Aint lb,extent;
+  MPI_Count elements;// predefined elements per instance
+  std::vector<block> blocks;
+  std::map<int,std::map<int,void*>> attributes;// by rank in MPI_COMM_WORLD, then keyval
+};
+
+struct critter_mock_op{
+  int id;
+  MPI_User_function* function;// null for predefined operations
+};
+
+struct critter_mock_group{
+  std::vector<int> world_ranks;
+};
+
+/* \brief contributions of each process to a single collective over a communicator */
+struct critter_mock_collective{
+  int arrived = 0;
+  int departed = 0;
+  double time = 0;// latest clock at which a process arrived
+  std::vector<std::vector<std::vector<char>>> data;// by rank: a single block, or one block per destination
+  std::vector<std::pair<int,int>> keys;// by rank: color and key (MPI_Comm_split)
+  std::shared_ptr<void> result;// created by the first process to complete (new communicators or window)
+};
+
+struct critter_mock_comm{
+  std::vector<int> world_ranks;// by rank
+  std::vector<int> ranks;// by rank in MPI_COMM_WORLD, -1 for non-members
+  std::vector<std::map<int,void*>> attributes;// by rank, then keyval
+  std::vector<uint64_t> sequence;// by rank, the number of collectives started
+  std::map<uint64_t,critter_mock_collective> collectives;
+};
+
+struct critter_mock_message{
+  critter_mock_comm* comm;
+  int source;
+  int tag;
+  std::vector<char> data;
+  double time;// sender's clock when the send started
+  critter_mock_request* sender;// synchronous sends only
+};
+
+struct critter_mock_request{
+  enum kind_t { send, recv, collective };
+  kind_t kind;
+  bool persistent = false;
+  bool active = true;
+  bool complete = false;
+  double time = 0;// clock at which the operation completes
+  double post_time = 0;
+  MPI_Status status;
+  // point-to-point arguments
+  void const* send_buf = nullptr;
+  void* buf = nullptr;
+  int count = 0;
+  MPI_Datatype type = MPI_DATATYPE_NULL;
+  int partner = 0;
+  int tag = 0;
+  bool synchronous = false;
+  critter_mock_comm* comm = nullptr;
+  // collective arguments
+  uint64_t sequence = 0;
+  std::function<void(critter_mock_collective&,int)> finish;
+};
+
+struct critter_mock_win{
+  critter_mock_comm* comm;
+  std::vector<std::max_align_t> memory;
+  std::vector<MPI_Aint> offsets,sizes;
+  std::vector<int> disp_units;
+  int references;
+};
+
+extern "C" {
+critter_mock_comm critter_mock_comm_world;
+critter_mock_datatype critter_mock_char(0,1,1), critter_mock_byte(1,1,1), critter_mock_int(2,sizeof(int),sizeof(int)),
+                      critter_mock_unsigned(3,sizeof(unsigned),sizeof(unsigned)), critter_mock_long(4,sizeof(long),sizeof(long)),
+                      critter_mock_long_long(5,sizeof(long long),sizeof(long long)), critter_mock_int64_t(6,sizeof(int64_t),sizeof(int64_t)),
+                      critter_mock_uint64_t(7,sizeof(uint64_t),sizeof(uint64_t)), critter_mock_float(8,sizeof(float),sizeof(float)),
+                      critter_mock_double(9,sizeof(double),sizeof(double)),
+                      critter_mock_double_int(10,sizeof(double)+sizeof(int),sizeof(std::pair<double,int>));
+critter_mock_op critter_mock_sum{0,nullptr}, critter_mock_prod{1,nullptr}, critter_mock_max{2,nullptr}, critter_mock_min{3,nullptr},
+                critter_mock_bor{4,nullptr}, critter_mock_band{5,nullptr}, critter_mock_maxloc{6,nullptr}, critter_mock_minloc{7,nullptr};
+}
+
+namespace critter{
+namespace mock{
+
+enum { op_sum, op_prod, op_max, op_min, op_bor, op_band, op_maxloc, op_minloc };
+enum { type_char, type_byte, type_int, type_unsigned, type_long, type_long_long, type_int64_t, type_uint64_t, type_float, type_double, type_double_int };
+
+/* \brief state of each process that other processes access */
+struct process{
+  std::deque<critter_mock_message> unexpected;// sent to this process, not yet matched
+  std::deque<critter_mock_request*> posted;// receives posted by this process, not yet matched
+  std::function<bool()> const* waiting = nullptr;// condition this process is blocked on
+};
+
+static std::mutex mutex;
+static std::condition_variable progress;
+static int world_size;
+static int processes_per_node;
+static int running;// processes that have not yet returned from the body passed to 'run'
+static int blocked;
+static std::vector<process> processes;
+static std::vector<std::unique_ptr<critter_mock_comm>> comms;
+static int next_keyval;
+static std::map<int,MPI_Comm_delete_attr_function*> comm_delete_functions;
+static std::map<int,MPI_Type_delete_attr_function*> type_delete_functions;
+
+static thread_local int world_rank = -1;
+static thread_local double clock_time = 0;
+static thread_local void* attached_buffer = nullptr;
+static thread_local int attached_size = 0;
+
+static void fail(char const* message){
+  fprintf(stderr,"mock: process %d: %s\n",world_rank,message);
+  fflush(stderr);
+  std::abort();
+}
+
+// The mutex must be held. Aborts if every running process is blocked, as none could then unblock another.
+static void detect_deadlock(){
+  if ((blocked == 0) || (blocked < running)) return;
+  for (auto& p : processes){
+    if ((p.waiting != nullptr) && (*p.waiting)()) return;
+  }
+  fail("deadlock: each process is blocked on another");
+}
+
+static void block_until(std::unique_lock<std::mutex>& lock, std::function<bool()> const& ready){
+  if (ready()) return;
+  process& p = processes[world_rank];
+  p.waiting = &ready;
+  blocked++;
+  detect_deadlock();
+  progress.wait(lock,ready);
+  p.waiting = nullptr;
+  blocked--;
+}
+
+static critter_mock_comm* create_comm(std::vector<int> const& world_ranks){
+  critter_mock_comm* comm = new critter_mock_comm();
+  comm->world_ranks = world_ranks;
+  comm->ranks.assign(world_size,-1);
+  for (size_t i=0; i<world_ranks.size(); i++){ comm->ranks[world_ranks[i]] = i; }
+  comm->attributes.resize(world_ranks.size());
+  comm->sequence.assign(world_ranks.size(),0);
+  return comm;
+}
+
+static int rank_of(critter_mock_comm* comm){
+  int rank = comm->ranks[world_rank];
+  if (rank < 0) fail("the calling process is not a member of the communicator");
+  return rank;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// datatypes and reduction operations
+
+/** \brief copy 'count' instances of 't' at 'buf' into a contiguous byte stream */
+static std::vector<char> pack(void const* buf, int count, MPI_Datatype t){
+  std::vector<char> data(count*t->size);
+  char* out = data.data();
+  for (int i=0; i<count; i++){
+    char const* base = (char const*)((intptr_t)buf + i*t->extent);
+    for (auto& b : t->blocks){
+      char const* in = base + b.displacement;
+      if ((size_t)b.leaf->extent == b.leaf->size){ std::memcpy(out,in,b.count*b.leaf->size); out += b.count*b.leaf->size; }
+      else{
+        for (MPI_Count k=0; k<b.count; k++){ std::memcpy(out,in+k*b.leaf->extent,b.leaf->size); out += b.leaf->size; }
+      }
+    }
+  }
+  return data;
+}
+
+/** \brief copy the byte stream 'data' into (at most) 'count' instances of 't' at 'buf' */
+static void unpack(void* buf, int count, MPI_Datatype t, std::vector<char> const& data){
+  if (data.size() > count*t->size) fail("message truncated");
+  char const* in = data.data();
+  char const* end = in + data.size();
+  for (int i=0; (i<count) && (in<end); i++){
+    char* base = (char*)((intptr_t)buf + i*t->extent);
+    for (auto& b : t->blocks){
+      char* out = base + b.displacement;
+      for (MPI_Count k=0; (k<b.count) && (in<end); k++){ std::memcpy(out+k*b.leaf->extent,in,b.leaf->size); in += b.leaf->size; }
+    }
+  }
+}
+
+/** \brief copy the 'count' instances of 't' at 'buf' as laid out in memory, for reduction */
+static std::vector<char> copy(void const* buf, int count, MPI_Datatype t){
+  std::vector<char> data(count*t->extent);
+  if (count > 0) std::memcpy(data.data(),buf,data.size());
+  return data;
+}
+
+template<typename T> static void arithmetic(int op, char const* in, char* inout){
+  T a,b; std::memcpy(&a,in,sizeof(T)); std::memcpy(&b,inout,sizeof(T));
+  switch (op){
+    case op_sum: b = a+b; break;
+    case op_prod: b = a*b; break;
+    case op_max: b = std::max(a,b); break;
+    case op_min: b = std::min(a,b); break;
+    default: fail("unsupported reduction operation for this datatype");
+  }
+  std::memcpy(inout,&b,sizeof(T));
+}
+
+template<typename T> static void integral(int op, char const* in, char* inout){
+  if ((op != op_bor) && (op != op_band)) { arithmetic<T>(op,in,inout); return; }
+  T a,b; std::memcpy(&a,in,sizeof(T)); std::memcpy(&b,inout,sizeof(T));
+  b = (op == op_bor) ? (a | b) : (a & b);
+  std::memcpy(inout,&b,sizeof(T));
+}
+
+static void location(int op, char const* in, char* inout){
+  double a,b; int i,j;
+  std::memcpy(&a,in,sizeof(double)); std::memcpy(&i,in+sizeof(double),sizeof(int));
+  std::memcpy(&b,inout,sizeof(double)); std::memcpy(&j,inout+sizeof(double),sizeof(int));
+  if (op == op_maxloc){
+    if ((a > b) || ((a == b) && (i < j))) { std::memcpy(inout,in,sizeof(double)+sizeof(int)); }
+  } else if (op == op_minloc){
+    if ((a < b) || ((a == b) && (i < j))) { std::memcpy(inout,in,sizeof(double)+sizeof(int)); }
+  } else{
+    fail("unsupported reduction operation for MPI_DOUBLE_INT");
+  }
+}
+
+/** \brief inout = in (op) inout, elementwise over 'count' instances of 't', each laid out as in memory */
+static void apply(MPI_Op op, char const* in, char* inout, int count, MPI_Datatype t){
+  if (op->function != nullptr){
+    int len = count; MPI_Datatype type = t;
+    op->function((void*)in,inout,&len,&type);
+    return;
+  }
+  for (int i=0; i<count; i++){
+    for (auto& b : t->blocks){
+      for (MPI_Count k=0; k<b.count; k++){
+        MPI_Aint offset = i*t->extent + b.displacement + k*b.leaf->extent;
+        switch (b.leaf->id){
+          case type_char: integral<char>(op->id,in+offset,inout+offset); break;
+          case type_byte: integral<unsigned char>(op->id,in+offset,inout+offset); break;
+          case type_int: integral<int>(op->id,in+offset,inout+offset); break;
+          case type_unsigned: integral<unsigned>(op->id,in+offset,inout+offset); break;
+          case type_long: integral<long>(op->id,in+offset,inout+offset); break;
+          case type_long_long: integral<long long>(op->id,in+offset,inout+offset); break;
+          case type_int64_t: integral<int64_t>(op->id,in+offset,inout+offset); break;
+          case type_uint64_t: integral<uint64_t>(op->id,in+offset,inout+offset); break;
+          case type_float: arithmetic<float>(op->id,in+offset,inout+offset); break;
+          case type_double: arithmetic<double>(op->id,in+offset,inout+offset); break;
+          case type_double_int: location(op->id,in+offset,inout+offset); break;
+        }
+      }
+    }
+  }
+}
+
+/** \brief reduce the first block of each contribution to 'c' in rank order, into 'recvbuf' (starting 'offset' elements in, for 'count' elements) */
+static void reduce_contributions(critter_mock_collective& c, void* recvbuf, int offset, int count, MPI_Datatype t, MPI_Op op, int total){
+  std::vector<char> result = c.data.back()[0];
+  for (int r=(int)c.data.size()-2; r>=0; r--){ apply(op,c.data[r][0].data(),result.data(),total,t); }
+  if (count > 0) std::memcpy(recvbuf,result.data()+offset*t->extent,count*t->extent);
+}
+
+static void call_type_delete_functions(MPI_Datatype t){
+  std::map<int,void*> attributes;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = t->attributes.find(world_rank);
+    if (it == t->attributes.end()) return;
+    attributes.swap(it->second);
+  }
+  for (auto& a : attributes){
+    MPI_Type_delete_attr_function* function;
+    { std::unique_lock<std::mutex> lock(mutex); function = type_delete_functions[a.first]; }
+    if (function != nullptr) function(t,a.first,a.second,nullptr);
+  }
+}
+
+static void call_comm_delete_function(MPI_Comm comm, int keyval, void* value){
+  MPI_Comm_delete_attr_function* function;
+  { std::unique_lock<std::mutex> lock(mutex); function = comm_delete_functions[keyval]; }
+  if (function != nullptr) function(comm,keyval,value,nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// point-to-point communication
+
+static bool matches(critter_mock_request const* r, critter_mock_message const& m){
+  return (r->comm == m.comm) && ((r->partner == MPI_ANY_SOURCE) || (r->partner == m.source)) && ((r->tag == MPI_ANY_TAG) || (r->tag == m.tag));
+}
+
+static void set_status(MPI_Status& status, int source, int tag, MPI_Count bytes){
+  status.MPI_SOURCE = source; status.MPI_TAG = tag; status.MPI_ERROR = MPI_SUCCESS; status.bytes = bytes;
+}
+
+// The mutex must be held
+static void match(critter_mock_request* r, critter_mock_message& m){
+  unpack(r->buf,r->count,r->type,m.data);
+  set_status(r->status,m.source,m.tag,m.data.size());
+  r->time = std::max(r->post_time,m.time);
+  r->complete = true;
+  if (m.sender != nullptr){
+    m.sender->time = std::max(m.time,r->post_time);
+    m.sender->complete = true;
+  }
+  progress.notify_all();
+}
+
+static void start_send(critter_mock_request* r){
+  r->complete = false;
+  r->post_time = clock_time;
+  if (r->partner == MPI_PROC_NULL){
+    r->time = clock_time; r->complete = true;
+    return;
+  }
+  critter_mock_message m;
+  m.comm = r->comm;
+  m.source = rank_of(r->comm);
+  m.tag = r->tag;
+  m.data = pack(r->send_buf,r->count,r->type);
+  m.time = clock_time;
+  m.sender = r->synchronous ? r : nullptr;
+  if (!r->synchronous){ r->time = clock_time; r->complete = true; }
+  std::unique_lock<std::mutex> lock(mutex);
+  process& dest = processes[r->comm->world_ranks[r->partner]];
+  for (auto it=dest.posted.begin(); it!=dest.posted.end(); it++){
+    if (matches(*it,m)){
+      critter_mock_request* recv = *it;
+      dest.posted.erase(it);
+      match(recv,m);
+      return;
+    }
+  }
+  dest.unexpected.push_back(std::move(m));
+  progress.notify_all();
+}
+
+static void start_recv(critter_mock_request* r){
+  r->complete = false;
+  r->post_time = clock_time;
+  if (r->partner == MPI_PROC_NULL){
+    set_status(r->status,MPI_PROC_NULL,MPI_ANY_TAG,0);
+    r->time = clock_time; r->complete = true;
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  process& self = processes[world_rank];
+  for (auto it=self.unexpected.begin(); it!=self.unexpected.end(); it++){
+    if (matches(r,*it)){
+      match(r,*it);
+      self.unexpected.erase(it);
+      return;
+    }
+  }
+  self.posted.push_back(r);
+}
+
+static critter_mock_request* create_p2p(critter_mock_request::kind_t kind, void const* buf, int count, MPI_Datatype t, int partner, int tag,
+                                        MPI_Comm comm, bool synchronous){
+  if (comm == MPI_COMM_NULL) fail("invalid communicator");
+  critter_mock_request* r = new critter_mock_request();
+  r->kind = kind;
+  r->send_buf = buf; r->buf = (void*)buf;
+  r->count = count; r->type = t; r->partner = partner; r->tag = tag; r->comm = comm; r->synchronous = synchronous;
+  return r;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// collectives
+
+typedef std::function<void(critter_mock_collective&,int)> finish_function;
+
+static bool arrived(critter_mock_comm* comm, uint64_t sequence){
+  return comm->collectives[sequence].arrived == (int)comm->world_ranks.size();
+}
+
+// The mutex must be held. Completes the calling process's part of the collective, once all processes have arrived.
+static void leave(critter_mock_comm* comm, uint64_t sequence, finish_function const& finish){
+  critter_mock_collective& c = comm->collectives[sequence];
+  int rank = rank_of(comm);
+  if (finish) finish(c,rank);
+  clock_time = std::max(clock_time,c.time);
+  if (++c.departed == (int)comm->world_ranks.size()) comm->collectives.erase(sequence);
+}
+
+/** \brief contribute 'data' to the next collective over 'comm', and run 'finish' once all processes have contributed (within MPI_Wait if 'request' is non-null) */
+static int collective(MPI_Comm comm, std::vector<std::vector<char>> data, finish_function finish, MPI_Request* request, std::pair<int,int> key = {0,0}){
+  if (comm == MPI_COMM_NULL) fail("invalid communicator");
+  int rank = rank_of(comm);
+  std::unique_lock<std::mutex> lock(mutex);
+  uint64_t sequence = comm->sequence[rank]++;
+  critter_mock_collective& c = comm->collectives[sequence];
+  if (c.data.empty()){ c.data.resize(comm->world_ranks.size()); c.keys.resize(comm->world_ranks.size()); }
+  c.data[rank] = std::move(data);
+  c.keys[rank] = key;
+  c.arrived++;
+  c.time = std::max(c.time,clock_time);
+  progress.notify_all();
+  if (request != nullptr){
+    critter_mock_request* r = new critter_mock_request();
+    r->kind = critter_mock_request::collective;
+    r->comm = comm; r->sequence = sequence; r->finish = std::move(finish);
+    *request = r;
+    return MPI_SUCCESS;
+  }
+  block_until(lock,[&]{ return arrived(comm,sequence); });
+  leave(comm,sequence,finish);
+  return MPI_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// completion
+
+static bool is_ready(critter_mock_request* r){
+  if (r->kind == critter_mock_request::collective) return arrived(r->comm,r->sequence);
+  return r->complete;
+}
+
+static bool is_active(MPI_Request r){
+  return (r != MPI_REQUEST_NULL) && r->active;
+}
+
+static void set_empty_status(MPI_Status* status){
+  if (status != MPI_STATUS_IGNORE) set_status(*status,MPI_ANY_SOURCE,MPI_ANY_TAG,0);
+}
+
+// The mutex must be held, and the request must be ready
+static void finish_request(MPI_Request* request, MPI_Status* status){
+  critter_mock_request* r = *request;
+  if (r->kind == critter_mock_request::collective){
+    leave(r->comm,r->sequence,r->finish);
+    set_empty_status(status);
+  } else{
+    clock_time = std::max(clock_time,r->time);
+    if (status != MPI_STATUS_IGNORE) *status = r->status;
+  }
+  if (r->persistent){ r->active = false; r->complete = false; }
+  else{ delete r; *request = MPI_REQUEST_NULL; }
+}
+
+static int wait_some(int count, MPI_Request requests[], int* outcount, int indices[], MPI_Status statuses[], bool block){
+  std::unique_lock<std::mutex> lock(mutex);
+  bool any_active = false;
+  for (int i=0; i<count; i++){ any_active |= is_active(requests[i]); }
+  if (!any_active){ *outcount = MPI_UNDEFINED; return MPI_SUCCESS; }
+  auto any_ready = [&]{
+    for (int i=0; i<count; i++){ if (is_active(requests[i]) && is_ready(requests[i])) return true; }
+    return false;
+  };
+  if (block) block_until(lock,any_ready);
+  *outcount = 0;
+  for (int i=0; i<count; i++){
+    if (is_active(requests[i]) && is_ready(requests[i])){
+      indices[*outcount] = i;
+      finish_request(&requests[i],(statuses == MPI_STATUSES_IGNORE) ? MPI_STATUS_IGNORE : &statuses[*outcount]);
+      (*outcount)++;
+    }
+  }
+  return MPI_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// launcher
+
+void run(int num_processes, std::function<void()> const& body, int ranks_per_node){
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    world_size = num_processes;
+    processes_per_node = ranks_per_node;
+    running = num_processes;
+    blocked = 0;
+    processes.clear(); processes.resize(num_processes);
+    comms.clear();
+    std::vector<int> world_ranks(num_processes);
+    for (int i=0; i<num_processes; i++){ world_ranks[i] = i; }
+    std::unique_ptr<critter_mock_comm> world(create_comm(world_ranks));
+    critter_mock_comm_world = std::move(*world);
+  }
+  std::vector<std::thread> threads;
+  for (int i=0; i<num_processes; i++){
+    threads.emplace_back([&body,i]{
+      world_rank = i;
+      body();
+      std::unique_lock<std::mutex> lock(mutex);
+      running--;
+      detect_deadlock();
+    });
+  }
+  for (auto& t : threads){ t.join(); }
+}
+
+void delay(double seconds){
+  clock_time += seconds;
+}
+
+}
+}
+
+using namespace critter::mock;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// environment
+
+int PMPI_Init(int* argc, char*** argv){
+  if (world_rank < 0) fail("MPI must be initialized within critter::mock::run");
+  return MPI_SUCCESS;
+}
+
+int PMPI_Init_thread(int* argc, char*** argv, int required, int* provided){
+  *provided = required;
+  return PMPI_Init(argc,argv);
+}
+
+int PMPI_Initialized(int* flag){
+  *flag = (world_rank >= 0);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Finalize(){
+  std::map<int,void*> attributes;
+  attributes.swap(critter_mock_comm_world.attributes[world_rank]);
+  for (auto& a : attributes){ call_comm_delete_function(MPI_COMM_WORLD,a.first,a.second); }
+  return MPI_SUCCESS;
+}
+
+int PMPI_Abort(MPI_Comm comm, int errorcode){
+  fprintf(stderr,"mock: process %d called MPI_Abort with error code %d\n",world_rank,errorcode);
+  fflush(stdout); fflush(stderr);
+  std::_Exit(errorcode != 0 ? errorcode : 1);
+}
+
+// Seconds by which MPI_Wtime of each node is ahead of the clock it is measured against, far more than any time measured
+static double node_clock_offset(){
+  return (processes_per_node > 0) ? 1000.*(world_rank/processes_per_node) : 0.;
+}
+
+double PMPI_Wtime(){
+  return clock_time + node_clock_offset();
+}
+
+double PMPI_Wtick(){
+  return 1.e-9;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// communicators, groups, and attributes
+
+int PMPI_Comm_rank(MPI_Comm comm, int* rank){
+  *rank = comm->ranks[world_rank];
+  if (*rank < 0) *rank = MPI_UNDEFINED;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_size(MPI_Comm comm, int* size){
+  *size = comm->world_ranks.size();
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm* newcomm){
+  return collective(comm,{},[comm,color,newcomm](critter_mock_collective& c, int rank){
+    typedef std::map<int,critter_mock_comm*> comm_map;
+    if (!c.result){
+      std::map<int,std::vector<std::pair<int,int>>> members;// by color: key and rank
+      for (size_t r=0; r<c.keys.size(); r++){
+        if (c.keys[r].first != MPI_UNDEFINED) members[c.keys[r].first].push_back(std::make_pair(c.keys[r].second,(int)r));
+      }
+      std::shared_ptr<comm_map> split(new comm_map());
+      for (auto& m : members){
+        std::stable_sort(m.second.begin(),m.second.end());
+        std::vector<int> world_ranks;
+        for (auto& member : m.second){ world_ranks.push_back(comm->world_ranks[member.second]); }
+        comms.emplace_back(create_comm(world_ranks));
+        (*split)[m.first] = comms.back().get();
+      }
+      c.result = split;
+    }
+    *newcomm = (color == MPI_UNDEFINED) ? MPI_COMM_NULL : (*std::static_pointer_cast<comm_map>(c.result))[color];
+  },nullptr,std::make_pair(color,key));
+}
+
+int PMPI_Comm_split_type(MPI_Comm comm, int split_type, int key, MPI_Info info, MPI_Comm* newcomm){
+  int color = MPI_UNDEFINED;
+  if (split_type == MPI_COMM_TYPE_SHARED){ color = (processes_per_node > 0) ? world_rank/processes_per_node : 0; }
+  return PMPI_Comm_split(comm,color,key,newcomm);
+}
+
+int PMPI_Comm_dup(MPI_Comm comm, MPI_Comm* newcomm){
+  return PMPI_Comm_split(comm,0,rank_of(comm),newcomm);
+}
+
+int PMPI_Comm_free(MPI_Comm* comm){
+  if ((*comm == MPI_COMM_NULL) || (*comm == MPI_COMM_WORLD)) fail("invalid communicator passed to MPI_Comm_free");
+  std::map<int,void*> attributes;
+  attributes.swap((*comm)->attributes[rank_of(*comm)]);
+  for (auto& a : attributes){ call_comm_delete_function(*comm,a.first,a.second); }
+  *comm = MPI_COMM_NULL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_compare(MPI_Comm comm1, MPI_Comm comm2, int* result){
+  if (comm1 == comm2) { *result = MPI_IDENT; return MPI_SUCCESS; }
+  if (comm1->world_ranks == comm2->world_ranks) { *result = MPI_CONGRUENT; return MPI_SUCCESS; }
+  std::vector<int> ranks1 = comm1->world_ranks, ranks2 = comm2->world_ranks;
+  std::sort(ranks1.begin(),ranks1.end()); std::sort(ranks2.begin(),ranks2.end());
+  *result = (ranks1 == ranks2) ? MPI_SIMILAR : MPI_UNEQUAL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_group(MPI_Comm comm, MPI_Group* group){
+  *group = new critter_mock_group{comm->world_ranks};
+  return MPI_SUCCESS;
+}
+
+int PMPI_Group_translate_ranks(MPI_Group group1, int n, const int ranks1[], MPI_Group group2, int ranks2[]){
+  for (int i=0; i<n; i++){
+    if (ranks1[i] == MPI_PROC_NULL) { ranks2[i] = MPI_PROC_NULL; continue; }
+    auto it = std::find(group2->world_ranks.begin(),group2->world_ranks.end(),group1->world_ranks[ranks1[i]]);
+    ranks2[i] = (it == group2->world_ranks.end()) ? MPI_UNDEFINED : (int)(it - group2->world_ranks.begin());
+  }
+  return MPI_SUCCESS;
+}
+
+int PMPI_Group_free(MPI_Group* group){
+  delete *group;
+  *group = MPI_GROUP_NULL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_create_keyval(MPI_Comm_copy_attr_function* copy_fn, MPI_Comm_delete_attr_function* delete_fn, int* keyval, void* extra_state){
+  std::unique_lock<std::mutex> lock(mutex);
+  *keyval = next_keyval++;
+  comm_delete_functions[*keyval] = delete_fn;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_free_keyval(int* keyval){
+  *keyval = MPI_KEYVAL_INVALID;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_set_attr(MPI_Comm comm, int keyval, void* attribute_val){
+  std::map<int,void*>& attributes = comm->attributes[rank_of(comm)];
+  auto it = attributes.find(keyval);
+  if (it != attributes.end()){ call_comm_delete_function(comm,keyval,it->second); }
+  attributes[keyval] = attribute_val;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_get_attr(MPI_Comm comm, int keyval, void* attribute_val, int* flag){
+  if (keyval == MPI_WTIME_IS_GLOBAL){
+    static const int is_global = 1, is_not_global = 0;
+    bool one_node = (processes_per_node == 0) || (processes_per_node >= world_size);
+    *flag = 1;
+    *(int const**)attribute_val = one_node ? &is_global : &is_not_global;
+    return MPI_SUCCESS;
+  }
+  std::map<int,void*>& attributes = comm->attributes[rank_of(comm)];
+  auto it = attributes.find(keyval);
+  *flag = (it != attributes.end());
+  if (*flag) *(void**)attribute_val = it->second;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Comm_delete_attr(MPI_Comm comm, int keyval){
+  std::map<int,void*>& attributes = comm->attributes[rank_of(comm)];
+  auto it = attributes.find(keyval);
+  if (it == attributes.end()) return MPI_ERR_OTHER;
+  void* value = it->second;
+  attributes.erase(it);
+  call_comm_delete_function(comm,keyval,value);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_create_keyval(MPI_Type_copy_attr_function* copy_fn, MPI_Type_delete_attr_function* delete_fn, int* keyval, void* extra_state){
+  std::unique_lock<std::mutex> lock(mutex);
+  *keyval = next_keyval++;
+  type_delete_functions[*keyval] = delete_fn;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_set_attr(MPI_Datatype datatype, int keyval, void* attribute_val){
+  std::unique_lock<std::mutex> lock(mutex);
+  datatype->attributes[world_rank][keyval] = attribute_val;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_get_attr(MPI_Datatype datatype, int keyval, void* attribute_val, int* flag){
+  std::unique_lock<std::mutex> lock(mutex);
+  std::map<int,void*>& attributes = datatype->attributes[world_rank];
+  auto it = attributes.find(keyval);
+  *flag = (it != attributes.end());
+  if (*flag) *(void**)attribute_val = it->second;
+  return MPI_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// datatypes and operations
+
+int PMPI_Type_contiguous(int count, MPI_Datatype oldtype, MPI_Datatype* newtype){
+  critter_mock_datatype* t = new critter_mock_datatype();
+  for (int i=0; i<count; i++){ t->append(oldtype,i*oldtype->extent); }
+  t->size = count*oldtype->size;
+  t->lb = oldtype->lb;
+  t->extent = count*oldtype->extent;
+  t->elements = count*oldtype->elements;
+  *newtype = t;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_create_struct(int count, const int array_of_blocklengths[], const MPI_Aint array_of_displacements[],
+                            const MPI_Datatype array_of_types[], MPI_Datatype* newtype){
+  critter_mock_datatype* t = new critter_mock_datatype();
+  MPI_Aint lb = 0, ub = 0;
+  for (int i=0; i<count; i++){
+    MPI_Datatype old = array_of_types[i];
+    for (int j=0; j<array_of_blocklengths[i]; j++){ t->append(old,array_of_displacements[i]+j*old->extent); }
+    t->size += array_of_blocklengths[i]*old->size;
+    t->elements += array_of_blocklengths[i]*old->elements;
+    MPI_Aint block_lb = array_of_displacements[i]+old->lb;
+    MPI_Aint block_ub = block_lb+array_of_blocklengths[i]*old->extent;
+    lb = (i == 0) ? block_lb : std::min(lb,block_lb);
+    ub = (i == 0) ? block_ub : std::max(ub,block_ub);
+  }
+  t->lb = lb;
+  t->extent = ub-lb;
+  *newtype = t;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_commit(MPI_Datatype* datatype){
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_free(MPI_Datatype* datatype){
+  if ((*datatype)->id >= 0) fail("predefined datatypes cannot be freed");
+  call_type_delete_functions(*datatype);
+  delete *datatype;
+  *datatype = MPI_DATATYPE_NULL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_size(MPI_Datatype datatype, int* size){
+  *size = datatype->size;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Type_get_extent(MPI_Datatype datatype, MPI_Aint* lb, MPI_Aint* extent){
+  *lb = datatype->lb;
+  *extent = datatype->extent;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Get_address(const void* location, MPI_Aint* address){
+  *address = (MPI_Aint)location;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Op_create(MPI_User_function* user_fn, int commute, MPI_Op* op){
+  *op = new critter_mock_op{-1,user_fn};
+  return MPI_SUCCESS;
+}
+
+int PMPI_Op_free(MPI_Op* op){
+  if ((*op)->function == nullptr) fail("predefined operations cannot be freed");
+  delete *op;
+  *op = MPI_OP_NULL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Reduce_local(const void* inbuf, void* inoutbuf, int count, MPI_Datatype datatype, MPI_Op op){
+  apply(op,(char const*)inbuf,(char*)inoutbuf,count,datatype);
+  return MPI_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// point-to-point communication
+
+int PMPI_Isend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request){
+  *request = create_p2p(critter_mock_request::send,buf,count,datatype,dest,tag,comm,false);
+  start_send(*request);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Issend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request){
+  *request = create_p2p(critter_mock_request::send,buf,count,datatype,dest,tag,comm,true);
+  start_send(*request);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request* request){
+  *request = create_p2p(critter_mock_request::recv,buf,count,datatype,source,tag,comm,false);
+  start_recv(*request);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Send(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm){
+  MPI_Request request;
+  PMPI_Isend(buf,count,datatype,dest,tag,comm,&request);
+  return PMPI_Wait(&request,MPI_STATUS_IGNORE);
+}
+
+int PMPI_Ssend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm){
+  MPI_Request request;
+  PMPI_Issend(buf,count,datatype,dest,tag,comm,&request);
+  return PMPI_Wait(&request,MPI_STATUS_IGNORE);
+}
+
+int PMPI_Bsend(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm){
+  if (attached_buffer == nullptr) fail("MPI_Bsend without an attached buffer");
+  return PMPI_Send(buf,count,datatype,dest,tag,comm);
+}
+
+int PMPI_Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status* status){
+  MPI_Request request;
+  PMPI_Irecv(buf,count,datatype,source,tag,comm,&request);
+  return PMPI_Wait(&request,status);
+}
+
+int PMPI_Sendrecv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, int dest, int sendtag, void* recvbuf, int recvcount,
+                  MPI_Datatype recvtype, int source, int recvtag, MPI_Comm comm, MPI_Status* status){
+  MPI_Request requests[2];
+  PMPI_Isend(sendbuf,sendcount,sendtype,dest,sendtag,comm,&requests[0]);
+  PMPI_Irecv(recvbuf,recvcount,recvtype,source,recvtag,comm,&requests[1]);
+  PMPI_Wait(&requests[0],MPI_STATUS_IGNORE);
+  return PMPI_Wait(&requests[1],status);
+}
+
+int PMPI_Sendrecv_replace(void* buf, int count, MPI_Datatype datatype, int dest, int sendtag, int source, int recvtag, MPI_Comm comm,
+                          MPI_Status* status){
+  // The send packs 'buf' as it starts, so the receive may overwrite it
+  return PMPI_Sendrecv(buf,count,datatype,dest,sendtag,buf,count,datatype,source,recvtag,comm,status);
+}
+
+int PMPI_Send_init(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request){
+  *request = create_p2p(critter_mock_request::send,buf,count,datatype,dest,tag,comm,false);
+  (*request)->persistent = true;
+  (*request)->active = false;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Recv_init(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request* request){
+  *request = create_p2p(critter_mock_request::recv,buf,count,datatype,source,tag,comm,false);
+  (*request)->persistent = true;
+  (*request)->active = false;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Start(MPI_Request* request){
+  critter_mock_request* r = *request;
+  if (!r->persistent || r->active) fail("MPI_Start requires an inactive persistent request");
+  r->active = true;
+  if (r->kind == critter_mock_request::send) start_send(r);
+  else start_recv(r);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Request_free(MPI_Request* request){
+  critter_mock_request* r = *request;
+  if (r->active && (r->persistent || !r->complete)) fail("MPI_Request_free is only supported on complete or inactive persistent requests");
+  delete r;
+  *request = MPI_REQUEST_NULL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Wait(MPI_Request* request, MPI_Status* status){
+  if (!is_active(*request)) { set_empty_status(status); return MPI_SUCCESS; }
+  std::unique_lock<std::mutex> lock(mutex);
+  critter_mock_request* r = *request;
+  block_until(lock,[r]{ return is_ready(r); });
+  finish_request(request,status);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Test(MPI_Request* request, int* flag, MPI_Status* status){
+  if (!is_active(*request)) { *flag = 1; set_empty_status(status); return MPI_SUCCESS; }
+  std::unique_lock<std::mutex> lock(mutex);
+  *flag = is_ready(*request);
+  if (*flag) finish_request(request,status);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]){
+  for (int i=0; i<count; i++){
+    PMPI_Wait(&array_of_requests[i],(array_of_statuses == MPI_STATUSES_IGNORE) ? MPI_STATUS_IGNORE : &array_of_statuses[i]);
+  }
+  return MPI_SUCCESS;
+}
+
+int PMPI_Waitany(int count, MPI_Request array_of_requests[], int* indx, MPI_Status* status){
+  std::unique_lock<std::mutex> lock(mutex);
+  auto first_ready = [&]{
+    for (int i=0; i<count; i++){ if (is_active(array_of_requests[i]) && is_ready(array_of_requests[i])) return i; }
+    return -1;
+  };
+  bool any_active = false;
+  for (int i=0; i<count; i++){ any_active |= is_active(array_of_requests[i]); }
+  if (!any_active){ *indx = MPI_UNDEFINED; set_empty_status(status); return MPI_SUCCESS; }
+  block_until(lock,[&]{ return first_ready() >= 0; });
+  *indx = first_ready();
+  finish_request(&array_of_requests[*indx],status);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Waitsome(int incount, MPI_Request array_of_requests[], int* outcount, int array_of_indices[], MPI_Status array_of_statuses[]){
+  return wait_some(incount,array_of_requests,outcount,array_of_indices,array_of_statuses,true);
+}
+
+int PMPI_Testsome(int incount, MPI_Request array_of_requests[], int* outcount, int array_of_indices[], MPI_Status array_of_statuses[]){
+  return wait_some(incount,array_of_requests,outcount,array_of_indices,array_of_statuses,false);
+}
+
+int PMPI_Mprobe(int source, int tag, MPI_Comm comm, MPI_Message* message, MPI_Status* status){
+  if (source == MPI_PROC_NULL) fail("MPI_Mprobe from MPI_PROC_NULL is not supported");
+  critter_mock_request probe;
+  probe.partner = source; probe.tag = tag; probe.comm = comm;
+  std::unique_lock<std::mutex> lock(mutex);
+  std::deque<critter_mock_message>& unexpected = processes[world_rank].unexpected;
+  auto find = [&]{ return std::find_if(unexpected.begin(),unexpected.end(),[&](critter_mock_message const& m){ return matches(&probe,m); }); };
+  block_until(lock,[&]{ return find() != unexpected.end(); });
+  auto it = find();
+  critter_mock_message* m = new critter_mock_message(std::move(*it));
+  unexpected.erase(it);
+  if (m->sender != nullptr){
+    m->sender->time = std::max(m->time,clock_time);
+    m->sender->complete = true;
+    progress.notify_all();
+  }
+  clock_time = std::max(clock_time,m->time);
+  if (status != MPI_STATUS_IGNORE) set_status(*status,m->source,m->tag,m->data.size());
+  *message = m;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Mrecv(void* buf, int count, MPI_Datatype datatype, MPI_Message* message, MPI_Status* status){
+  critter_mock_message* m = *message;
+  unpack(buf,count,datatype,m->data);
+  if (status != MPI_STATUS_IGNORE) set_status(*status,m->source,m->tag,m->data.size());
+  delete m;
+  *message = MPI_MESSAGE_NULL;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Get_count(const MPI_Status* status, MPI_Datatype datatype, int* count){
+  if (datatype->size == 0) *count = 0;
+  else *count = (status->bytes % datatype->size == 0) ? (int)(status->bytes/datatype->size) : MPI_UNDEFINED;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Get_elements_x(const MPI_Status* status, MPI_Datatype datatype, MPI_Count* count){
+  // Whole instances hold 'elements' each; the remainder is walked block by block
+  *count = 0;
+  if (datatype->size == 0) return MPI_SUCCESS;
+  MPI_Count instances = status->bytes/datatype->size;
+  MPI_Count bytes = status->bytes - instances*datatype->size;
+  *count = instances*datatype->elements;
+  for (auto& b : datatype->blocks){
+    MPI_Count n = std::min(b.count,bytes/(MPI_Count)b.leaf->size);
+    *count += n;
+    bytes -= n*b.leaf->size;
+    if (n < b.count) break;
+  }
+  return MPI_SUCCESS;
+}
+
+int PMPI_Status_set_elements_x(MPI_Status* status, MPI_Datatype datatype, MPI_Count count){
+  MPI_Count instances = (datatype->elements > 0) ? count/datatype->elements : 0;
+  MPI_Count elements = count - instances*datatype->elements;
+  status->bytes = instances*datatype->size;
+  for (auto& b : datatype->blocks){
+    MPI_Count n = std::min(b.count,elements);
+    status->bytes += n*b.leaf->size;
+    elements -= n;
+  }
+  return MPI_SUCCESS;
+}
+
+int PMPI_Buffer_attach(void* buffer, int size){
+  attached_buffer = buffer;
+  attached_size = size;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Buffer_detach(void* buffer_addr, int* size){
+  *(void**)buffer_addr = attached_buffer;
+  *size = attached_size;
+  attached_buffer = nullptr;
+  attached_size = 0;
+  return MPI_SUCCESS;
+}
+
+int PMPI_Pack_size(int incount, MPI_Datatype datatype, MPI_Comm comm, int* size){
+  *size = incount*datatype->size;
+  return MPI_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// collectives: each nonblocking variant copies the data it sends as it starts, and writes the data it receives within MPI_Wait
+
+int PMPI_Ibarrier(MPI_Comm comm, MPI_Request* request){
+  return collective(comm,{},nullptr,request);
+}
+
+int PMPI_Barrier(MPI_Comm comm){
+  return PMPI_Ibarrier(comm,nullptr);
+}
+
+int PMPI_Ibcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm, MPI_Request* request){
+  std::vector<std::vector<char>> data;
+  if (rank_of(comm) == root) data.push_back(pack(buffer,count,datatype));
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    if (rank != root) unpack(buffer,count,datatype,c.data[root][0]);
+  },request);
+}
+
+int PMPI_Bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm){
+  return PMPI_Ibcast(buffer,count,datatype,root,comm,nullptr);
+}
+
+int PMPI_Ireduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm,
+                 MPI_Request* request){
+  std::vector<std::vector<char>> data(1,copy((sendbuf == MPI_IN_PLACE) ? recvbuf : sendbuf,count,datatype));
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    if (rank == root) reduce_contributions(c,recvbuf,0,count,datatype,op,count);
+  },request);
+}
+
+int PMPI_Reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm){
+  return PMPI_Ireduce(sendbuf,recvbuf,count,datatype,op,root,comm,nullptr);
+}
+
+int PMPI_Iallreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm, MPI_Request* request){
+  std::vector<std::vector<char>> data(1,copy((sendbuf == MPI_IN_PLACE) ? recvbuf : sendbuf,count,datatype));
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    reduce_contributions(c,recvbuf,0,count,datatype,op,count);
+  },request);
+}
+
+int PMPI_Allreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm){
+  return PMPI_Iallreduce(sendbuf,recvbuf,count,datatype,op,comm,nullptr);
+}
+
+int PMPI_Ireduce_scatter(const void* sendbuf, void* recvbuf, const int recvcounts[], MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+                         MPI_Request* request){
+  std::vector<int> counts(recvcounts,recvcounts+comm->world_ranks.size());
+  int total = 0;
+  for (auto count : counts){ total += count; }
+  std::vector<std::vector<char>> data(1,copy((sendbuf == MPI_IN_PLACE) ? recvbuf : sendbuf,total,datatype));
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    int offset = 0;
+    for (int r=0; r<rank; r++){ offset += counts[r]; }
+    reduce_contributions(c,recvbuf,offset,counts[rank],datatype,op,total);
+  },request);
+}
+
+int PMPI_Reduce_scatter(const void* sendbuf, void* recvbuf, const int recvcounts[], MPI_Datatype datatype, MPI_Op op, MPI_Comm comm){
+  return PMPI_Ireduce_scatter(sendbuf,recvbuf,recvcounts,datatype,op,comm,nullptr);
+}
+
+int PMPI_Igatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],
+                  MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request* request){
+  int rank = rank_of(comm);
+  bool in_place = (rank == root) && (sendbuf == MPI_IN_PLACE);
+  std::vector<std::vector<char>> data;
+  if (!in_place) data.push_back(pack(sendbuf,sendcount,sendtype));
+  std::vector<int> counts,offsets;
+  if (rank == root){
+    counts.assign(recvcounts,recvcounts+comm->world_ranks.size());
+    offsets.assign(displs,displs+comm->world_ranks.size());
+  }
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    if (rank != root) return;
+    for (size_t r=0; r<c.data.size(); r++){
+      if (((int)r == root) && in_place) continue;
+      unpack((char*)recvbuf+offsets[r]*recvtype->extent,counts[r],recvtype,c.data[r][0]);
+    }
+  },request);
+}
+
+int PMPI_Igather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,
+                 MPI_Comm comm, MPI_Request* request){
+  int size = comm->world_ranks.size();
+  std::vector<int> counts(size,recvcount), displs(size);
+  for (int r=0; r<size; r++){ displs[r] = r*recvcount; }
+  return PMPI_Igatherv(sendbuf,sendcount,sendtype,recvbuf,&counts[0],&displs[0],recvtype,root,comm,request);
+}
+
+int PMPI_Gatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],
+                 MPI_Datatype recvtype, int root, MPI_Comm comm){
+  return PMPI_Igatherv(sendbuf,sendcount,sendtype,recvbuf,recvcounts,displs,recvtype,root,comm,nullptr);
+}
+
+int PMPI_Gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,
+                MPI_Comm comm){
+  return PMPI_Igather(sendbuf,sendcount,sendtype,recvbuf,recvcount,recvtype,root,comm,nullptr);
+}
+
+int PMPI_Iscatterv(const void* sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype, void* recvbuf, int recvcount,
+                   MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request* request){
+  int rank = rank_of(comm);
+  std::vector<std::vector<char>> data;
+  if (rank == root){
+    for (size_t r=0; r<comm->world_ranks.size(); r++){ data.push_back(pack((char const*)sendbuf+displs[r]*sendtype->extent,sendcounts[r],sendtype)); }
+  }
+  bool in_place = (rank == root) && (recvbuf == MPI_IN_PLACE);
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    if (!in_place) unpack(recvbuf,recvcount,recvtype,c.data[root][rank]);
+  },request);
+}
+
+int PMPI_Iscatter(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,
+                  MPI_Comm comm, MPI_Request* request){
+  int size = comm->world_ranks.size();
+  std::vector<int> counts(size,sendcount), displs(size);
+  for (int r=0; r<size; r++){ displs[r] = r*sendcount; }
+  return PMPI_Iscatterv(sendbuf,&counts[0],&displs[0],sendtype,recvbuf,recvcount,recvtype,root,comm,request);
+}
+
+int PMPI_Scatterv(const void* sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype, void* recvbuf, int recvcount,
+                  MPI_Datatype recvtype, int root, MPI_Comm comm){
+  return PMPI_Iscatterv(sendbuf,sendcounts,displs,sendtype,recvbuf,recvcount,recvtype,root,comm,nullptr);
+}
+
+int PMPI_Scatter(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,
+                 MPI_Comm comm){
+  return PMPI_Iscatter(sendbuf,sendcount,sendtype,recvbuf,recvcount,recvtype,root,comm,nullptr);
+}
+
+int PMPI_Iallgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],
+                     MPI_Datatype recvtype, MPI_Comm comm, MPI_Request* request){
+  int rank = rank_of(comm);
+  std::vector<int> counts(recvcounts,recvcounts+comm->world_ranks.size()), offsets(displs,displs+comm->world_ranks.size());
+  std::vector<std::vector<char>> data;
+  if (sendbuf == MPI_IN_PLACE) data.push_back(pack((char const*)recvbuf+offsets[rank]*recvtype->extent,counts[rank],recvtype));
+  else data.push_back(pack(sendbuf,sendcount,sendtype));
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    for (size_t r=0; r<c.data.size(); r++){ unpack((char*)recvbuf+offsets[r]*recvtype->extent,counts[r],recvtype,c.data[r][0]); }
+  },request);
+}
+
+int PMPI_Iallgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,
+                    MPI_Comm comm, MPI_Request* request){
+  int size = comm->world_ranks.size();
+  std::vector<int> counts(size,recvcount), displs(size);
+  for (int r=0; r<size; r++){ displs[r] = r*recvcount; }
+  return PMPI_Iallgatherv(sendbuf,sendcount,sendtype,recvbuf,&counts[0],&displs[0],recvtype,comm,request);
+}
+
+int PMPI_Allgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],
+                    MPI_Datatype recvtype, MPI_Comm comm){
+  return PMPI_Iallgatherv(sendbuf,sendcount,sendtype,recvbuf,recvcounts,displs,recvtype,comm,nullptr);
+}
+
+int PMPI_Allgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,
+                   MPI_Comm comm){
+  return PMPI_Iallgather(sendbuf,sendcount,sendtype,recvbuf,recvcount,recvtype,comm,nullptr);
+}
+
+int PMPI_Ialltoallv(const void* sendbuf, const int sendcounts[], const int sdispls[], MPI_Datatype sendtype, void* recvbuf,
+                    const int recvcounts[], const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm, MPI_Request* request){
+  int size = comm->world_ranks.size();
+  std::vector<std::vector<char>> data;
+  for (int r=0; r<size; r++){
+    if (sendbuf == MPI_IN_PLACE) data.push_back(pack((char const*)recvbuf+rdispls[r]*recvtype->extent,recvcounts[r],recvtype));
+    else data.push_back(pack((char const*)sendbuf+sdispls[r]*sendtype->extent,sendcounts[r],sendtype));
+  }
+  std::vector<int> counts(recvcounts,recvcounts+size), offsets(rdispls,rdispls+size);
+  return collective(comm,std::move(data),[=](critter_mock_collective& c, int rank){
+    for (int r=0; r<size; r++){ unpack((char*)recvbuf+offsets[r]*recvtype->extent,counts[r],recvtype,c.data[r][rank]); }
+  },request);
+}
+
+int PMPI_Ialltoall(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,
+                   MPI_Comm comm, MPI_Request* request){
+  int size = comm->world_ranks.size();
+  std::vector<int> sendcounts(size,sendcount), sdispls(size), recvcounts(size,recvcount), rdispls(size);
+  for (int r=0; r<size; r++){ sdispls[r] = r*sendcount; rdispls[r] = r*recvcount; }
+  return PMPI_Ialltoallv(sendbuf,&sendcounts[0],&sdispls[0],sendtype,recvbuf,&recvcounts[0],&rdispls[0],recvtype,comm,request);
+}
+
+int PMPI_Alltoallv(const void* sendbuf, const int sendcounts[], const int sdispls[], MPI_Datatype sendtype, void* recvbuf,
+                   const int recvcounts[], const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm){
+  return PMPI_Ialltoallv(sendbuf,sendcounts,sdispls,sendtype,recvbuf,recvcounts,rdispls,recvtype,comm,nullptr);
+}
+
+int PMPI_Alltoall(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,
+                  MPI_Comm comm){
+  return PMPI_Ialltoall(sendbuf,sendcount,sendtype,recvbuf,recvcount,recvtype,comm,nullptr);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// shared memory windows: all processes share an address space, so each window is a single allocation
+
+int PMPI_Win_allocate_shared(MPI_Aint size, int disp_unit, MPI_Info info, MPI_Comm comm, void* baseptr, MPI_Win* win){
+  std::vector<std::vector<char>> data(1,std::vector<char>(sizeof(MPI_Aint)+sizeof(int)));
+  std::memcpy(&data[0][0],&size,sizeof(MPI_Aint));
+  std::memcpy(&data[0][sizeof(MPI_Aint)],&disp_unit,sizeof(int));
+  return collective(comm,std::move(data),[comm,baseptr,win](critter_mock_collective& c, int rank){
+    if (!c.result){
+      critter_mock_win* w = new critter_mock_win();
+      w->comm = comm;
+      w->references = c.data.size();
+      MPI_Aint total = 0;
+      for (auto& d : c.data){
+        MPI_Aint segment_size; int segment_disp_unit;
+        std::memcpy(&segment_size,&d[0][0],sizeof(MPI_Aint));
+        std::memcpy(&segment_disp_unit,&d[0][sizeof(MPI_Aint)],sizeof(int));
+        w->offsets.push_back(total);
+        w->sizes.push_back(segment_size);
+        w->disp_units.push_back(segment_disp_unit);
+        total += (segment_size + sizeof(std::max_align_t) - 1)/sizeof(std::max_align_t)*sizeof(std::max_align_t);
+      }
+      w->memory.resize(total/sizeof(std::max_align_t)+1);
+      c.result = std::shared_ptr<void>(w,[](void*){});
+    }
+    critter_mock_win* w = (critter_mock_win*)c.result.get();
+    *win = w;
+    *(char**)baseptr = (char*)w->memory.data() + w->offsets[rank];
+  },nullptr);
+}
+
+int PMPI_Win_shared_query(MPI_Win win, int rank, MPI_Aint* size, int* disp_unit, void* baseptr){
+  *size = win->sizes[rank];
+  *disp_unit = win->disp_units[rank];
+  *(char**)baseptr = (char*)win->memory.data() + win->offsets[rank];
+  return MPI_SUCCESS;
+}
+
+int PMPI_Win_lock_all(int mode, MPI_Win win){
+  return MPI_SUCCESS;
+}
+
+int PMPI_Win_unlock_all(MPI_Win win){
+  return MPI_SUCCESS;
+}
+
+int PMPI_Win_sync(MPI_Win win){
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  return MPI_SUCCESS;
+}
+
+int PMPI_Win_free(MPI_Win* win){
+  critter_mock_win* w = *win;
+  *win = MPI_WIN_NULL;
+  return collective(w->comm,{},[w](critter_mock_collective& c, int rank){
+    if (--w->references == 0) delete w;
+  },nullptr);
+}
+
+// Each MPI_ routine is an alias of its PMPI_ counterpart
+#define CRITTER_MOCK_ALIAS(RETURN,NAME,PARAMETERS) RETURN MPI_##NAME PARAMETERS __attribute__((alias("PMPI_" #NAME)));
+extern "C" {
+CRITTER_MOCK_ROUTINES(CRITTER_MOCK_ALIAS)
+}
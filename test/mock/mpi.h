@@ -0,0 +1,239 @@
+#ifndef CRITTER__TEST__MOCK__MPI_H_
+#define CRITTER__TEST__MOCK__MPI_H_
+
+// In-process stand-in for the subset of MPI that critter (and the tests built on it) use. Each process is a thread launched by
+//   critter::mock::run (see mock.h), so critter is built against this header (with -Itest/mock) into lib/libcritter_mock.a, and each
+//   variable that holds the state of a process is thread_local (see CRITTER_RANK_LOCAL in src/util/util.h).
+//
+// Time is virtual: MPI_Wtime returns the clock of the calling process, which only advances by critter::mock::delay and by waiting on
+//   other processes. As on a cluster, clocks are not synchronized across nodes: MPI_Wtime adds an offset that differs by node, and
+//   MPI_WTIME_IS_GLOBAL is false unless all processes share a node. A receive completes no earlier than its matching send started, a
+//   synchronous send no earlier than its matching receive was posted, and each collective completes on all processes once the last
+//   of them has called it. Standard and buffered sends complete as soon as they start. Routines outside the subset below are not declared, unsupported uses of those within it abort,
+//   and so does a deadlock.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRITTER_RANK_LOCAL thread_local
+
+#define MPI_VERSION 3
+#define MPI_SUBVERSION 1
+
+typedef ptrdiff_t MPI_Aint;
+typedef long long MPI_Count;
+typedef int MPI_Info;
+typedef struct critter_mock_comm* MPI_Comm;
+typedef struct critter_mock_group* MPI_Group;
+typedef struct critter_mock_datatype* MPI_Datatype;
+typedef struct critter_mock_op* MPI_Op;
+typedef struct critter_mock_request* MPI_Request;
+typedef struct critter_mock_message* MPI_Message;
+typedef struct critter_mock_win* MPI_Win;
+
+typedef struct MPI_Status{
+  int MPI_SOURCE;
+  int MPI_TAG;
+  int MPI_ERROR;
+  MPI_Count bytes;// size of the received message
+} MPI_Status;
+
+typedef void MPI_User_function(void* invec, void* inoutvec, int* len, MPI_Datatype* datatype);
+typedef int MPI_Comm_copy_attr_function(MPI_Comm oldcomm, int keyval, void* extra_state, void* attribute_val_in, void* attribute_val_out, int* flag);
+typedef int MPI_Comm_delete_attr_function(MPI_Comm comm, int keyval, void* attribute_val, void* extra_state);
+typedef int MPI_Type_copy_attr_function(MPI_Datatype oldtype, int keyval, void* extra_state, void* attribute_val_in, void* attribute_val_out, int* flag);
+typedef int MPI_Type_delete_attr_function(MPI_Datatype datatype, int keyval, void* attribute_val, void* extra_state);
+
+extern "C" {
+extern struct critter_mock_comm critter_mock_comm_world;
+extern struct critter_mock_datatype critter_mock_char, critter_mock_byte, critter_mock_int, critter_mock_unsigned, critter_mock_long,
+                                    critter_mock_long_long, critter_mock_int64_t, critter_mock_uint64_t, critter_mock_float, critter_mock_double,
+                                    critter_mock_double_int;
+extern struct critter_mock_op critter_mock_sum, critter_mock_prod, critter_mock_max, critter_mock_min, critter_mock_bor, critter_mock_band,
+                              critter_mock_maxloc, critter_mock_minloc;
+}
+
+#define MPI_COMM_WORLD (&critter_mock_comm_world)
+#define MPI_COMM_NULL ((MPI_Comm)0)
+#define MPI_GROUP_NULL ((MPI_Group)0)
+#define MPI_REQUEST_NULL ((MPI_Request)0)
+#define MPI_MESSAGE_NULL ((MPI_Message)0)
+#define MPI_WIN_NULL ((MPI_Win)0)
+#define MPI_OP_NULL ((MPI_Op)0)
+#define MPI_DATATYPE_NULL ((MPI_Datatype)0)
+#define MPI_INFO_NULL 0
+
+#define MPI_CHAR (&critter_mock_char)
+#define MPI_BYTE (&critter_mock_byte)
+#define MPI_INT (&critter_mock_int)
+#define MPI_UNSIGNED (&critter_mock_unsigned)
+#define MPI_LONG (&critter_mock_long)
+#define MPI_LONG_LONG (&critter_mock_long_long)
+#define MPI_INT64_T (&critter_mock_int64_t)
+#define MPI_UINT64_T (&critter_mock_uint64_t)
+#define MPI_FLOAT (&critter_mock_float)
+#define MPI_DOUBLE (&critter_mock_double)
+#define MPI_DOUBLE_INT (&critter_mock_double_int)
+
+#define MPI_SUM (&critter_mock_sum)
+#define MPI_PROD (&critter_mock_prod)
+#define MPI_MAX (&critter_mock_max)
+#define MPI_MIN (&critter_mock_min)
+#define MPI_BOR (&critter_mock_bor)
+#define MPI_BAND (&critter_mock_band)
+#define MPI_MAXLOC (&critter_mock_maxloc)
+#define MPI_MINLOC (&critter_mock_minloc)
+
+#define MPI_SUCCESS 0
+#define MPI_ERR_OTHER 16
+#define MPI_ANY_SOURCE (-1)
+#define MPI_ANY_TAG (-1)
+#define MPI_PROC_NULL (-2)
+#define MPI_UNDEFINED (-32766)
+#define MPI_KEYVAL_INVALID (-1)
+#define MPI_WTIME_IS_GLOBAL (-2)
+#define MPI_IDENT 0
+#define MPI_CONGRUENT 1
+#define MPI_SIMILAR 2
+#define MPI_UNEQUAL 3
+#define MPI_THREAD_SINGLE 0
+#define MPI_THREAD_FUNNELED 1
+#define MPI_THREAD_SERIALIZED 2
+#define MPI_THREAD_MULTIPLE 3
+#define MPI_COMM_TYPE_SHARED 1
+#define MPI_MODE_NOCHECK 1024
+#define MPI_BSEND_OVERHEAD 96
+#define MPI_BOTTOM ((void*)0)
+#define MPI_IN_PLACE ((void*)1)
+#define MPI_STATUS_IGNORE ((MPI_Status*)0)
+#define MPI_STATUSES_IGNORE ((MPI_Status*)0)
+#define MPI_COMM_NULL_COPY_FN ((MPI_Comm_copy_attr_function*)0)
+#define MPI_COMM_NULL_DELETE_FN ((MPI_Comm_delete_attr_function*)0)
+#define MPI_TYPE_NULL_COPY_FN ((MPI_Type_copy_attr_function*)0)
+#define MPI_TYPE_NULL_DELETE_FN ((MPI_Type_delete_attr_function*)0)
+
+// Each routine is declared under both its MPI_ and PMPI_ name; test/mock/mpi.cxx defines the latter, and aliases the former to it
+#define CRITTER_MOCK_ROUTINES(X)\
+  X(int,Init,(int* argc, char*** argv))\
+  X(int,Init_thread,(int* argc, char*** argv, int required, int* provided))\
+  X(int,Initialized,(int* flag))\
+  X(int,Finalize,())\
+  X(int,Abort,(MPI_Comm comm, int errorcode))\
+  X(double,Wtime,())\
+  X(double,Wtick,())\
+  X(int,Comm_rank,(MPI_Comm comm, int* rank))\
+  X(int,Comm_size,(MPI_Comm comm, int* size))\
+  X(int,Comm_split,(MPI_Comm comm, int color, int key, MPI_Comm* newcomm))\
+  X(int,Comm_split_type,(MPI_Comm comm, int split_type, int key, MPI_Info info, MPI_Comm* newcomm))\
+  X(int,Comm_dup,(MPI_Comm comm, MPI_Comm* newcomm))\
+  X(int,Comm_free,(MPI_Comm* comm))\
+  X(int,Comm_compare,(MPI_Comm comm1, MPI_Comm comm2, int* result))\
+  X(int,Comm_group,(MPI_Comm comm, MPI_Group* group))\
+  X(int,Group_translate_ranks,(MPI_Group group1, int n, const int ranks1[], MPI_Group group2, int ranks2[]))\
+  X(int,Group_free,(MPI_Group* group))\
+  X(int,Comm_create_keyval,(MPI_Comm_copy_attr_function* copy_fn, MPI_Comm_delete_attr_function* delete_fn, int* keyval, void* extra_state))\
+  X(int,Comm_free_keyval,(int* keyval))\
+  X(int,Comm_set_attr,(MPI_Comm comm, int keyval, void* attribute_val))\
+  X(int,Comm_get_attr,(MPI_Comm comm, int keyval, void* attribute_val, int* flag))\
+  X(int,Comm_delete_attr,(MPI_Comm comm, int keyval))\
+  X(int,Type_create_keyval,(MPI_Type_copy_attr_function* copy_fn, MPI_Type_delete_attr_function* delete_fn, int* keyval, void* extra_state))\
+  X(int,Type_set_attr,(MPI_Datatype datatype, int keyval, void* attribute_val))\
+  X(int,Type_get_attr,(MPI_Datatype datatype, int keyval, void* attribute_val, int* flag))\
+  X(int,Type_contiguous,(int count, MPI_Datatype oldtype, MPI_Datatype* newtype))\
+  X(int,Type_create_struct,(int count, const int array_of_blocklengths[], const MPI_Aint array_of_displacements[],\
+                            const MPI_Datatype array_of_types[], MPI_Datatype* newtype))\
+  X(int,Type_commit,(MPI_Datatype* datatype))\
+  X(int,Type_free,(MPI_Datatype* datatype))\
+  X(int,Type_size,(MPI_Datatype datatype, int* size))\
+  X(int,Type_get_extent,(MPI_Datatype datatype, MPI_Aint* lb, MPI_Aint* extent))\
+  X(int,Get_address,(const void* location, MPI_Aint* address))\
+  X(int,Op_create,(MPI_User_function* user_fn, int commute, MPI_Op* op))\
+  X(int,Op_free,(MPI_Op* op))\
+  X(int,Reduce_local,(const void* inbuf, void* inoutbuf, int count, MPI_Datatype datatype, MPI_Op op))\
+  X(int,Send,(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm))\
+  X(int,Ssend,(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm))\
+  X(int,Bsend,(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm))\
+  X(int,Isend,(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request))\
+  X(int,Issend,(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request))\
+  X(int,Recv,(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status* status))\
+  X(int,Irecv,(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request* request))\
+  X(int,Sendrecv,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, int dest, int sendtag, void* recvbuf, int recvcount,\
+                  MPI_Datatype recvtype, int source, int recvtag, MPI_Comm comm, MPI_Status* status))\
+  X(int,Sendrecv_replace,(void* buf, int count, MPI_Datatype datatype, int dest, int sendtag, int source, int recvtag, MPI_Comm comm,\
+                          MPI_Status* status))\
+  X(int,Send_init,(const void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request* request))\
+  X(int,Recv_init,(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request* request))\
+  X(int,Start,(MPI_Request* request))\
+  X(int,Request_free,(MPI_Request* request))\
+  X(int,Wait,(MPI_Request* request, MPI_Status* status))\
+  X(int,Test,(MPI_Request* request, int* flag, MPI_Status* status))\
+  X(int,Waitall,(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]))\
+  X(int,Waitany,(int count, MPI_Request array_of_requests[], int* indx, MPI_Status* status))\
+  X(int,Waitsome,(int incount, MPI_Request array_of_requests[], int* outcount, int array_of_indices[], MPI_Status array_of_statuses[]))\
+  X(int,Testsome,(int incount, MPI_Request array_of_requests[], int* outcount, int array_of_indices[], MPI_Status array_of_statuses[]))\
+  X(int,Mprobe,(int source, int tag, MPI_Comm comm, MPI_Message* message, MPI_Status* status))\
+  X(int,Mrecv,(void* buf, int count, MPI_Datatype datatype, MPI_Message* message, MPI_Status* status))\
+  X(int,Get_count,(const MPI_Status* status, MPI_Datatype datatype, int* count))\
+  X(int,Get_elements_x,(const MPI_Status* status, MPI_Datatype datatype, MPI_Count* count))\
+  X(int,Status_set_elements_x,(MPI_Status* status, MPI_Datatype datatype, MPI_Count count))\
+  X(int,Buffer_attach,(void* buffer, int size))\
+  X(int,Buffer_detach,(void* buffer_addr, int* size))\
+  X(int,Pack_size,(int incount, MPI_Datatype datatype, MPI_Comm comm, int* size))\
+  X(int,Barrier,(MPI_Comm comm))\
+  X(int,Bcast,(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm))\
+  X(int,Reduce,(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm))\
+  X(int,Allreduce,(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm))\
+  X(int,Reduce_scatter,(const void* sendbuf, void* recvbuf, const int recvcounts[], MPI_Datatype datatype, MPI_Op op, MPI_Comm comm))\
+  X(int,Gather,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,\
+                MPI_Comm comm))\
+  X(int,Gatherv,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],\
+                 MPI_Datatype recvtype, int root, MPI_Comm comm))\
+  X(int,Scatter,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,\
+                 MPI_Comm comm))\
+  X(int,Scatterv,(const void* sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype, void* recvbuf, int recvcount,\
+                  MPI_Datatype recvtype, int root, MPI_Comm comm))\
+  X(int,Allgather,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,\
+                   MPI_Comm comm))\
+  X(int,Allgatherv,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],\
+                    MPI_Datatype recvtype, MPI_Comm comm))\
+  X(int,Alltoall,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,\
+                  MPI_Comm comm))\
+  X(int,Alltoallv,(const void* sendbuf, const int sendcounts[], const int sdispls[], MPI_Datatype sendtype, void* recvbuf,\
+                   const int recvcounts[], const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm))\
+  X(int,Ibarrier,(MPI_Comm comm, MPI_Request* request))\
+  X(int,Ibcast,(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm, MPI_Request* request))\
+  X(int,Ireduce,(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm,\
+                 MPI_Request* request))\
+  X(int,Iallreduce,(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm, MPI_Request* request))\
+  X(int,Ireduce_scatter,(const void* sendbuf, void* recvbuf, const int recvcounts[], MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,\
+                         MPI_Request* request))\
+  X(int,Igather,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,\
+                 MPI_Comm comm, MPI_Request* request))\
+  X(int,Igatherv,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],\
+                  MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request* request))\
+  X(int,Iscatter,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,\
+                  MPI_Comm comm, MPI_Request* request))\
+  X(int,Iscatterv,(const void* sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype, void* recvbuf, int recvcount,\
+                   MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Request* request))\
+  X(int,Iallgather,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,\
+                    MPI_Comm comm, MPI_Request* request))\
+  X(int,Iallgatherv,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, const int recvcounts[], const int displs[],\
+                     MPI_Datatype recvtype, MPI_Comm comm, MPI_Request* request))\
+  X(int,Ialltoall,(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype,\
+                   MPI_Comm comm, MPI_Request* request))\
+  X(int,Ialltoallv,(const void* sendbuf, const int sendcounts[], const int sdispls[], MPI_Datatype sendtype, void* recvbuf,\
+                    const int recvcounts[], const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm, MPI_Request* request))\
+  X(int,Win_allocate_shared,(MPI_Aint size, int disp_unit, MPI_Info info, MPI_Comm comm, void* baseptr, MPI_Win* win))\
+  X(int,Win_shared_query,(MPI_Win win, int rank, MPI_Aint* size, int* disp_unit, void* baseptr))\
+  X(int,Win_lock_all,(int mode, MPI_Win win))\
+  X(int,Win_unlock_all,(MPI_Win win))\
+  X(int,Win_sync,(MPI_Win win))\
+  X(int,Win_free,(MPI_Win* win))
+
+#define CRITTER_MOCK_DECLARE(RETURN,NAME,PARAMETERS) RETURN MPI_##NAME PARAMETERS; RETURN PMPI_##NAME PARAMETERS;
+extern "C" {
+CRITTER_MOCK_ROUTINES(CRITTER_MOCK_DECLARE)
+}
+#undef CRITTER_MOCK_DECLARE
+
+#endif /*CRITTER__TEST__MOCK__MPI_H_*/